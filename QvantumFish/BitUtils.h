@@ -0,0 +1,43 @@
+#ifndef BIT_UTILS_H
+#define BIT_UTILS_H
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/*
+
+    Bit helpers shared by the simulation classes, basis indices and Pauli strings are bit masks
+
+*/
+
+//parity of the set bits, 1 when the count is odd
+inline unsigned int bitParity(std::uint64_t value) {
+#if defined(_MSC_VER)
+    return static_cast<unsigned int>(__popcnt64(value) & 1);
+#elif defined(__GNUC__)
+    return static_cast<unsigned int>(__builtin_parityll(value));
+#else
+    value ^= value >> 32;
+    value ^= value >> 16;
+    value ^= value >> 8;
+    value ^= value >> 4;
+    value ^= value >> 2;
+    value ^= value >> 1;
+    return static_cast<unsigned int>(value & 1);
+#endif
+}
+
+//number of set bits
+inline int bitCount(std::uint64_t value) {
+    int count = 0;
+    while (value != 0) {
+        value &= value - 1;
+        ++count;
+    }
+    return count;
+}
+
+#endif // BIT_UTILS_H
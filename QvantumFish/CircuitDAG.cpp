@@ -0,0 +1,77 @@
+#include "CircuitDAG.h"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+/*
+
+    CONSTRUCTORS
+
+*/
+CircuitDAG::CircuitDAG(const QuantumCircuit& circuit) : numQubits(circuit.getNumQubits()) {
+    for (const GateOperation& operation : circuit.getOperations()) {
+        nodeQubits.push_back(operationQubits(operation));
+    }
+    build();
+}
+
+CircuitDAG::CircuitDAG(int qubitCount, const std::vector<std::vector<int>>& qubitsOfNodes)
+    : numQubits(qubitCount), nodeQubits(qubitsOfNodes) {
+    for (const std::vector<int>& qubits : nodeQubits) {
+        for (int qubit : qubits) {
+            if (qubit < 0 || qubit >= numQubits) {
+                throw std::out_of_range("DAG node acts on a qubit outside of the circuit");
+            }
+        }
+    }
+    build();
+}
+
+std::vector<int> CircuitDAG::operationQubits(const GateOperation& operation) {
+    if (operation.control >= 0) {
+        return { operation.target, operation.control };
+    }
+    return { operation.target };
+}
+
+/*
+
+    FUNCTION: build():
+                one pass over the nodes keeping the last node seen on every qubit, the edges come from those
+                and the layer of a node is one more than the deepest of them
+
+*/
+void CircuitDAG::build() {
+    const size_t count = nodeQubits.size();
+    predecessors.assign(count, {});
+    successors.assign(count, {});
+    nodeLayer.assign(count, 0);
+    layers.clear();
+
+    std::vector<long long> lastNode(numQubits, -1);
+    for (size_t node = 0; node < count; ++node) {
+        size_t layer = 0;
+        for (int qubit : nodeQubits[node]) {
+            long long previous = lastNode[qubit];
+            if (previous < 0) {
+                continue;
+            }
+            size_t predecessor = static_cast<size_t>(previous);
+            //two qubit nodes can share both qubits with the same predecessor
+            if (std::find(predecessors[node].begin(), predecessors[node].end(), predecessor) == predecessors[node].end()) {
+                predecessors[node].push_back(predecessor);
+                successors[predecessor].push_back(node);
+            }
+            layer = std::max(layer, nodeLayer[predecessor] + 1);
+        }
+        for (int qubit : nodeQubits[node]) {
+            lastNode[qubit] = static_cast<long long>(node);
+        }
+
+        nodeLayer[node] = layer;
+        if (layers.size() <= layer) {
+            layers.resize(layer + 1);
+        }
+        layers[layer].push_back(node);
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef CIRCUIT_DAG_H
+#define CIRCUIT_DAG_H
+
+#include <cstddef>
+#include <vector>
+#include "QuantumCircuit.h"
+
+
+/*
+
+    CircuitDAG class
+
+    dependency graph of a gate list, node k depends on the last earlier node that touched any of its qubits.
+    the topological layers are the ASAP schedule: a node sits one layer after the latest of its predecessors,
+    so the nodes of a layer act on disjoint qubits and can be applied in any order
+
+*/
+class CircuitDAG {
+private:
+    int numQubits;
+    std::vector<std::vector<int>> nodeQubits;
+    std::vector<std::vector<size_t>> predecessors;
+    std::vector<std::vector<size_t>> successors;
+    std::vector<size_t> nodeLayer;
+    std::vector<std::vector<size_t>> layers;
+
+    // Private helper method
+    void build();
+
+public:
+    // Constructors, from a circuit or from the qubits touched by every node of any ordered list
+    CircuitDAG(const QuantumCircuit& circuit);
+    CircuitDAG(int qubitCount, const std::vector<std::vector<int>>& qubitsOfNodes);
+
+    // Getters
+    int getNumQubits() const { return numQubits; }
+    size_t getNodeCount() const { return nodeQubits.size(); }
+    size_t getDepth() const { return layers.size(); }
+    const std::vector<int>& getQubits(size_t node) const { return nodeQubits[node]; }
+    const std::vector<size_t>& getPredecessors(size_t node) const { return predecessors[node]; }
+    const std::vector<size_t>& getSuccessors(size_t node) const { return successors[node]; }
+    size_t getLayer(size_t node) const { return nodeLayer[node]; }
+
+    //nodes of every layer in their original order
+    const std::vector<std::vector<size_t>>& getLayers() const { return layers; }
+
+    //qubits read or written by a gate
+    static std::vector<int> operationQubits(const GateOperation& operation);
+};
+
+#endif // CIRCUIT_DAG_H
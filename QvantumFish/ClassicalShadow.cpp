@@ -0,0 +1,255 @@
+#include "ClassicalShadow.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include <Eigen/Dense>
+#include "BitUtils.h"
+#include "ParallelUtils.h"
+#include "TrotterCircuit.h"
+
+/*
+
+    CONSTRUCTOR
+
+*/
+ClassicalShadow::ClassicalShadow(int qubitCount) : numQubits(qubitCount) {
+    if (qubitCount < 1 || qubitCount > 30) {
+        throw std::invalid_argument("ClassicalShadow supports between 1 and 30 qubits");
+    }
+}
+
+/*
+
+    FUNCTION: collect(state, settings, shotsPerSetting, seed):
+                every setting draws a basis for each qubit, rotates a copy of the state with one layer pass
+                and samples its shots from the cumulative distribution. settings use independent generators
+                seeded from (seed, setting), so the shadow does not depend on the number of workers
+
+*/
+void ClassicalShadow::collect(const QuantumRegister& state, size_t settings, size_t shotsPerSetting, std::uint64_t seed) {
+    if (state.getNumQubits() != numQubits) {
+        throw std::invalid_argument("Register size does not match the shadow");
+    }
+    if (shotsPerSetting < 1) {
+        throw std::invalid_argument("Every basis setting needs at least one shot");
+    }
+    if (seed == 0) {
+        std::random_device device;
+        seed = (static_cast<std::uint64_t>(device()) << 32) | device();
+    }
+
+    const size_t first = snapshots.size();
+    snapshots.resize(first + settings * shotsPerSetting);
+
+    parallelFor(0, settings, 1, [&](size_t begin, size_t end) {
+        QuantumRegister rotated(state);
+        std::vector<double> cumulative(state.getDimension());
+
+        for (size_t setting = begin; setting < end; ++setting) {
+            std::mt19937_64 generator(seed ^ (0x9E3779B97F4A7C15ULL * (setting + 1)));
+            std::uniform_int_distribution<int> basisDistribution(0, 2);
+            std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+            ShadowSnapshot snapshot{ 0, 0, 0 };
+            std::vector<int> targets;
+            std::vector<Eigen::Matrix2cd> gates;
+            for (int qubit = 0; qubit < numQubits; ++qubit) {
+                int basis = basisDistribution(generator);
+                if (basis == 0) {
+                    snapshot.xBasis |= static_cast<std::uint64_t>(1) << qubit;
+                    targets.push_back(qubit);
+                    gates.push_back(TrotterCircuit::basisChange('X'));
+                }
+                else if (basis == 1) {
+                    snapshot.yBasis |= static_cast<std::uint64_t>(1) << qubit;
+                    targets.push_back(qubit);
+                    gates.push_back(TrotterCircuit::basisChange('Y'));
+                }
+            }
+
+            rotated.getAmplitudes() = state.getAmplitudes();
+            if (!targets.empty()) {
+                rotated.applySingleQubitLayer(targets, gates);
+            }
+
+            const Eigen::VectorXcd& amplitudes = rotated.getAmplitudes();
+            double total = 0.0;
+            for (size_t i = 0; i < cumulative.size(); ++i) {
+                total += std::norm(amplitudes(static_cast<Eigen::Index>(i)));
+                cumulative[i] = total;
+            }
+
+            for (size_t shot = 0; shot < shotsPerSetting; ++shot) {
+                double draw = uniform(generator) * total;
+                size_t outcome = static_cast<size_t>(std::upper_bound(cumulative.begin(), cumulative.end(), draw) - cumulative.begin());
+                snapshot.outcomes = std::min(outcome, cumulative.size() - 1);
+                snapshots[first + setting * shotsPerSetting + shot] = snapshot;
+            }
+        }
+    });
+}
+
+void ClassicalShadow::addSnapshot(const ShadowSnapshot& snapshot) {
+    const std::uint64_t qubitMask = (static_cast<std::uint64_t>(1) << numQubits) - 1;
+    if ((snapshot.xBasis & snapshot.yBasis) != 0) {
+        throw std::invalid_argument("A qubit can be measured in one basis only");
+    }
+    if (((snapshot.xBasis | snapshot.yBasis | snapshot.outcomes) & ~qubitMask) != 0) {
+        throw std::out_of_range("Snapshot refers to qubits outside of the shadow");
+    }
+    snapshots.push_back(snapshot);
+}
+
+/*
+
+    FUNCTION: snapshotEstimate(snapshot, term):
+                3^w (-1)^(parity of the outcomes on the support) if every qubit of the term was measured
+                in its basis, zero otherwise. only mask operations, no state is touched
+
+*/
+double ClassicalShadow::snapshotEstimate(const ShadowSnapshot& snapshot, const PauliTerm& term) const {
+    const std::uint64_t qubitMask = (static_cast<std::uint64_t>(1) << numQubits) - 1;
+    const std::uint64_t termX = term.xMask & ~term.zMask;
+    const std::uint64_t termY = term.xMask & term.zMask;
+    const std::uint64_t termZ = term.zMask & ~term.xMask;
+    const std::uint64_t zBasis = qubitMask & ~(snapshot.xBasis | snapshot.yBasis);
+
+    if (((termX & ~snapshot.xBasis) | (termY & ~snapshot.yBasis) | (termZ & ~zBasis)) != 0) {
+        return 0.0;
+    }
+
+    const std::uint64_t support = term.xMask | term.zMask;
+    const double weight = std::pow(3.0, bitCount(support));
+    return bitParity(snapshot.outcomes & support) ? -term.coefficient * weight : term.coefficient * weight;
+}
+
+/*
+
+    FUNCTION: estimate(observable, groups):
+                a list of observables is spread over the workers, each one scans the snapshots once.
+                a PauliSum is summed snapshot by snapshot before the median of means
+
+*/
+double ClassicalShadow::estimate(const PauliTerm& observable, size_t groups) const {
+    return estimate(std::vector<PauliTerm>{ observable }, groups).front();
+}
+
+std::vector<double> ClassicalShadow::estimate(const std::vector<PauliTerm>& observables, size_t groups) const {
+    if (snapshots.empty()) {
+        throw std::logic_error("Classical shadow has no snapshots");
+    }
+
+    std::vector<double> results(observables.size());
+    parallelFor(0, observables.size(), 1, [&](size_t first, size_t last) {
+        std::vector<double> values(snapshots.size());
+        for (size_t k = first; k < last; ++k) {
+            for (size_t s = 0; s < snapshots.size(); ++s) {
+                values[s] = snapshotEstimate(snapshots[s], observables[k]);
+            }
+            results[k] = medianOfMeans(values, groups);
+        }
+    });
+    return results;
+}
+
+double ClassicalShadow::estimate(const PauliSum& observable, size_t groups) const {
+    if (observable.getNumQubits() != numQubits) {
+        throw std::invalid_argument("Observable size does not match the shadow");
+    }
+    if (snapshots.empty()) {
+        throw std::logic_error("Classical shadow has no snapshots");
+    }
+
+    std::vector<double> values(snapshots.size(), 0.0);
+    parallelFor(0, snapshots.size(), 256, [&](size_t first, size_t last) {
+        for (size_t s = first; s < last; ++s) {
+            for (const PauliTerm& term : observable.getTerms()) {
+                values[s] += snapshotEstimate(snapshots[s], term);
+            }
+        }
+    });
+    return medianOfMeans(values, groups);
+}
+
+/*
+
+    FUNCTION: fidelity(target, groups):
+                <phi| tensor_k (3 |s_k><s_k| - I) |phi> with |s_k> = U_k^dagger |b_k>, the single qubit
+                factors are applied to a copy of the target with one layer pass per snapshot
+
+*/
+double ClassicalShadow::fidelity(const Eigen::VectorXcd& target, size_t groups) const {
+    if (target.size() != (static_cast<Eigen::Index>(1) << numQubits)) {
+        throw std::invalid_argument("Target state size does not match the shadow");
+    }
+    if (snapshots.empty()) {
+        throw std::logic_error("Classical shadow has no snapshots");
+    }
+
+    std::vector<int> targets(numQubits);
+    std::iota(targets.begin(), targets.end(), 0);
+    std::vector<double> values(snapshots.size());
+
+    parallelFor(0, snapshots.size(), 1, [&](size_t first, size_t last) {
+        QuantumRegister factor(target);
+        std::vector<Eigen::Matrix2cd> gates(numQubits);
+
+        for (size_t s = first; s < last; ++s) {
+            for (int qubit = 0; qubit < numQubits; ++qubit) {
+                Eigen::Matrix2cd rotation = TrotterCircuit::basisChange(basisOf(snapshots[s], qubit));
+                Eigen::Vector2cd state = rotation.adjoint().col((snapshots[s].outcomes >> qubit) & 1);
+                gates[qubit] = 3.0 * state * state.adjoint() - Eigen::Matrix2cd::Identity();
+            }
+            factor.getAmplitudes() = target;
+            factor.applySingleQubitLayer(targets, gates);
+            values[s] = target.dot(factor.getAmplitudes()).real();
+        }
+    });
+    return medianOfMeans(values, groups);
+}
+
+/*
+
+    FUNCTION: medianOfMeans(values, groups):
+                the values are cut in groups of equal size (the remainder joins the last group),
+                the median of the group means is robust to the heavy tails of the 3^w estimators
+
+*/
+double ClassicalShadow::medianOfMeans(const std::vector<double>& values, size_t groups) {
+    if (values.empty()) {
+        throw std::invalid_argument("Median of means needs at least one value");
+    }
+    groups = std::max<size_t>(1, std::min(groups, values.size()));
+
+    const size_t groupSize = values.size() / groups;
+    std::vector<double> means(groups);
+    for (size_t g = 0; g < groups; ++g) {
+        const size_t begin = g * groupSize;
+        const size_t end = g + 1 == groups ? values.size() : begin + groupSize;
+        means[g] = std::accumulate(values.begin() + begin, values.begin() + end, 0.0) / static_cast<double>(end - begin);
+    }
+
+    const size_t middle = groups / 2;
+    std::nth_element(means.begin(), means.begin() + middle, means.end());
+    if (groups % 2 == 1) {
+        return means[middle];
+    }
+    double upper = means[middle];
+    double lower = *std::max_element(means.begin(), means.begin() + middle);
+    return (lower + upper) / 2.0;
+}
+
+char ClassicalShadow::basisOf(const ShadowSnapshot& snapshot, int qubit) {
+    if ((snapshot.xBasis >> qubit) & 1) {
+        return 'X';
+    }
+    if ((snapshot.yBasis >> qubit) & 1) {
+        return 'Y';
+    }
+    return 'Z';
+}
@@ -0,0 +1,71 @@
+#ifndef CLASSICAL_SHADOW_H
+#define CLASSICAL_SHADOW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <Eigen/Dense>
+#include "PauliSum.h"
+#include "QuantumRegister.h"
+
+//one randomized measurement, qubit k was measured in X, Y or Z (neither mask set) and bit k of outcomes is 1 for the -1 eigenvalue
+struct ShadowSnapshot {
+    std::uint64_t xBasis;
+    std::uint64_t yBasis;
+    std::uint64_t outcomes;
+};
+
+
+/*
+
+    ClassicalShadow class
+
+    classical shadow of a state from random single qubit Pauli measurements. a snapshot inverts the
+    measurement channel qubit by qubit
+
+                    rho_hat = tensor_k (3 U_k^dagger |b_k><b_k| U_k - I)
+
+    so a Pauli string P of weight w has the estimator 3^w (-1)^(outcomes on P) when the snapshot measured every
+    qubit of P in the basis of P, and 0 otherwise. every snapshot is three 64 bit masks, estimates of many
+    observables are computed with median of means over the same snapshots
+
+*/
+class ClassicalShadow {
+private:
+    int numQubits;
+    std::vector<ShadowSnapshot> snapshots;
+
+    // Private helper methods
+    double snapshotEstimate(const ShadowSnapshot& snapshot, const PauliTerm& term) const;
+
+public:
+    // default number of groups of the median of means estimator
+    static constexpr size_t DEFAULT_GROUPS = 10;
+
+    // Constructor, empty shadow
+    ClassicalShadow(int qubitCount);
+
+    // Getters
+    int getNumQubits() const { return numQubits; }
+    size_t getSnapshotCount() const { return snapshots.size(); }
+    const std::vector<ShadowSnapshot>& getSnapshots() const { return snapshots; }
+
+    //shots of a random basis setting, settings are drawn and sampled in parallel. a seed of 0 draws a random seed
+    void collect(const QuantumRegister& state, size_t settings, size_t shotsPerSetting = 1, std::uint64_t seed = 0);
+    void addSnapshot(const ShadowSnapshot& snapshot);
+    void clear() { snapshots.clear(); }
+
+    // Median of means estimates
+    double estimate(const PauliTerm& observable, size_t groups = DEFAULT_GROUPS) const;
+    std::vector<double> estimate(const std::vector<PauliTerm>& observables, size_t groups = DEFAULT_GROUPS) const;
+    double estimate(const PauliSum& observable, size_t groups = DEFAULT_GROUPS) const;
+
+    //<phi| rho |phi> for a pure target state, costs one 2^N sweep per snapshot
+    double fidelity(const Eigen::VectorXcd& target, size_t groups = DEFAULT_GROUPS) const;
+
+    // Helpers
+    static double medianOfMeans(const std::vector<double>& values, size_t groups);
+    static char basisOf(const ShadowSnapshot& snapshot, int qubit);
+};
+
+#endif // CLASSICAL_SHADOW_H
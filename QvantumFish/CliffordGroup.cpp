@@ -0,0 +1,191 @@
+#include "CliffordGroup.h"
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <deque>
+#include <stdexcept>
+#include <vector>
+#include <Eigen/Dense>
+#include "HashUtils.h"
+#include "QuantumRegister.h"
+
+/*
+
+    CONSTRUCTOR
+
+    breadth first search from the identity, each new element is a generator applied after a known one so its
+    decomposition is the one of its parent plus the generator. the group closes at 24 and 11520 elements
+
+*/
+CliffordGroup::CliffordGroup(int qubitCount) : numQubits(qubitCount) {
+    if (qubitCount != 1 && qubitCount != 2) {
+        throw std::invalid_argument("Clifford tables are available for one and two qubits");
+    }
+
+    std::vector<GateOperation> generators;
+    for (int qubit = 0; qubit < qubitCount; ++qubit) {
+        generators.push_back({ GateType::Hadamard, qubit, -1, 0.0, -1 });
+        generators.push_back({ GateType::S, qubit, -1, 0.0, -1 });
+    }
+    if (qubitCount == 2) {
+        generators.push_back({ GateType::CNOT, 1, 0, 0.0, -1 });
+    }
+    std::vector<Eigen::MatrixXcd> generatorMatrices;
+    for (const GateOperation& generator : generators) {
+        generatorMatrices.push_back(operationMatrix(generator, qubitCount));
+    }
+
+    const Eigen::Index dimension = static_cast<Eigen::Index>(1) << qubitCount;
+    auto insert = [&](const Eigen::MatrixXcd& element, const std::vector<GateOperation>& gates) {
+        Eigen::MatrixXcd canonical = canonicalForm(element);
+        std::uint64_t hash = canonicalHash(canonical);
+        size_t existing = 0;
+        if (findCanonical(canonical, hash, existing)) {
+            return false;
+        }
+        lookup[hash].push_back(matrices.size());
+        matrices.push_back(canonical);
+        decompositions.push_back(gates);
+        return true;
+    };
+
+    insert(Eigen::MatrixXcd::Identity(dimension, dimension), {});
+    for (size_t current = 0; current < matrices.size(); ++current) {
+        for (size_t g = 0; g < generators.size(); ++g) {
+            std::vector<GateOperation> gates = decompositions[current];
+            gates.push_back(generators[g]);
+            insert(generatorMatrices[g] * matrices[current], gates);
+        }
+    }
+
+    inverses.resize(matrices.size());
+    for (size_t element = 0; element < matrices.size(); ++element) {
+        inverses[element] = indexOf(matrices[element].adjoint());
+    }
+
+    if (qubitCount == 1) {
+        compositionTable.resize(matrices.size() * matrices.size());
+        for (size_t first = 0; first < matrices.size(); ++first) {
+            for (size_t second = 0; second < matrices.size(); ++second) {
+                compositionTable[first * matrices.size() + second] = indexOf(matrices[second] * matrices[first]);
+            }
+        }
+    }
+}
+
+const CliffordGroup& CliffordGroup::singleQubit() {
+    static const CliffordGroup group(1);
+    return group;
+}
+
+const CliffordGroup& CliffordGroup::twoQubit() {
+    static const CliffordGroup group(2);
+    return group;
+}
+
+const CliffordGroup& CliffordGroup::forQubits(int qubitCount) {
+    if (qubitCount == 1) {
+        return singleQubit();
+    }
+    if (qubitCount == 2) {
+        return twoQubit();
+    }
+    throw std::invalid_argument("Clifford tables are available for one and two qubits");
+}
+
+/*
+
+    FUNCTION: canonicalForm(matrix) / canonicalHash(canonical):
+                the matrix is multiplied by the inverse phase of its first entry that is clearly non zero
+                (Clifford entries are 0 or at least 1/2 in modulus), the hash reads the entries on a 1e-6 grid
+
+*/
+Eigen::MatrixXcd CliffordGroup::canonicalForm(const Eigen::MatrixXcd& matrix) {
+    const std::complex<double>* data = matrix.data();
+    for (Eigen::Index k = 0; k < matrix.size(); ++k) {
+        if (std::abs(data[k]) > 0.1) {
+            return matrix * std::polar(1.0, -std::arg(data[k]));
+        }
+    }
+    throw std::invalid_argument("Null matrix is not a Clifford");
+}
+
+std::uint64_t CliffordGroup::canonicalHash(const Eigen::MatrixXcd& canonical) {
+    std::uint64_t hash = FNV_OFFSET_BASIS;
+    const std::complex<double>* data = canonical.data();
+    for (Eigen::Index k = 0; k < canonical.size(); ++k) {
+        for (double part : { data[k].real(), data[k].imag() }) {
+            std::int64_t quantized = static_cast<std::int64_t>(std::llround(part * 1e6));
+            hashWord(hash, static_cast<std::uint64_t>(quantized));
+        }
+    }
+    return hash;
+}
+
+bool CliffordGroup::findCanonical(const Eigen::MatrixXcd& canonical, std::uint64_t hash, size_t& index) const {
+    auto found = lookup.find(hash);
+    if (found == lookup.end()) {
+        return false;
+    }
+    for (size_t candidate : found->second) {
+        if ((matrices[candidate] - canonical).cwiseAbs().maxCoeff() < 1e-6) {
+            index = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+
+    FUNCTION: compose(first, second) / indexOf(matrix):
+                one table read for one qubit, a product and a hash lookup for two
+
+*/
+size_t CliffordGroup::compose(size_t first, size_t second) const {
+    if (!compositionTable.empty()) {
+        return compositionTable[first * matrices.size() + second];
+    }
+    return indexOf(matrices[second] * matrices[first]);
+}
+
+size_t CliffordGroup::indexOf(const Eigen::MatrixXcd& matrix) const {
+    const Eigen::Index dimension = static_cast<Eigen::Index>(1) << numQubits;
+    if (matrix.rows() != dimension || matrix.cols() != dimension) {
+        throw std::invalid_argument("Matrix size does not match the Clifford group");
+    }
+
+    Eigen::MatrixXcd canonical = canonicalForm(matrix);
+    size_t index = 0;
+    if (!findCanonical(canonical, canonicalHash(canonical), index)) {
+        throw std::invalid_argument("Matrix is not a Clifford element");
+    }
+    return index;
+}
+
+/*
+
+    FUNCTION: operationMatrix(operation, qubitCount):
+                column j is the gate applied to the basis state |j>, with the conventions of QuantumRegister
+
+*/
+Eigen::MatrixXcd CliffordGroup::operationMatrix(const GateOperation& operation, int qubitCount) {
+    if (qubitCount < 1 || qubitCount > 2) {
+        throw std::invalid_argument("Operation matrices are built for one and two qubits");
+    }
+    if (operation.parameterIndex >= 0) {
+        throw std::invalid_argument("Operation matrix needs a constant angle");
+    }
+
+    const Eigen::Index dimension = static_cast<Eigen::Index>(1) << qubitCount;
+    Eigen::MatrixXcd result(dimension, dimension);
+    for (Eigen::Index column = 0; column < dimension; ++column) {
+        Eigen::VectorXcd basisState = Eigen::VectorXcd::Zero(dimension);
+        basisState(column) = 1.0;
+        QuantumRegister quantumRegister(basisState);
+
+        quantumRegister.applyGate(operation);
+        result.col(column) = quantumRegister.getAmplitudes();
+    }
+    return result;
+}
@@ -0,0 +1,65 @@
+#ifndef CLIFFORD_GROUP_H
+#define CLIFFORD_GROUP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <Eigen/Dense>
+#include "QuantumCircuit.h"
+
+
+/*
+
+    CliffordGroup class
+
+    the Clifford group of one qubit (24 elements) or two qubits (11520 elements) modulo the global phase,
+    enumerated once by a breadth first search over products of the generators H, S and CNOT. every element
+    keeps its matrix and its shortest gate decomposition, elements are found back from a matrix through a
+    hash of the matrix quantized after removing its phase. the one qubit group also has a full composition
+    table, the two qubit one composes by a 4x4 product and a lookup. the groups are built on first use and
+    shared, they are never modified afterwards
+
+*/
+class CliffordGroup {
+private:
+    int numQubits;
+    std::vector<Eigen::MatrixXcd> matrices;
+    std::vector<std::vector<GateOperation>> decompositions;
+    std::vector<size_t> inverses;
+    std::vector<size_t> compositionTable;      // only for one qubit, entry first * size + second
+    std::unordered_map<std::uint64_t, std::vector<size_t>> lookup;
+
+    // Constructor, use singleQubit() and twoQubit()
+    CliffordGroup(int qubitCount);
+
+    // Private helper methods
+    static Eigen::MatrixXcd canonicalForm(const Eigen::MatrixXcd& matrix);
+    static std::uint64_t canonicalHash(const Eigen::MatrixXcd& canonical);
+    bool findCanonical(const Eigen::MatrixXcd& canonical, std::uint64_t hash, size_t& index) const;
+
+public:
+    // Shared groups
+    static const CliffordGroup& singleQubit();
+    static const CliffordGroup& twoQubit();
+    static const CliffordGroup& forQubits(int qubitCount);
+
+    // Getters
+    int getNumQubits() const { return numQubits; }
+    size_t size() const { return matrices.size(); }
+    size_t identity() const { return 0; }
+    const Eigen::MatrixXcd& matrix(size_t element) const { return matrices[element]; }
+    const std::vector<GateOperation>& decomposition(size_t element) const { return decompositions[element]; }
+    size_t inverse(size_t element) const { return inverses[element]; }
+
+    //element of the product that applies first and then second (matrix second * first)
+    size_t compose(size_t first, size_t second) const;
+
+    //element equal to the matrix up to a global phase, throws if the matrix is not a Clifford
+    size_t indexOf(const Eigen::MatrixXcd& matrix) const;
+
+    //matrix of a gate on a register of qubitCount qubits (at most two)
+    static Eigen::MatrixXcd operationMatrix(const GateOperation& operation, int qubitCount);
+};
+
+#endif // CLIFFORD_GROUP_H
@@ -0,0 +1,426 @@
+#define _USE_MATH_DEFINES
+
+#include "CompiledCircuit.h"
+#include "CircuitDAG.h"
+#include "GateLibrary.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include <Eigen/Dense>
+
+/*
+
+    CONSTRUCTOR
+
+    fusion walks the gates once keeping for every qubit the index of the step still open on it,
+    a single qubit gate joins the open step of its qubit, a two qubit gate closes the steps of
+    both of its qubits, gates on other qubits in between commute with the open step
+
+*/
+CompiledCircuit::CompiledCircuit(const QuantumCircuit& circuit)
+    : numQubits(circuit.getNumQubits()),
+    numParameters(circuit.getNumParameters()),
+    sourceGateCount(circuit.getGateCount()) {
+
+    std::vector<int> openStep(numQubits, -1);
+    const std::vector<GateOperation>& operations = circuit.getOperations();
+
+    for (size_t position = 0; position < operations.size(); ++position) {
+        const GateOperation& operation = operations[position];
+        if (operation.type == GateType::Identity) {
+            continue;
+        }
+
+        QFTMatch match = matchQFT(operations, position, numQubits);
+        if (match.length > 0) {
+            for (int qubit = match.firstQubit; qubit < match.firstQubit + match.count; ++qubit) {
+                openStep[qubit] = -1;
+            }
+            appendQFT(match);
+            position += match.length - 1;
+            continue;
+        }
+
+        if (!QuantumCircuit::isTwoQubit(operation.type)) {
+            int& open = openStep[operation.target];
+            if (open < 0) {
+                steps.push_back({ StepKind::SingleQubit, operation.target, -1, {} });
+                open = static_cast<int>(steps.size()) - 1;
+            }
+            appendFactor(steps[open], operation);
+            continue;
+        }
+
+        openStep[operation.target] = -1;
+        openStep[operation.control] = -1;
+
+        if (operation.type == GateType::Swap) {
+            steps.push_back({ StepKind::Swap, operation.target, operation.control, {} });
+        }
+        else {
+            steps.push_back({ StepKind::Controlled, operation.target, operation.control, {} });
+            appendFactor(steps.back(), operation);
+        }
+    }
+
+    scheduleLayers();
+}
+
+/*
+
+    FUNCTION: appendFactor(step, operation):
+                add a gate to a step, consecutive constant gates collapse into a single matrix.
+                a product of diagonal gates stays diagonal, which the table of GateLibrary tells without looking at it
+
+*/
+void CompiledCircuit::appendFactor(CompiledStep& step, const GateOperation& operation) {
+    step.diagonal = step.diagonal && gateTraits(operation.type).diagonal;
+    if (operation.parameterIndex >= 0) {
+        step.factors.push_back({ Eigen::Matrix2cd::Identity(), operation.type, operation.angle, operation.parameterIndex });
+        return;
+    }
+
+    Eigen::Matrix2cd gate = QuantumCircuit::gateMatrix(operation.type, operation.angle);
+    if (!step.factors.empty() && step.factors.back().parameterIndex < 0) {
+        step.factors.back().matrix = gate * step.factors.back().matrix;
+    }
+    else {
+        step.factors.push_back({ gate, operation.type, 1.0, -1 });
+    }
+}
+
+/*
+
+    FUNCTION: matchQFT(operations, position, qubitCount):
+                a QFT block can start with
+                    - H(t) followed by CP(pi/2) on (t, t-1)     forward transform, t is the top qubit of the block
+                    - H(t) followed by CP(-pi/2) on (t+1, t)    inverse transform without swaps, t is the bottom qubit
+                    - a run of swaps                            inverse transform with swaps, the outermost swap (a, b)
+                                                                of the run gives the block [a, b]
+                only candidates passing this cheap check are compared gate by gate with the expected block,
+                the largest block that matches wins
+
+*/
+static bool sameOperation(const GateOperation& actual, const GateOperation& expected) {
+    if (actual.type != expected.type || actual.parameterIndex >= 0) {
+        return false;
+    }
+    bool sameQubits = actual.target == expected.target && actual.control == expected.control;
+    //controlled phases and swaps are symmetric in their two qubits
+    bool swappedQubits = actual.target == expected.control && actual.control == expected.target;
+    if (!sameQubits && !(swappedQubits && (actual.type == GateType::ControlledPhase || actual.type == GateType::Swap))) {
+        return false;
+    }
+    return std::abs(actual.angle - expected.angle) < 1e-9;
+}
+
+static bool blockMatches(const std::vector<GateOperation>& operations, size_t position, const std::vector<GateOperation>& block) {
+    if (position + block.size() > operations.size()) {
+        return false;
+    }
+    for (size_t k = 0; k < block.size(); ++k) {
+        if (!sameOperation(operations[position + k], block[k])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QFTMatch CompiledCircuit::matchQFT(const std::vector<GateOperation>& operations, size_t position, int qubitCount) {
+    QFTMatch none{ 0, 0, false, false, 0 };
+    if (position + 1 >= operations.size()) {
+        return none;
+    }
+
+    const GateOperation& head = operations[position];
+    const GateOperation& next = operations[position + 1];
+
+    auto tryBlock = [&](int firstQubit, int count, bool inverse, bool withSwaps) {
+        std::vector<GateOperation> block = QuantumCircuit::qftOperations(firstQubit, count, inverse, withSwaps);
+        if (blockMatches(operations, position, block)) {
+            return QFTMatch{ firstQubit, count, inverse, withSwaps, block.size() };
+        }
+        return none;
+    };
+
+    if (head.type == GateType::Hadamard && head.parameterIndex < 0) {
+        const int t = head.target;
+
+        if (t >= 1 && sameOperation(next, { GateType::ControlledPhase, t, t - 1, M_PI / 2.0, -1 })) {
+            for (int count = t + 1; count >= 2; --count) {
+                for (bool withSwaps : { true, false }) {
+                    QFTMatch match = tryBlock(t - count + 1, count, false, withSwaps);
+                    if (match.length > 0) {
+                        return match;
+                    }
+                }
+            }
+        }
+
+        if (t + 1 < qubitCount && sameOperation(next, { GateType::ControlledPhase, t + 1, t, -M_PI / 2.0, -1 })) {
+            for (int count = qubitCount - t; count >= 2; --count) {
+                QFTMatch match = tryBlock(t, count, true, false);
+                if (match.length > 0) {
+                    return match;
+                }
+            }
+        }
+    }
+
+    //the inverse block opens with its swaps from the innermost pair outwards, the k-th swap of the leading
+    //run spans the whole block when the block has k swaps, so the widest candidate is tried first
+    if (head.type == GateType::Swap) {
+        size_t runLength = 0;
+        while (position + runLength < operations.size() && runLength < static_cast<size_t>(qubitCount / 2)
+            && operations[position + runLength].type == GateType::Swap) {
+            ++runLength;
+        }
+        for (size_t k = runLength; k-- > 0;) {
+            const GateOperation& outer = operations[position + k];
+            const int firstQubit = std::min(outer.target, outer.control);
+            const int count = std::abs(outer.target - outer.control) + 1;
+            if (count / 2 != static_cast<int>(k) + 1) {
+                continue;
+            }
+            QFTMatch match = tryBlock(firstQubit, count, true, true);
+            if (match.length > 0) {
+                return match;
+            }
+        }
+    }
+
+    return none;
+}
+
+/*
+
+    FUNCTION: appendQFT(match):
+                without its swaps the textbook block equals the QFT preceded (inverse) or followed (forward)
+                by the reversal of the qubit order, so the missing swaps are applied as separate steps
+
+*/
+void CompiledCircuit::appendQFT(const QFTMatch& match) {
+    std::vector<CompiledStep> reversal;
+    if (!match.withSwaps) {
+        for (int i = 0; i < match.count / 2; ++i) {
+            reversal.push_back({ StepKind::Swap, match.firstQubit + i, match.firstQubit + match.count - 1 - i, {} });
+        }
+    }
+
+    if (match.inverse) {
+        steps.insert(steps.end(), reversal.begin(), reversal.end());
+    }
+
+    CompiledStep step{ StepKind::QFT, match.firstQubit, -1, {} };
+    step.span = match.count;
+    step.inverse = match.inverse;
+    steps.push_back(step);
+
+    if (!match.inverse) {
+        steps.insert(steps.end(), reversal.begin(), reversal.end());
+    }
+}
+
+/*
+
+    FUNCTION: scheduleLayers():
+                the fused steps are reordered by the layers of their DAG, a layer only holds steps on disjoint
+                qubits so its single qubit steps become one Layer step applied in a single pass, brickwork
+                circuits then cost one sweep per layer of single qubit gates instead of one per gate
+
+*/
+void CompiledCircuit::scheduleLayers() {
+    std::vector<std::vector<int>> stepQubits;
+    stepQubits.reserve(steps.size());
+    for (const CompiledStep& step : steps) {
+        switch (step.kind) {
+        case StepKind::SingleQubit:
+            stepQubits.push_back({ step.target });
+            break;
+        case StepKind::QFT: {
+            std::vector<int> block;
+            for (int qubit = step.target; qubit < step.target + step.span; ++qubit) {
+                block.push_back(qubit);
+            }
+            stepQubits.push_back(block);
+            break;
+        }
+        default:
+            stepQubits.push_back({ step.target, step.control });
+            break;
+        }
+    }
+
+    CircuitDAG dag(numQubits, stepQubits);
+    std::vector<CompiledStep> scheduled;
+    scheduled.reserve(steps.size());
+
+    for (const std::vector<size_t>& layer : dag.getLayers()) {
+        CompiledStep layerStep{ StepKind::Layer, -1, -1, {} };
+        for (size_t node : layer) {
+            if (steps[node].kind == StepKind::SingleQubit) {
+                layerStep.members.push_back(steps[node]);
+            }
+            else {
+                scheduled.push_back(steps[node]);
+            }
+        }
+
+        if (layerStep.members.size() == 1) {
+            scheduled.push_back(layerStep.members.front());
+        }
+        else if (layerStep.members.size() > 1) {
+            scheduled.push_back(layerStep);
+        }
+    }
+    steps = scheduled;
+}
+
+/*
+
+    FUNCTION: resolveStepMatrix(step, parameters):
+                multiply the factors of a step (later factors on the left) with the parameters bound
+
+*/
+Eigen::Matrix2cd CompiledCircuit::resolveStepMatrix(const CompiledStep& step, const std::vector<double>& parameters) {
+    Eigen::Matrix2cd result = Eigen::Matrix2cd::Identity();
+    for (const FusedFactor& factor : step.factors) {
+        if (factor.parameterIndex < 0) {
+            result = factor.matrix * result;
+        }
+        else {
+            if (factor.parameterIndex >= static_cast<int>(parameters.size())) {
+                throw std::out_of_range("Missing value for circuit parameter");
+            }
+            result = QuantumCircuit::gateMatrix(factor.type, factor.scale * parameters[factor.parameterIndex]) * result;
+        }
+    }
+    return result;
+}
+
+/*
+
+    FUNCTION: execute(quantumRegister, parameters) / run(parameters):
+                apply every step to the register, run starts from a fresh |0...0> register
+
+*/
+void CompiledCircuit::execute(QuantumRegister& quantumRegister, const std::vector<double>& parameters) const {
+    if (quantumRegister.getNumQubits() != numQubits) {
+        throw std::invalid_argument("Register size does not match the compiled circuit");
+    }
+    if (static_cast<int>(parameters.size()) < numParameters) {
+        throw std::invalid_argument("Not enough parameters bound for the compiled circuit");
+    }
+
+    for (const CompiledStep& step : steps) {
+        switch (step.kind) {
+        case StepKind::SingleQubit:
+        case StepKind::Controlled: {
+            const Eigen::Matrix2cd gate = resolveStepMatrix(step, parameters);
+            if (step.diagonal) {
+                quantumRegister.applyDiagonalGate(step.target, gate(0, 0), gate(1, 1), step.control);
+            }
+            else if (step.kind == StepKind::SingleQubit) {
+                quantumRegister.applySingleQubitGate(step.target, gate);
+            }
+            else {
+                quantumRegister.applyControlledGate(step.control, step.target, gate);
+            }
+            break;
+        }
+        case StepKind::Swap:
+            quantumRegister.applySwap(step.target, step.control);
+            break;
+        case StepKind::QFT:
+            quantumRegister.applyQFT(step.target, step.span, step.inverse);
+            break;
+        case StepKind::Layer: {
+            std::vector<int> targets;
+            std::vector<Eigen::Matrix2cd> gates;
+            for (const CompiledStep& member : step.members) {
+                targets.push_back(member.target);
+                gates.push_back(resolveStepMatrix(member, parameters));
+            }
+            quantumRegister.applySingleQubitLayer(targets, gates);
+            break;
+        }
+        }
+    }
+}
+
+QuantumRegister CompiledCircuit::run(const std::vector<double>& parameters) const {
+    QuantumRegister quantumRegister(numQubits);
+    execute(quantumRegister, parameters);
+    return quantumRegister;
+}
+
+/*
+
+    FUNCTION: executeBatch(batch, parameters):
+                every step becomes one dense gate on the whole batch. the single qubit steps of a Layer are
+                grouped by BATCH_LAYER_QUBITS and each group is their Kronecker product, so a layer costs one
+                8x8 GEMM pass per three qubits instead of one pass per qubit. QFT blocks too large for a dense
+                gate fall back to the FFT of the register, one state at a time
+
+*/
+void CompiledCircuit::executeBatch(RegisterBatch& batch, const std::vector<double>& parameters) const {
+    if (batch.getNumQubits() != numQubits) {
+        throw std::invalid_argument("Batch size does not match the compiled circuit");
+    }
+    if (static_cast<int>(parameters.size()) < numParameters) {
+        throw std::invalid_argument("Not enough parameters bound for the compiled circuit");
+    }
+
+    for (const CompiledStep& step : steps) {
+        switch (step.kind) {
+        case StepKind::SingleQubit:
+            batch.applyGate({ step.target }, resolveStepMatrix(step, parameters));
+            break;
+        case StepKind::Controlled:
+            batch.applyControlledGate(step.control, step.target, resolveStepMatrix(step, parameters));
+            break;
+        case StepKind::Swap:
+            batch.applySwap(step.target, step.control);
+            break;
+        case StepKind::QFT: {
+            if (step.span <= RegisterBatch::MAX_GATE_QUBITS) {
+                std::vector<int> block;
+                for (int qubit = step.target; qubit < step.target + step.span; ++qubit) {
+                    block.push_back(qubit);
+                }
+                batch.applyGate(block, RegisterBatch::fourierMatrix(step.span, step.inverse));
+                break;
+            }
+            RegisterBatch::BatchMatrix& amplitudes = batch.getAmplitudes();
+            for (Eigen::Index column = 0; column < batch.getBatchSize(); ++column) {
+                QuantumRegister single(Eigen::VectorXcd(amplitudes.col(column)));
+                single.applyQFT(step.target, step.span, step.inverse);
+                amplitudes.col(column) = single.getAmplitudes();
+            }
+            break;
+        }
+        case StepKind::Layer: {
+            std::vector<const CompiledStep*> members;
+            for (const CompiledStep& member : step.members) {
+                members.push_back(&member);
+            }
+            std::sort(members.begin(), members.end(), [](const CompiledStep* a, const CompiledStep* b) {
+                return a->target < b->target;
+            });
+
+            for (size_t first = 0; first < members.size(); first += BATCH_LAYER_QUBITS) {
+                const size_t last = std::min(members.size(), first + BATCH_LAYER_QUBITS);
+                std::vector<int> targets;
+                std::vector<Eigen::Matrix2cd> gates;
+                for (size_t k = first; k < last; ++k) {
+                    targets.push_back(members[k]->target);
+                    gates.push_back(resolveStepMatrix(*members[k], parameters));
+                }
+                batch.applyGate(targets, RegisterBatch::kroneckerProduct(gates));
+            }
+            break;
+        }
+        }
+    }
+}
@@ -0,0 +1,100 @@
+#ifndef COMPILED_CIRCUIT_H
+#define COMPILED_CIRCUIT_H
+
+#include <vector>
+#include <Eigen/Dense>
+#include "QuantumCircuit.h"
+#include "QuantumRegister.h"
+#include "RegisterBatch.h"
+
+//kind of memory sweep performed by a compiled step
+enum class StepKind {
+    SingleQubit,
+    Controlled,
+    Swap,
+    QFT,
+    Layer
+};
+
+//one factor of a fused step, constant factors are premultiplied at compile time
+struct FusedFactor {
+    Eigen::Matrix2cd matrix;    // used when parameterIndex is -1
+    GateType type;
+    double scale;
+    int parameterIndex;
+};
+
+//a single sweep over the register
+struct CompiledStep {
+    StepKind kind;
+    int target;
+    int control;
+    std::vector<FusedFactor> factors;           // applied in order, factors[0] first
+    int span = 0;                               // QFT block size, the block starts at target
+    bool inverse = false;
+    std::vector<CompiledStep> members = {};     // single qubit steps of a Layer, on distinct qubits
+    bool diagonal = true;                       // every factor is diagonal, the step runs on the diagonal kernel
+};
+
+//a textbook QFT found in the gate list
+struct QFTMatch {
+    int firstQubit;
+    int count;
+    bool inverse;
+    bool withSwaps;
+    size_t length;      // number of gates covered
+};
+
+
+/*
+
+    CompiledCircuit class
+
+    execution plan of a QuantumCircuit: runs of single qubit gates on the same qubit are fused
+    into one 2x2 operator so they cost one sweep, parametric factors are resolved per execution
+    so the same plan can be reused for every parameter binding. textbook QFT blocks become
+    a single batched FFT step instead of O(k^2) gate sweeps. the steps are then scheduled by
+    the layers of their DAG and the single qubit steps of a layer share one memory pass
+
+*/
+class CompiledCircuit {
+private:
+    int numQubits;
+    int numParameters;
+    size_t sourceGateCount;
+    std::vector<CompiledStep> steps;
+
+    // Private helper methods
+    static void appendFactor(CompiledStep& step, const GateOperation& operation);
+    void appendQFT(const QFTMatch& match);
+    void scheduleLayers();
+
+public:
+    // single qubit gates of a Layer are fused in Kronecker groups of this many qubits for the batched GEMMs
+    static constexpr int BATCH_LAYER_QUBITS = 3;
+
+    // Constructor
+    CompiledCircuit(const QuantumCircuit& circuit);
+
+    // Getters
+    int getNumQubits() const { return numQubits; }
+    int getNumParameters() const { return numParameters; }
+    size_t getSourceGateCount() const { return sourceGateCount; }
+    size_t getStepCount() const { return steps.size(); }
+    const std::vector<CompiledStep>& getSteps() const { return steps; }
+
+    //longest QFT block starting at operations[position], length 0 when there is none
+    static QFTMatch matchQFT(const std::vector<GateOperation>& operations, size_t position, int qubitCount);
+
+    //2x2 operator of a step for the given binding
+    static Eigen::Matrix2cd resolveStepMatrix(const CompiledStep& step, const std::vector<double>& parameters);
+
+    // Execution, the register is not reset before running
+    void execute(QuantumRegister& quantumRegister, const std::vector<double>& parameters = {}) const;
+    QuantumRegister run(const std::vector<double>& parameters = {}) const;
+
+    //same plan applied to every state of the batch with dense GEMM gates
+    void executeBatch(RegisterBatch& batch, const std::vector<double>& parameters = {}) const;
+};
+
+#endif // COMPILED_CIRCUIT_H
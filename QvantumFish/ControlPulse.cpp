@@ -0,0 +1,95 @@
+#include "ControlPulse.h"
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include <Eigen/Dense>
+
+/*
+
+    CONSTRUCTOR
+
+*/
+ControlPulse::ControlPulse(double sampleDuration, const std::vector<double>& inPhaseSamples,
+    const std::vector<double>& quadratureSamples, const std::vector<double>& detuningSamples)
+    : sampleTime(sampleDuration), inPhase(inPhaseSamples), quadrature(quadratureSamples), detuning(detuningSamples) {
+
+    if (!(sampleDuration > 0.0)) {
+        throw std::invalid_argument("Pulse sample duration must be positive");
+    }
+    if (inPhaseSamples.empty()) {
+        throw std::invalid_argument("Pulse needs at least one sample");
+    }
+    if (quadratureSamples.size() != inPhaseSamples.size() || detuningSamples.size() != inPhaseSamples.size()) {
+        throw std::invalid_argument("Pulse envelopes must have the same number of samples");
+    }
+}
+
+Eigen::Vector3d ControlPulse::rotationVector(size_t sample) const {
+    return Eigen::Vector3d(inPhase[sample], quadrature[sample], detuning[sample]);
+}
+
+/*
+
+    FUNCTION: rabi(rabiFrequency, detuningFrequency, duration, samples):
+                square pulse, on resonance a duration of pi / Omega flips |0> into |1>
+
+*/
+ControlPulse ControlPulse::rabi(double rabiFrequency, double detuningFrequency, double duration, int samples) {
+    if (samples < 1 || !(duration > 0.0)) {
+        throw std::invalid_argument("Pulse needs a positive duration and at least one sample");
+    }
+    size_t count = static_cast<size_t>(samples);
+    return ControlPulse(duration / samples, std::vector<double>(count, rabiFrequency),
+        std::vector<double>(count, 0.0), std::vector<double>(count, detuningFrequency));
+}
+
+/*
+
+    FUNCTION: gaussian(rotationAngle, duration, samples, detuningFrequency, sigmaFraction) / drag(...):
+                Gaussian centered in the pulse with sigma = sigmaFraction * duration, lowered so that it starts
+                and ends at zero and scaled so that its area is the requested rotation angle.
+                DRAG adds the quadrature Omega_y = -beta dOmega_x/dt that cancels the leakage and phase errors
+                of a weakly anharmonic qubit to first order, beta already includes the 1/anharmonicity factor.
+                the envelopes are sampled at the middle of every sample
+
+*/
+ControlPulse ControlPulse::gaussian(double rotationAngle, double duration, int samples, double detuningFrequency, double sigmaFraction) {
+    return drag(rotationAngle, duration, samples, 0.0, detuningFrequency, sigmaFraction);
+}
+
+ControlPulse ControlPulse::drag(double rotationAngle, double duration, int samples, double dragCoefficient, double detuningFrequency, double sigmaFraction) {
+    if (samples < 1 || !(duration > 0.0)) {
+        throw std::invalid_argument("Pulse needs a positive duration and at least one sample");
+    }
+    if (!(sigmaFraction > 0.0)) {
+        throw std::invalid_argument("Gaussian width must be positive");
+    }
+
+    const size_t count = static_cast<size_t>(samples);
+    const double step = duration / samples;
+    const double sigma = sigmaFraction * duration;
+    const double center = duration / 2.0;
+    const double offset = std::exp(-center * center / (2.0 * sigma * sigma));
+
+    std::vector<double> envelope(count);
+    std::vector<double> slope(count);
+    double area = 0.0;
+    for (size_t k = 0; k < count; ++k) {
+        double t = (static_cast<double>(k) + 0.5) * step - center;
+        double gaussianValue = std::exp(-t * t / (2.0 * sigma * sigma));
+        envelope[k] = gaussianValue - offset;
+        slope[k] = -t / (sigma * sigma) * gaussianValue;
+        area += envelope[k] * step;
+    }
+    if (area <= 0.0) {
+        throw std::invalid_argument("Gaussian envelope has no area");
+    }
+
+    const double scale = rotationAngle / area;
+    std::vector<double> quadratureSamples(count);
+    for (size_t k = 0; k < count; ++k) {
+        envelope[k] *= scale;
+        quadratureSamples[k] = -dragCoefficient * scale * slope[k];
+    }
+    return ControlPulse(step, envelope, quadratureSamples, std::vector<double>(count, detuningFrequency));
+}
@@ -0,0 +1,50 @@
+#ifndef CONTROL_PULSE_H
+#define CONTROL_PULSE_H
+
+#include <cstddef>
+#include <vector>
+#include <Eigen/Dense>
+
+
+/*
+
+    ControlPulse class
+
+    single qubit drive in the rotating frame, sampled on a uniform grid and held constant inside each sample
+
+                    H(t) = (Omega_x(t) X + Omega_y(t) Y + Delta(t) Z) / 2
+
+    Omega_x is the in phase envelope, Omega_y the quadrature one (the DRAG correction) and Delta the detuning,
+    all of them in radians per unit of time
+
+*/
+class ControlPulse {
+private:
+    double sampleTime;
+    std::vector<double> inPhase;
+    std::vector<double> quadrature;
+    std::vector<double> detuning;
+
+public:
+    // Constructor, arbitrary sampled envelopes of the same length
+    ControlPulse(double sampleDuration, const std::vector<double>& inPhaseSamples,
+        const std::vector<double>& quadratureSamples, const std::vector<double>& detuningSamples);
+
+    // Getters
+    double getSampleTime() const { return sampleTime; }
+    size_t getSampleCount() const { return inPhase.size(); }
+    double getDuration() const { return sampleTime * static_cast<double>(inPhase.size()); }
+    const std::vector<double>& getInPhase() const { return inPhase; }
+    const std::vector<double>& getQuadrature() const { return quadrature; }
+    const std::vector<double>& getDetuning() const { return detuning; }
+
+    //rotation vector (Omega_x, Omega_y, Delta) of one sample, the Bloch vector precesses around it
+    Eigen::Vector3d rotationVector(size_t sample) const;
+
+    // Pulse shapes
+    static ControlPulse rabi(double rabiFrequency, double detuningFrequency, double duration, int samples);
+    static ControlPulse gaussian(double rotationAngle, double duration, int samples, double detuningFrequency = 0.0, double sigmaFraction = 0.25);
+    static ControlPulse drag(double rotationAngle, double duration, int samples, double dragCoefficient, double detuningFrequency = 0.0, double sigmaFraction = 0.25);
+};
+
+#endif // CONTROL_PULSE_H
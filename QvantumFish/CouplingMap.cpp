@@ -0,0 +1,134 @@
+#include "CouplingMap.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "ParallelUtils.h"
+
+//out of class definition, assign and find bind the constant to a reference
+constexpr int CouplingMap::UNREACHABLE;
+
+/*
+
+    CONSTRUCTOR
+
+*/
+CouplingMap::CouplingMap(int qubitCount, const std::vector<std::pair<int, int>>& couplings)
+    : numQubits(qubitCount), diameter(0), neighbors(qubitCount > 0 ? qubitCount : 0) {
+
+    if (qubitCount < 1) {
+        throw std::invalid_argument("A coupling map needs at least one qubit");
+    }
+    if (qubitCount > MAX_QUBITS) {
+        throw std::invalid_argument("A coupling map holds at most " + std::to_string(MAX_QUBITS) + " qubits");
+    }
+    for (const std::pair<int, int>& coupling : couplings) {
+        int first = coupling.first;
+        int second = coupling.second;
+        if (first < 0 || first >= qubitCount || second < 0 || second >= qubitCount) {
+            throw std::out_of_range("Coupling refers to a qubit outside of the device");
+        }
+        if (first == second) {
+            throw std::invalid_argument("A qubit cannot be coupled to itself");
+        }
+        if (std::find(neighbors[first].begin(), neighbors[first].end(), second) != neighbors[first].end()) {
+            continue;
+        }
+        neighbors[first].push_back(second);
+        neighbors[second].push_back(first);
+        edges.push_back({ std::min(first, second), std::max(first, second) });
+    }
+    computeDistances();
+}
+
+/*
+
+    FUNCTION: computeDistances():
+                one breadth first search per source qubit, each search writes only its own row
+
+*/
+void CouplingMap::computeDistances() {
+    const size_t count = static_cast<size_t>(numQubits);
+    distances.assign(count * count, UNREACHABLE);
+
+    parallelFor(0, count, 16, [&](size_t first, size_t last) {
+        std::vector<int> queue(count);
+        for (size_t source = first; source < last; ++source) {
+            std::int16_t* row = distances.data() + source * count;
+            size_t head = 0;
+            size_t tail = 0;
+            row[source] = 0;
+            queue[tail++] = static_cast<int>(source);
+            while (head < tail) {
+                int qubit = queue[head++];
+                for (int neighbor : neighbors[qubit]) {
+                    if (row[neighbor] == UNREACHABLE) {
+                        row[neighbor] = static_cast<std::int16_t>(row[qubit] + 1);
+                        queue[tail++] = neighbor;
+                    }
+                }
+            }
+        }
+    });
+
+    diameter = *std::max_element(distances.begin(), distances.end());
+}
+
+bool CouplingMap::isConnected() const {
+    return std::find(distances.begin(), distances.end(), UNREACHABLE) == distances.end();
+}
+
+int CouplingMap::nextHop(int first, int second) const {
+    const int remaining = distance(first, second);
+    if (remaining <= 0) {
+        throw std::invalid_argument("No path between the two qubits");
+    }
+    for (int neighbor : neighbors[first]) {
+        if (distance(neighbor, second) == remaining - 1) {
+            return neighbor;
+        }
+    }
+    throw std::logic_error("Inconsistent coupling distances");
+}
+
+/*
+
+    FUNCTION: line(qubitCount) / ring(qubitCount) / grid(rows, columns):
+                grid qubits are numbered row by row
+
+*/
+CouplingMap CouplingMap::line(int qubitCount) {
+    std::vector<std::pair<int, int>> couplings;
+    for (int qubit = 0; qubit + 1 < qubitCount; ++qubit) {
+        couplings.push_back({ qubit, qubit + 1 });
+    }
+    return CouplingMap(qubitCount, couplings);
+}
+
+CouplingMap CouplingMap::ring(int qubitCount) {
+    std::vector<std::pair<int, int>> couplings;
+    for (int qubit = 0; qubit < qubitCount && qubitCount > 1; ++qubit) {
+        couplings.push_back({ qubit, (qubit + 1) % qubitCount });
+    }
+    return CouplingMap(qubitCount, couplings);
+}
+
+CouplingMap CouplingMap::grid(int rows, int columns) {
+    if (rows < 1 || columns < 1) {
+        throw std::invalid_argument("Grid needs at least one row and one column");
+    }
+    std::vector<std::pair<int, int>> couplings;
+    for (int row = 0; row < rows; ++row) {
+        for (int column = 0; column < columns; ++column) {
+            int qubit = row * columns + column;
+            if (column + 1 < columns) {
+                couplings.push_back({ qubit, qubit + 1 });
+            }
+            if (row + 1 < rows) {
+                couplings.push_back({ qubit, qubit + columns });
+            }
+        }
+    }
+    return CouplingMap(rows * columns, couplings);
+}
@@ -0,0 +1,58 @@
+#ifndef COUPLING_MAP_H
+#define COUPLING_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+
+/*
+
+    CouplingMap class
+
+    undirected connectivity graph of the physical qubits of a device, two qubit gates are only possible
+    along its edges. the distance of every pair is precomputed once by a breadth first search from every
+    node (run in parallel), so routers read distances in O(1). distances are stored on 16 bits to halve the
+    table, a 1024 qubit grid then takes 2 MB
+
+*/
+class CouplingMap {
+private:
+    int numQubits;
+    int diameter;
+    std::vector<std::pair<int, int>> edges;
+    std::vector<std::vector<int>> neighbors;
+    std::vector<std::int16_t> distances;    // row major numQubits x numQubits, symmetric
+
+    // Private helper method
+    void computeDistances();
+
+public:
+    // distance between qubits of different components
+    static constexpr int UNREACHABLE = -1;
+    // largest device whose distances fit the 16 bit table
+    static constexpr int MAX_QUBITS = 32767;
+
+    // Constructor, duplicated edges are ignored, at most MAX_QUBITS qubits
+    CouplingMap(int qubitCount, const std::vector<std::pair<int, int>>& couplings);
+
+    // Getters
+    int getNumQubits() const { return numQubits; }
+    int getDiameter() const { return diameter; }
+    const std::vector<std::pair<int, int>>& getEdges() const { return edges; }
+    const std::vector<int>& getNeighbors(int qubit) const { return neighbors[qubit]; }
+    int distance(int first, int second) const { return distances[static_cast<size_t>(first) * numQubits + second]; }
+    bool areConnected(int first, int second) const { return distance(first, second) == 1; }
+    bool isConnected() const;
+
+    //neighbor of first one step closer to second along a shortest path
+    int nextHop(int first, int second) const;
+
+    // Common device layouts
+    static CouplingMap line(int qubitCount);
+    static CouplingMap ring(int qubitCount);
+    static CouplingMap grid(int rows, int columns);
+};
+
+#endif // COUPLING_MAP_H
@@ -0,0 +1,181 @@
+#include "DynamicCircuit.h"
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include "ParallelUtils.h"
+
+/*
+
+    CONSTRUCTOR
+
+*/
+DynamicCircuit::DynamicCircuit(int qubitCount, int bitCount) : numBits(bitCount), gates(qubitCount) {
+    if (bitCount < 0) {
+        throw std::invalid_argument("Classical register size cannot be negative");
+    }
+    lastMeasurement.assign(qubitCount, -1);
+}
+
+void DynamicCircuit::checkQubit(int qubit) const {
+    if (qubit < 0 || qubit >= getNumQubits()) {
+        throw std::out_of_range("Qubit outside of the circuit");
+    }
+}
+
+void DynamicCircuit::checkBit(int bit) const {
+    if (bit < 0 || bit >= numBits) {
+        throw std::out_of_range("Classical bit outside of the circuit");
+    }
+}
+
+/*
+
+    FUNCTION: touch(qubit):
+                a new instruction on the qubit, so its last measurement so far cannot drop it anymore
+
+*/
+void DynamicCircuit::touch(int qubit) {
+    if (lastMeasurement[qubit] >= 0) {
+        instructions[lastMeasurement[qubit]].discard = false;
+        lastMeasurement[qubit] = -1;
+    }
+}
+
+/*
+
+    BUILDERS
+
+*/
+void DynamicCircuit::addOperation(const GateOperation& operation) {
+    gates.addOperation(operation);
+    touch(operation.target);
+    if (QuantumCircuit::isTwoQubit(operation.type)) {
+        touch(operation.control);
+    }
+    instructions.push_back({ InstructionKind::Gate, -1, -1, 0, static_cast<int>(gates.getGateCount()) - 1, false });
+}
+
+void DynamicCircuit::addConditionalOperation(const GateOperation& operation, int bit, int value) {
+    checkBit(bit);
+    if (value != 0 && value != 1) {
+        throw std::invalid_argument("Condition value must be 0 or 1");
+    }
+    addOperation(operation);
+    instructions.back().bit = bit;
+    instructions.back().value = value;
+}
+
+void DynamicCircuit::addCircuit(const QuantumCircuit& circuit) {
+    if (circuit.getNumQubits() > getNumQubits()) {
+        throw std::invalid_argument("Circuit does not fit in the dynamic circuit");
+    }
+    for (const GateOperation& operation : circuit.getOperations()) {
+        addOperation(operation);
+    }
+}
+
+void DynamicCircuit::addMeasurement(int qubit, int bit) {
+    checkQubit(qubit);
+    checkBit(bit);
+    touch(qubit);
+    instructions.push_back({ InstructionKind::Measure, qubit, bit, 0, -1, true });
+    lastMeasurement[qubit] = static_cast<int>(instructions.size()) - 1;
+}
+
+void DynamicCircuit::addReset(int qubit) {
+    checkQubit(qubit);
+    touch(qubit);
+    instructions.push_back({ InstructionKind::Reset, qubit, -1, 0, -1, false });
+}
+
+/*
+
+    FUNCTION: run(parameters, seed, discardMeasured):
+                the register follows the program with a map from circuit qubits to register qubits. a measurement
+                marked as discard removes its register qubit, the ones above it move down by one, so the map and
+                the list of live qubits are shifted with it. the last qubit of the register is always kept
+
+*/
+DynamicRunResult DynamicCircuit::run(const std::vector<double>& parameters, std::uint64_t seed, bool discardMeasured) const {
+    if (static_cast<int>(parameters.size()) < getNumParameters()) {
+        throw std::invalid_argument("Not enough parameters bound for the dynamic circuit");
+    }
+    if (seed == 0) {
+        std::random_device device;
+        seed = (static_cast<std::uint64_t>(device()) << 32) | device();
+    }
+    std::mt19937_64 generator(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    QuantumRegister state(getNumQubits());
+    std::vector<int> registerQubit(getNumQubits());
+    std::iota(registerQubit.begin(), registerQubit.end(), 0);
+    std::vector<int> liveQubits = registerQubit;
+    std::vector<int> bits(numBits, 0);
+    int discarded = 0;
+
+    for (const DynamicInstruction& instruction : instructions) {
+        switch (instruction.kind) {
+        case InstructionKind::Gate: {
+            if (instruction.bit >= 0 && bits[instruction.bit] != instruction.value) {
+                break;
+            }
+            GateOperation operation = gates.getOperations()[instruction.gateIndex];
+            operation.angle = QuantumCircuit::resolveAngle(operation, parameters);
+            operation.parameterIndex = -1;
+            operation.target = registerQubit[operation.target];
+            if (operation.control >= 0) {
+                operation.control = registerQubit[operation.control];
+            }
+            state.applyGate(operation);
+            break;
+        }
+        case InstructionKind::Measure: {
+            const int position = registerQubit[instruction.qubit];
+            if (!discardMeasured || !instruction.discard || state.getNumQubits() == 1) {
+                bits[instruction.bit] = state.measure(position, uniform(generator));
+                break;
+            }
+            bits[instruction.bit] = state.measureAndDiscard(position, uniform(generator));
+            liveQubits.erase(liveQubits.begin() + position);
+            for (int& qubit : registerQubit) {
+                if (qubit > position) {
+                    --qubit;
+                }
+            }
+            registerQubit[instruction.qubit] = -1;
+            ++discarded;
+            break;
+        }
+        case InstructionKind::Reset:
+            state.resetQubit(registerQubit[instruction.qubit], uniform(generator));
+            break;
+        }
+    }
+
+    return { std::move(bits), std::move(state), std::move(liveQubits), getNumQubits(), discarded };
+}
+
+/*
+
+    FUNCTION: sample(shots, parameters, seed):
+                independent runs, shot k is seeded from (seed, k) so the record does not depend on the worker count
+
+*/
+std::vector<std::vector<int>> DynamicCircuit::sample(size_t shots, const std::vector<double>& parameters, std::uint64_t seed) const {
+    if (seed == 0) {
+        std::random_device device;
+        seed = (static_cast<std::uint64_t>(device()) << 32) | device();
+    }
+
+    std::vector<std::vector<int>> records(shots);
+    parallelFor(0, shots, 1, [&](size_t first, size_t last) {
+        for (size_t shot = first; shot < last; ++shot) {
+            //the seed of a shot is never 0, which would ask run for a random one
+            records[shot] = run(parameters, (seed ^ (0x9E3779B97F4A7C15ULL * (shot + 1))) | 1).bits;
+        }
+    });
+    return records;
+}
@@ -0,0 +1,84 @@
+#ifndef DYNAMIC_CIRCUIT_H
+#define DYNAMIC_CIRCUIT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "QuantumCircuit.h"
+#include "QuantumRegister.h"
+
+//steps of a dynamic circuit
+enum class InstructionKind {
+    Gate,
+    Measure,
+    Reset
+};
+
+//a step of the program, gates are stored in the QuantumCircuit of the program and referenced by index
+struct DynamicInstruction {
+    InstructionKind kind;
+    int qubit;              // measured or reset qubit, -1 for gates
+    int bit;                // destination of a measurement, condition of a gate (-1 when unconditional)
+    int value;              // the gate runs when bit == value
+    int gateIndex;          // position in the gate list, -1 for measurements and resets
+    bool discard;           // measurement after which the qubit is never used again
+};
+
+//classical record and quantum state at the end of a run
+struct DynamicRunResult {
+    std::vector<int> bits;
+    QuantumRegister state;              // only the qubits still alive at the end
+    std::vector<int> liveQubits;        // circuit qubit of every register qubit, liveQubits[k] is bit k of the index
+    int peakQubits;                     // qubits of the register before any was discarded
+    int discardedQubits;
+};
+
+
+/*
+
+    DynamicCircuit class
+
+    circuit with mid circuit measurements, resets and gates conditioned on measured bits, as needed by
+    teleportation and error correction rounds. when a program is built every measurement is checked against the
+    rest of the program, a qubit that is not touched again is removed from the register by the measurement itself
+    so long feed forward programs keep halving their state vector instead of carrying dead qubits along
+
+*/
+class DynamicCircuit {
+private:
+    int numBits;
+    QuantumCircuit gates;
+    std::vector<DynamicInstruction> instructions;
+    std::vector<int> lastMeasurement;   // instruction of the measurement that still ends each qubit, -1 if none
+
+    // Private helper methods
+    void checkQubit(int qubit) const;
+    void checkBit(int bit) const;
+    void touch(int qubit);
+
+public:
+    // Constructor
+    DynamicCircuit(int qubitCount, int bitCount);
+
+    // Getters
+    int getNumQubits() const { return gates.getNumQubits(); }
+    int getNumBits() const { return numBits; }
+    int getNumParameters() const { return gates.getNumParameters(); }
+    const QuantumCircuit& getGates() const { return gates; }
+    const std::vector<DynamicInstruction>& getInstructions() const { return instructions; }
+
+    // Builders
+    void addOperation(const GateOperation& operation);
+    void addConditionalOperation(const GateOperation& operation, int bit, int value = 1);
+    void addCircuit(const QuantumCircuit& circuit);
+    void addMeasurement(int qubit, int bit);
+    void addReset(int qubit);
+
+    //one shot of the program, a seed of 0 draws a random seed. discarding can be turned off to keep every qubit
+    DynamicRunResult run(const std::vector<double>& parameters = {}, std::uint64_t seed = 0, bool discardMeasured = true) const;
+
+    //bits of many independent shots, shot k uses a generator seeded from (seed, k) and shots run in parallel
+    std::vector<std::vector<int>> sample(size_t shots, const std::vector<double>& parameters = {}, std::uint64_t seed = 0) const;
+};
+
+#endif // DYNAMIC_CIRCUIT_H
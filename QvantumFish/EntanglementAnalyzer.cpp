@@ -0,0 +1,205 @@
+#include "EntanglementAnalyzer.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <Eigen/Dense>
+#include "ParallelUtils.h"
+
+/*
+
+    FUNCTION: schmidtSpectrum(matrix, usedGram):
+                singular values of the reshaped register in descending order,
+                the smaller Gram matrix has eigenvalues s_i^2 so it is much cheaper when one side is small
+
+*/
+static Eigen::VectorXd schmidtSpectrum(const Eigen::Ref<const Eigen::MatrixXcd>& matrix, bool& usedGram) {
+    const Eigen::Index smallSide = std::min(matrix.rows(), matrix.cols());
+    usedGram = smallSide <= (static_cast<Eigen::Index>(1) << EntanglementAnalyzer::GRAM_FAST_PATH_QUBITS);
+
+    if (!usedGram) {
+        Eigen::BDCSVD<Eigen::MatrixXcd> svd(matrix);
+        return svd.singularValues();
+    }
+
+    Eigen::MatrixXcd gram = matrix.rows() <= matrix.cols()
+        ? Eigen::MatrixXcd(matrix * matrix.adjoint())
+        : Eigen::MatrixXcd(matrix.adjoint() * matrix);
+
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXcd> solver(gram, Eigen::EigenvaluesOnly);
+    const Eigen::VectorXd& eigenvalues = solver.eigenvalues();
+
+    //eigenvalues come in ascending order, round off can make the smallest ones slightly negative
+    Eigen::VectorXd coefficients(eigenvalues.size());
+    for (Eigen::Index k = 0; k < eigenvalues.size(); ++k) {
+        coefficients(k) = std::sqrt(std::max(0.0, eigenvalues(eigenvalues.size() - 1 - k)));
+    }
+    return coefficients;
+}
+
+/*
+
+    FUNCTION: checkSubsystem(numQubits, subsystem):
+                a cut needs at least one qubit on each side and no repeated qubits
+
+*/
+static void checkSubsystem(int numQubits, const std::vector<int>& subsystem) {
+    if (subsystem.empty() || static_cast<int>(subsystem.size()) >= numQubits) {
+        throw std::invalid_argument("A bipartition needs qubits on both sides");
+    }
+
+    std::vector<bool> used(numQubits, false);
+    for (int qubit : subsystem) {
+        if (qubit < 0 || qubit >= numQubits) {
+            throw std::out_of_range("Subsystem qubit outside of the register");
+        }
+        if (used[qubit]) {
+            throw std::invalid_argument("Subsystem qubits must be unique");
+        }
+        used[qubit] = true;
+    }
+}
+
+/*
+
+    FUNCTION: reshape(quantumRegister, subsystem):
+                bit k of the row index is the subsystem qubit subsystem[k], the column index collects
+                the remaining qubits in increasing order
+
+*/
+Eigen::MatrixXcd EntanglementAnalyzer::reshape(const QuantumRegister& quantumRegister, const std::vector<int>& subsystem) {
+    const int numQubits = quantumRegister.getNumQubits();
+    checkSubsystem(numQubits, subsystem);
+
+    std::vector<bool> inSubsystem(numQubits, false);
+    for (int qubit : subsystem) {
+        inSubsystem[qubit] = true;
+    }
+    std::vector<int> complement;
+    for (int qubit = 0; qubit < numQubits; ++qubit) {
+        if (!inSubsystem[qubit]) {
+            complement.push_back(qubit);
+        }
+    }
+
+    const Eigen::Index rows = static_cast<Eigen::Index>(1) << subsystem.size();
+    const Eigen::Index cols = static_cast<Eigen::Index>(1) << complement.size();
+    const Eigen::VectorXcd& amplitudes = quantumRegister.getAmplitudes();
+    Eigen::MatrixXcd matrix(rows, cols);
+
+    for (Eigen::Index i = 0; i < amplitudes.size(); ++i) {
+        Eigen::Index row = 0;
+        Eigen::Index col = 0;
+        for (size_t k = 0; k < subsystem.size(); ++k) {
+            row |= ((i >> subsystem[k]) & 1) << k;
+        }
+        for (size_t k = 0; k < complement.size(); ++k) {
+            col |= ((i >> complement[k]) & 1) << k;
+        }
+        matrix(row, col) = amplitudes(i);
+    }
+    return matrix;
+}
+
+/*
+
+    FUNCTION: analyze(quantumRegister, subsystem):
+                when one side of the cut is the block of lowest qubits the state vector already is the
+                column major reshaped matrix, so it is mapped in place instead of copied. the spectrum
+                is symmetric in A and B so a block of highest qubits is handled the same way
+
+*/
+EntanglementResult EntanglementAnalyzer::analyze(const QuantumRegister& quantumRegister, const std::vector<int>& subsystem) {
+    const int numQubits = quantumRegister.getNumQubits();
+    checkSubsystem(numQubits, subsystem);
+
+    std::vector<int> sorted = subsystem;
+    std::sort(sorted.begin(), sorted.end());
+    const int size = static_cast<int>(sorted.size());
+    const bool lowBlock = sorted.back() == size - 1;
+    const bool highBlock = sorted.front() == numQubits - size;
+
+    EntanglementResult result;
+    result.subsystem = subsystem;
+
+    if (lowBlock || highBlock) {
+        const int lowQubits = lowBlock ? size : numQubits - size;
+        const Eigen::Index rows = static_cast<Eigen::Index>(1) << lowQubits;
+        const Eigen::Index cols = static_cast<Eigen::Index>(1) << (numQubits - lowQubits);
+        Eigen::Map<const Eigen::MatrixXcd> matrix(quantumRegister.getAmplitudes().data(), rows, cols);
+        result.schmidtCoefficients = schmidtSpectrum(matrix, result.usedGramFastPath);
+    }
+    else {
+        result.schmidtCoefficients = schmidtSpectrum(reshape(quantumRegister, subsystem), result.usedGramFastPath);
+    }
+
+    result.vonNeumannEntropy = vonNeumannEntropy(result.schmidtCoefficients);
+    result.renyi2Entropy = renyiEntropy(result.schmidtCoefficients, 2.0);
+    return result;
+}
+
+/*
+
+    FUNCTION: analyzeCuts(quantumRegister, cuts) / analyzeChain(quantumRegister):
+                the cuts are independent so each worker takes its own share of them
+
+*/
+std::vector<EntanglementResult> EntanglementAnalyzer::analyzeCuts(const QuantumRegister& quantumRegister, const std::vector<std::vector<int>>& cuts) {
+    std::vector<EntanglementResult> results(cuts.size());
+
+    parallelFor(0, cuts.size(), 1, [&](size_t first, size_t last) {
+        for (size_t cut = first; cut < last; ++cut) {
+            results[cut] = analyze(quantumRegister, cuts[cut]);
+        }
+    });
+
+    return results;
+}
+
+std::vector<EntanglementResult> EntanglementAnalyzer::analyzeChain(const QuantumRegister& quantumRegister) {
+    std::vector<std::vector<int>> cuts;
+    for (int k = 1; k < quantumRegister.getNumQubits(); ++k) {
+        std::vector<int> cut;
+        for (int qubit = 0; qubit < k; ++qubit) {
+            cut.push_back(qubit);
+        }
+        cuts.push_back(cut);
+    }
+    return analyzeCuts(quantumRegister, cuts);
+}
+
+/*
+
+    FUNCTION: vonNeumannEntropy(schmidtCoefficients) / renyiEntropy(schmidtCoefficients, alpha):
+                with the Schmidt probabilities p_i = s_i^2
+
+                    S = - sum p_i log2(p_i)          S_alpha = log2(sum p_i^alpha) / (1 - alpha)
+
+*/
+double EntanglementAnalyzer::vonNeumannEntropy(const Eigen::VectorXd& schmidtCoefficients) {
+    double entropy = 0.0;
+    for (Eigen::Index k = 0; k < schmidtCoefficients.size(); ++k) {
+        double probability = schmidtCoefficients(k) * schmidtCoefficients(k);
+        if (probability > 1e-15) {
+            entropy -= probability * std::log2(probability);
+        }
+    }
+    return entropy;
+}
+
+double EntanglementAnalyzer::renyiEntropy(const Eigen::VectorXd& schmidtCoefficients, double alpha) {
+    if (alpha < 0.0) {
+        throw std::invalid_argument("Renyi order must be non negative");
+    }
+    if (std::abs(alpha - 1.0) < 1e-12) {
+        return vonNeumannEntropy(schmidtCoefficients);
+    }
+
+    double sum = 0.0;
+    for (Eigen::Index k = 0; k < schmidtCoefficients.size(); ++k) {
+        double probability = schmidtCoefficients(k) * schmidtCoefficients(k);
+        if (probability > 1e-15) {
+            sum += std::pow(probability, alpha);
+        }
+    }
+    return std::log2(sum) / (1.0 - alpha);
+}
@@ -0,0 +1,46 @@
+#ifndef ENTANGLEMENT_ANALYZER_H
+#define ENTANGLEMENT_ANALYZER_H
+
+#include <vector>
+#include <Eigen/Dense>
+#include "QuantumRegister.h"
+
+//Schmidt decomposition of the register across one cut A|B
+struct EntanglementResult {
+    std::vector<int> subsystem;             // qubits of side A
+    Eigen::VectorXd schmidtCoefficients;    // descending, their squares sum to one
+    double vonNeumannEntropy;               // in bits
+    double renyi2Entropy;                   // in bits
+    bool usedGramFastPath;
+};
+
+
+/*
+
+    EntanglementAnalyzer class
+
+    the register reshaped as a dA x dB matrix M has singular values equal to the Schmidt coefficients,
+    when one side is small enough the eigenvalues of the small Gram matrix M M^dagger are used instead
+
+*/
+class EntanglementAnalyzer {
+public:
+    // sides with at most this many qubits go through the Gram matrix and SelfAdjointEigenSolver
+    static constexpr int GRAM_FAST_PATH_QUBITS = 8;
+
+    //amplitudes arranged as a matrix with one row per basis state of the subsystem
+    static Eigen::MatrixXcd reshape(const QuantumRegister& quantumRegister, const std::vector<int>& subsystem);
+
+    // Analysis of a single cut and of many cuts in parallel
+    static EntanglementResult analyze(const QuantumRegister& quantumRegister, const std::vector<int>& subsystem);
+    static std::vector<EntanglementResult> analyzeCuts(const QuantumRegister& quantumRegister, const std::vector<std::vector<int>>& cuts);
+
+    //every contiguous cut [0, k) for k = 1 ... N-1, the usual entanglement profile of a chain
+    static std::vector<EntanglementResult> analyzeChain(const QuantumRegister& quantumRegister);
+
+    // Entropies of a Schmidt spectrum, alpha = 1 gives the von Neumann entropy
+    static double vonNeumannEntropy(const Eigen::VectorXd& schmidtCoefficients);
+    static double renyiEntropy(const Eigen::VectorXd& schmidtCoefficients, double alpha);
+};
+
+#endif // ENTANGLEMENT_ANALYZER_H
@@ -0,0 +1,120 @@
+#include "ExactEvolution.h"
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <Eigen/Dense>
+
+/*
+
+    CONSTRUCTOR
+
+*/
+ExactEvolution::ExactEvolution(const Eigen::MatrixXcd& hamiltonian) : hasInitialState(false) {
+    if (hamiltonian.rows() != hamiltonian.cols() || hamiltonian.rows() == 0) {
+        throw std::invalid_argument("Hamiltonian must be a non empty square matrix");
+    }
+    if (hamiltonian.rows() > (static_cast<Eigen::Index>(1) << MAX_DENSE_QUBITS)) {
+        throw std::invalid_argument("Hamiltonian too large for dense diagonalization");
+    }
+    if (!hamiltonian.isApprox(hamiltonian.adjoint(), 1e-10)) {
+        throw std::invalid_argument("Hamiltonian is not Hermitian");
+    }
+
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXcd> solver(hamiltonian);
+    if (solver.info() != Eigen::Success) {
+        throw std::runtime_error("Hamiltonian diagonalization failed");
+    }
+    energies = solver.eigenvalues();
+    eigenvectors = solver.eigenvectors();
+}
+
+/*
+
+    FUNCTION: evolve(state, time):
+                project on the eigenbasis, rotate every component by its phase and go back
+
+*/
+Eigen::VectorXcd ExactEvolution::evolve(const Eigen::VectorXcd& state, double time) const {
+    if (state.size() != energies.size()) {
+        throw std::invalid_argument("State size does not match the Hamiltonian");
+    }
+
+    Eigen::VectorXcd coefficients = eigenvectors.adjoint() * state;
+    for (Eigen::Index k = 0; k < coefficients.size(); ++k) {
+        coefficients(k) *= std::polar(1.0, -energies(k) * time);
+    }
+    return eigenvectors * coefficients;
+}
+
+void ExactEvolution::evolve(QuantumRegister& quantumRegister, double time) const {
+    quantumRegister.getAmplitudes() = evolve(quantumRegister.getAmplitudes(), time);
+}
+
+/*
+
+    FUNCTION: setInitialState(state) / stateAt(time) / qubitAt(time):
+                the projection V^dagger|psi0> does not depend on time, so once it is cached
+                every frame only needs the diagonal phase and the product with V
+
+*/
+void ExactEvolution::setInitialState(const Eigen::VectorXcd& state) {
+    if (state.size() != energies.size()) {
+        throw std::invalid_argument("State size does not match the Hamiltonian");
+    }
+    initialCoefficients = eigenvectors.adjoint() * state;
+    hasInitialState = true;
+}
+
+Eigen::VectorXcd ExactEvolution::stateAt(double time) const {
+    if (!hasInitialState) {
+        throw std::logic_error("No initial state set for the evolution");
+    }
+
+    Eigen::VectorXcd coefficients(initialCoefficients.size());
+    for (Eigen::Index k = 0; k < coefficients.size(); ++k) {
+        coefficients(k) = initialCoefficients(k) * std::polar(1.0, -energies(k) * time);
+    }
+    return eigenvectors * coefficients;
+}
+
+Qubit ExactEvolution::qubitAt(double time) const {
+    if (energies.size() != 2) {
+        throw std::logic_error("qubitAt needs a single qubit Hamiltonian");
+    }
+
+    //renormalize to absorb the round off of the products before the Qubit normalization check
+    Eigen::VectorXcd state = stateAt(time);
+    return Qubit(Eigen::Vector2cd(state.normalized()));
+}
+
+/*
+
+    FUNCTION: energyExpectation(state):
+                <psi|H|psi> = sum_k E_k |<k|psi>|^2
+
+*/
+double ExactEvolution::energyExpectation(const Eigen::VectorXcd& state) const {
+    Eigen::VectorXcd coefficients = eigenvectors.adjoint() * state;
+    return coefficients.cwiseAbs2().dot(energies);
+}
+
+/*
+
+    FUNCTION: larmorHamiltonian(larmorFrequency) / rabiHamiltonian(rabiFrequency, detuning):
+                precession around z at the Larmor frequency, H = (w/2) Z, and a resonant drive in the
+                rotating frame, H = (detuning/2) Z + (rabi/2) X
+
+*/
+Eigen::Matrix2cd ExactEvolution::larmorHamiltonian(double larmorFrequency) {
+    Eigen::Matrix2cd hamiltonian;
+    hamiltonian << larmorFrequency / 2.0, 0.0,
+        0.0, -larmorFrequency / 2.0;
+    return hamiltonian;
+}
+
+Eigen::Matrix2cd ExactEvolution::rabiHamiltonian(double rabiFrequency, double detuning) {
+    Eigen::Matrix2cd hamiltonian;
+    hamiltonian << detuning / 2.0, rabiFrequency / 2.0,
+        rabiFrequency / 2.0, -detuning / 2.0;
+    return hamiltonian;
+}
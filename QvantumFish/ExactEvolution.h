@@ -0,0 +1,58 @@
+#ifndef EXACT_EVOLUTION_H
+#define EXACT_EVOLUTION_H
+
+#include <Eigen/Dense>
+#include "Qubit.h"
+#include "QuantumRegister.h"
+
+
+/*
+
+    ExactEvolution class
+
+    time evolution under a small dense Hamiltonian, H = V diag(E) V^dagger is diagonalized once so
+
+                        exp(-iHt)|psi> = V diag(exp(-i E t)) V^dagger |psi>
+
+    for any t, with the initial state projected once V^dagger|psi0> is cached as well
+
+*/
+class ExactEvolution {
+private:
+    Eigen::VectorXd energies;
+    Eigen::MatrixXcd eigenvectors;
+
+    // cached V^dagger |psi0>
+    Eigen::VectorXcd initialCoefficients;
+    bool hasInitialState;
+
+public:
+    // dense diagonalization is limited to 2^12 x 2^12 Hamiltonians
+    static constexpr int MAX_DENSE_QUBITS = 12;
+
+    // Constructor, H must be Hermitian
+    ExactEvolution(const Eigen::MatrixXcd& hamiltonian);
+
+    // Getters
+    Eigen::Index getDimension() const { return energies.size(); }
+    const Eigen::VectorXd& getEnergies() const { return energies; }
+    const Eigen::MatrixXcd& getEigenvectors() const { return eigenvectors; }
+
+    // Evolution of any state
+    Eigen::VectorXcd evolve(const Eigen::VectorXcd& state, double time) const;
+    void evolve(QuantumRegister& quantumRegister, double time) const;
+
+    // Evolution of a cached initial state, one matrix vector product per call
+    void setInitialState(const Eigen::VectorXcd& state);
+    Eigen::VectorXcd stateAt(double time) const;
+    Qubit qubitAt(double time) const;
+
+    //<H> of a state
+    double energyExpectation(const Eigen::VectorXcd& state) const;
+
+    // Single qubit Hamiltonians for the Bloch sphere animations
+    static Eigen::Matrix2cd larmorHamiltonian(double larmorFrequency);
+    static Eigen::Matrix2cd rabiHamiltonian(double rabiFrequency, double detuning);
+};
+
+#endif // EXACT_EVOLUTION_H
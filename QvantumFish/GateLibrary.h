@@ -0,0 +1,226 @@
+#ifndef GATE_LIBRARY_H
+#define GATE_LIBRARY_H
+
+#include <array>
+#include <cmath>
+#include <complex>
+#include <type_traits>
+#include <Eigen/Dense>
+#include "QuantumCircuit.h"
+
+/*
+
+    Gate library shared by the circuit layer and the kernels
+
+    every GateType has compile time metadata and the fixed gates have compile time matrices, so a caller
+    picks the memory sweep of a gate from its kind (a table read, or a tag type when the gate is known at
+    compile time) instead of inspecting the entries of a matrix. parameterized gates are inline functions
+    of their angle. two qubit matrices use the index target bit + 2 control bit, like RegisterBatch
+
+*/
+
+//memory sweep that applies a gate with the least work
+enum class GateKernel {
+    Identity,           // nothing to do
+    Diagonal,           // diag(d0, d1), only the |1> half is touched when d0 = 1
+    AntiDiagonal,       // X and Y, a swap of the pair with two phases
+    Dense,              // general 2x2
+    Controlled,         // 2x2 on the target where the control is set
+    Swap                // exchange of two qubits
+};
+
+//compile time properties of a gate type, rotations are described for a generic angle
+struct GateTraits {
+    const char* name;
+    int qubitCount;
+    bool parametric;
+    bool controlled;
+    bool diagonal;          // diagonal in the computational basis
+    bool permutation;       // one non zero entry per column (a permutation up to phases)
+    bool clifford;          // maps Paulis to Paulis, false for rotations of a generic angle
+    bool selfInverse;
+    bool hermitian;
+    bool symmetric;         // two qubit gates that do not distinguish their qubits
+    bool namedInverse;      // the inverse is the GateType in inverse (rotations: the same type with -angle)
+    GateType inverse;
+    double phase;           // phi of diag(1, exp(i phi)) for the fixed diagonal gates, 0 otherwise
+    GateKernel kernel;
+};
+
+/*
+
+    FUNCTION: gateTraits(type):
+                one constexpr table read, usable in static_assert and template arguments
+
+*/
+constexpr GateTraits gateTraits(GateType type) {
+    //                                  qubits param  ctrl   diag   perm   cliff  selfInv herm  sym    named  inverse  phase
+    switch (type) {
+    case GateType::Identity:
+        return { "I", 1, false, false, true, true, true, true, true, false, true, GateType::Identity, 0.0, GateKernel::Identity };
+    case GateType::PauliX:
+        return { "X", 1, false, false, false, true, true, true, true, false, true, GateType::PauliX, 0.0, GateKernel::AntiDiagonal };
+    case GateType::PauliY:
+        return { "Y", 1, false, false, false, true, true, true, true, false, true, GateType::PauliY, 0.0, GateKernel::AntiDiagonal };
+    case GateType::PauliZ:
+        return { "Z", 1, false, false, true, true, true, true, true, false, true, GateType::PauliZ, 3.14159265358979323846, GateKernel::Diagonal };
+    case GateType::Hadamard:
+        return { "H", 1, false, false, false, false, true, true, true, false, true, GateType::Hadamard, 0.0, GateKernel::Dense };
+    case GateType::S:
+        return { "S", 1, false, false, true, true, true, false, false, false, true, GateType::SDagger, 1.57079632679489661923, GateKernel::Diagonal };
+    case GateType::SDagger:
+        return { "Sdg", 1, false, false, true, true, true, false, false, false, true, GateType::S, -1.57079632679489661923, GateKernel::Diagonal };
+    case GateType::T:
+        return { "T", 1, false, false, true, true, false, false, false, false, true, GateType::TDagger, 0.78539816339744830962, GateKernel::Diagonal };
+    case GateType::TDagger:
+        return { "Tdg", 1, false, false, true, true, false, false, false, false, true, GateType::T, -0.78539816339744830962, GateKernel::Diagonal };
+    case GateType::SqrtX:
+        return { "SX", 1, false, false, false, false, true, false, false, false, false, GateType::SqrtX, 0.0, GateKernel::Dense };
+    case GateType::RotationX:
+        return { "RX", 1, true, false, false, false, false, false, false, false, true, GateType::RotationX, 0.0, GateKernel::Dense };
+    case GateType::RotationY:
+        return { "RY", 1, true, false, false, false, false, false, false, false, true, GateType::RotationY, 0.0, GateKernel::Dense };
+    case GateType::RotationZ:
+        return { "RZ", 1, true, false, true, true, false, false, false, false, true, GateType::RotationZ, 0.0, GateKernel::Diagonal };
+    case GateType::Phase:
+        return { "P", 1, true, false, true, true, false, false, false, false, true, GateType::Phase, 0.0, GateKernel::Diagonal };
+    case GateType::CNOT:
+        return { "CNOT", 2, false, true, false, true, true, true, true, false, true, GateType::CNOT, 0.0, GateKernel::Controlled };
+    case GateType::CZ:
+        return { "CZ", 2, false, true, true, true, true, true, true, true, true, GateType::CZ, 0.0, GateKernel::Controlled };
+    case GateType::ControlledPhase:
+        return { "CP", 2, true, true, true, true, false, false, false, true, true, GateType::ControlledPhase, 0.0, GateKernel::Controlled };
+    case GateType::Swap:
+    default:
+        return { "SWAP", 2, false, false, false, true, true, true, true, true, true, GateType::Swap, 0.0, GateKernel::Swap };
+    }
+}
+
+//tag types for compile time dispatch, GateKernelTag<GateType::S> selects the diagonal overload
+template <GateKernel Kernel>
+using KernelTag = std::integral_constant<GateKernel, Kernel>;
+
+template <GateType Type>
+using GateKernelTag = KernelTag<gateTraits(Type).kernel>;
+
+/*
+
+    FUNCTION: fixedGateMatrix(type) / fixedTwoQubitMatrix(type):
+                row major entries of the gates without an angle, the target part for CNOT and CZ
+                (as QuantumCircuit::gateMatrix) and the full 4x4 for the two qubit ones
+
+*/
+typedef std::array<std::complex<double>, 4> FixedGateMatrix;
+typedef std::array<std::complex<double>, 16> FixedTwoQubitMatrix;
+
+constexpr double GATE_INV_SQRT2 = 0.70710678118654752440;
+
+constexpr FixedGateMatrix fixedGateMatrix(GateType type) {
+    typedef std::complex<double> c;
+    switch (type) {
+    case GateType::PauliX:
+    case GateType::CNOT:
+        return { { c(0.0, 0.0), c(1.0, 0.0), c(1.0, 0.0), c(0.0, 0.0) } };
+    case GateType::PauliY:
+        return { { c(0.0, 0.0), c(0.0, -1.0), c(0.0, 1.0), c(0.0, 0.0) } };
+    case GateType::PauliZ:
+    case GateType::CZ:
+        return { { c(1.0, 0.0), c(0.0, 0.0), c(0.0, 0.0), c(-1.0, 0.0) } };
+    case GateType::Hadamard:
+        return { { c(GATE_INV_SQRT2, 0.0), c(GATE_INV_SQRT2, 0.0), c(GATE_INV_SQRT2, 0.0), c(-GATE_INV_SQRT2, 0.0) } };
+    case GateType::S:
+        return { { c(1.0, 0.0), c(0.0, 0.0), c(0.0, 0.0), c(0.0, 1.0) } };
+    case GateType::SDagger:
+        return { { c(1.0, 0.0), c(0.0, 0.0), c(0.0, 0.0), c(0.0, -1.0) } };
+    case GateType::T:
+        return { { c(1.0, 0.0), c(0.0, 0.0), c(0.0, 0.0), c(GATE_INV_SQRT2, GATE_INV_SQRT2) } };
+    case GateType::TDagger:
+        return { { c(1.0, 0.0), c(0.0, 0.0), c(0.0, 0.0), c(GATE_INV_SQRT2, -GATE_INV_SQRT2) } };
+    case GateType::SqrtX:
+        return { { c(0.5, 0.5), c(0.5, -0.5), c(0.5, -0.5), c(0.5, 0.5) } };
+    default:
+        return { { c(1.0, 0.0), c(0.0, 0.0), c(0.0, 0.0), c(1.0, 0.0) } };
+    }
+}
+
+constexpr FixedTwoQubitMatrix fixedTwoQubitMatrix(GateType type) {
+    typedef std::complex<double> c;
+    switch (type) {
+    case GateType::CNOT:
+        return { { c(1.0), c(0.0), c(0.0), c(0.0),   c(0.0), c(1.0), c(0.0), c(0.0),
+            c(0.0), c(0.0), c(0.0), c(1.0),   c(0.0), c(0.0), c(1.0), c(0.0) } };
+    case GateType::CZ:
+        return { { c(1.0), c(0.0), c(0.0), c(0.0),   c(0.0), c(1.0), c(0.0), c(0.0),
+            c(0.0), c(0.0), c(1.0), c(0.0),   c(0.0), c(0.0), c(0.0), c(-1.0) } };
+    case GateType::Swap:
+        return { { c(1.0), c(0.0), c(0.0), c(0.0),   c(0.0), c(0.0), c(1.0), c(0.0),
+            c(0.0), c(1.0), c(0.0), c(0.0),   c(0.0), c(0.0), c(0.0), c(1.0) } };
+    default:
+        return { { c(1.0), c(0.0), c(0.0), c(0.0),   c(0.0), c(1.0), c(0.0), c(0.0),
+            c(0.0), c(0.0), c(1.0), c(0.0),   c(0.0), c(0.0), c(0.0), c(1.0) } };
+    }
+}
+
+//the table is checked by the compiler
+static_assert(gateTraits(GateType::Hadamard).clifford && gateTraits(GateType::Hadamard).selfInverse, "H is a self inverse Clifford");
+static_assert(gateTraits(gateTraits(GateType::S).inverse).inverse == GateType::S, "S and S^dagger are inverse");
+static_assert(!gateTraits(GateType::T).clifford, "T is not a Clifford");
+static_assert(gateTraits(GateType::CZ).symmetric && !gateTraits(GateType::CNOT).symmetric, "CZ is symmetric, CNOT is not");
+static_assert(std::get<3>(fixedGateMatrix(GateType::S)).imag() == 1.0, "S = diag(1, i)");
+
+// Matrices as Eigen objects, fixed size so they stay on the stack
+inline Eigen::Matrix2cd toMatrix(const FixedGateMatrix& entries) {
+    Eigen::Matrix2cd result;
+    result << entries[0], entries[1], entries[2], entries[3];
+    return result;
+}
+
+inline Eigen::Matrix4cd toMatrix(const FixedTwoQubitMatrix& entries) {
+    return Eigen::Map<const Eigen::Matrix<std::complex<double>, 4, 4, Eigen::RowMajor>>(entries.data());
+}
+
+// Parameterized gates, RX(a) = exp(-i a X/2), RY(a) = exp(-i a Y/2), RZ(a) = exp(-i a Z/2), P(a) = diag(1, exp(i a))
+inline Eigen::Matrix2cd rotationX(double angle) {
+    const double c = std::cos(angle / 2.0);
+    const double s = std::sin(angle / 2.0);
+    Eigen::Matrix2cd result;
+    result << c, std::complex<double>(0.0, -s), std::complex<double>(0.0, -s), c;
+    return result;
+}
+
+inline Eigen::Matrix2cd rotationY(double angle) {
+    const double c = std::cos(angle / 2.0);
+    const double s = std::sin(angle / 2.0);
+    Eigen::Matrix2cd result;
+    result << c, -s, s, c;
+    return result;
+}
+
+inline Eigen::Matrix2cd rotationZ(double angle) {
+    Eigen::Matrix2cd result;
+    result << std::polar(1.0, -angle / 2.0), 0.0, 0.0, std::polar(1.0, angle / 2.0);
+    return result;
+}
+
+inline Eigen::Matrix2cd phaseShift(double angle) {
+    Eigen::Matrix2cd result;
+    result << 1.0, 0.0, 0.0, std::polar(1.0, angle);
+    return result;
+}
+
+//(d0, d1) of a diagonal gate, or of the target part of CZ and controlled phases
+inline std::array<std::complex<double>, 2> diagonalEntries(GateType type, double angle = 0.0) {
+    switch (type) {
+    case GateType::RotationZ:
+        return { { std::polar(1.0, -angle / 2.0), std::polar(1.0, angle / 2.0) } };
+    case GateType::Phase:
+    case GateType::ControlledPhase:
+        return { { std::complex<double>(1.0, 0.0), std::polar(1.0, angle) } };
+    default: {
+        const FixedGateMatrix entries = fixedGateMatrix(type);
+        return { { entries[0], entries[3] } };
+    }
+    }
+}
+
+#endif // GATE_LIBRARY_H
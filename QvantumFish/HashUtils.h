@@ -0,0 +1,31 @@
+#ifndef HASH_UTILS_H
+#define HASH_UTILS_H
+
+#include <cstdint>
+#include <cstring>
+
+/*
+
+    FNV-1a hashing shared by the caches of the simulation classes (Clifford lookup, unitary memo, synthesis
+    cache, prefix checkpoints). the keys are fed a 64 bit word at a time, the hashes only index tables of the
+    running process and every cache still compares the full key on a hit
+
+*/
+
+constexpr std::uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+constexpr std::uint64_t FNV_PRIME = 1099511628211ULL;
+
+//one FNV-1a step, negative integers go through their two's complement
+inline void hashWord(std::uint64_t& hash, std::uint64_t word) {
+    hash ^= word;
+    hash *= FNV_PRIME;
+}
+
+//bit pattern of a double, any change of the value (sign of zero included) is a different word
+inline std::uint64_t doubleBits(double value) {
+    std::uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+#endif // HASH_UTILS_H
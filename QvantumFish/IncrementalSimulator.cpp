@@ -0,0 +1,157 @@
+#include "IncrementalSimulator.h"
+#include "CompiledCircuit.h"
+#include "HashUtils.h"
+#include <algorithm>
+#include <stdexcept>
+
+/*
+
+    CONSTRUCTOR
+
+*/
+IncrementalSimulator::IncrementalSimulator(size_t memoryBudgetBytes, size_t minimumCheckpointInterval)
+    : memoryBudget(memoryBudgetBytes),
+    minimumInterval(std::max<size_t>(1, minimumCheckpointInterval)),
+    storedBytes(0),
+    useCounter(0),
+    state(1),
+    lastResumeLength(0),
+    lastAppliedGates(0) {
+}
+
+void IncrementalSimulator::clear() {
+    checkpoints.clear();
+    storedBytes = 0;
+}
+
+/*
+
+    FUNCTION: prefixHashes(numQubits, operations):
+                hash[k + 1] extends hash[k] with the fields of gate k, so all the prefixes cost one pass.
+                the angle enters through its bit pattern, any change of the value is a different program
+
+*/
+std::vector<std::uint64_t> IncrementalSimulator::prefixHashes(int numQubits, const std::vector<GateOperation>& operations) {
+    std::vector<std::uint64_t> hashes(operations.size() + 1);
+    std::uint64_t hash = FNV_OFFSET_BASIS;
+    hashWord(hash, static_cast<std::uint64_t>(numQubits));
+    hashes[0] = hash;
+
+    for (size_t k = 0; k < operations.size(); ++k) {
+        const GateOperation& operation = operations[k];
+        hashWord(hash, static_cast<std::uint64_t>(operation.type));
+        hashWord(hash, static_cast<std::uint64_t>(static_cast<std::int64_t>(operation.target)));
+        hashWord(hash, static_cast<std::uint64_t>(static_cast<std::int64_t>(operation.control)));
+        hashWord(hash, doubleBits(operation.angle));
+        hashes[k + 1] = hash;
+    }
+    return hashes;
+}
+
+/*
+
+    FUNCTION: simulate(numQubits, operations):
+                resume from the longest cached prefix (or from |0...0>) and mark every checkpoint of that prefix
+                as used, then run the rest in segments that end on multiples of the checkpoint interval and
+                checkpoint the state after each of them, the last one included so running an unchanged program
+                again is a single lookup. the interval is chosen so the checkpoints of this run fit in the budget
+
+*/
+const QuantumRegister& IncrementalSimulator::simulate(int numQubits, const std::vector<GateOperation>& operations) {
+    for (const GateOperation& operation : operations) {
+        if (operation.parameterIndex >= 0) {
+            throw std::invalid_argument("Incremental simulation needs constant angles");
+        }
+    }
+
+    const std::vector<std::uint64_t> hashes = prefixHashes(numQubits, operations);
+    const size_t gateCount = operations.size();
+
+    size_t position = 0;
+    for (size_t length = gateCount; length > 0; --length) {
+        auto found = checkpoints.find(hashes[length]);
+        //the length and the qubit count guard against a hash collision
+        if (found != checkpoints.end() && found->second.length == length && found->second.numQubits == numQubits) {
+            state.setState(found->second.state);
+            position = length;
+            break;
+        }
+    }
+    //the checkpoints before the resume point are on the path of this program as well, an edit before the
+    //resume point falls back on them, so they are all refreshed, the resume point last
+    for (size_t length = 1; length <= position; ++length) {
+        auto found = checkpoints.find(hashes[length]);
+        if (found != checkpoints.end() && found->second.length == length && found->second.numQubits == numQubits) {
+            found->second.lastUse = ++useCounter;
+        }
+    }
+    if (position == 0) {
+        if (state.getNumQubits() == numQubits) {
+            state.reset();
+        }
+        else {
+            state = QuantumRegister(numQubits);
+        }
+    }
+    lastResumeLength = position;
+    lastAppliedGates = gateCount - position;
+
+    const size_t stateBytes = state.getDimension() * sizeof(std::complex<double>);
+    const size_t capacity = memoryBudget / stateBytes;
+    const size_t remaining = gateCount - position;
+    const size_t interval = capacity == 0 ? std::max<size_t>(1, remaining)
+        : std::max(minimumInterval, (remaining + capacity - 1) / capacity);
+
+    while (position < gateCount) {
+        const size_t next = std::min(gateCount, (position / interval + 1) * interval);
+        runSegment(state, operations, position, next);
+        position = next;
+        if (capacity > 0 && checkpoints.find(hashes[position]) == checkpoints.end()) {
+            storeCheckpoint(hashes[position], position);
+        }
+    }
+    return state;
+}
+
+const QuantumRegister& IncrementalSimulator::simulate(const QuantumCircuit& circuit) {
+    return simulate(circuit.getNumQubits(), circuit.getOperations());
+}
+
+void IncrementalSimulator::runSegment(QuantumRegister& quantumRegister, const std::vector<GateOperation>& operations, size_t first, size_t last) {
+    QuantumCircuit segment(quantumRegister.getNumQubits());
+    for (size_t k = first; k < last; ++k) {
+        segment.addOperation(operations[k]);
+    }
+    CompiledCircuit(segment).execute(quantumRegister, {});
+}
+
+/*
+
+    FUNCTION: storeCheckpoint(hash, length) / evictLeastRecentlyUsed():
+                the budget is made room for before the copy, the eviction scans the checkpoints for the oldest
+                use (there are at most a few hundred of them)
+
+*/
+void IncrementalSimulator::storeCheckpoint(std::uint64_t hash, size_t length) {
+    const size_t bytes = state.getDimension() * sizeof(std::complex<double>);
+    while (!checkpoints.empty() && storedBytes + bytes > memoryBudget) {
+        evictLeastRecentlyUsed();
+    }
+    if (storedBytes + bytes > memoryBudget) {
+        return;
+    }
+
+    checkpoints[hash] = { length, state.getNumQubits(), state.getAmplitudes(), ++useCounter };
+    storedBytes += bytes;
+}
+
+void IncrementalSimulator::evictLeastRecentlyUsed() {
+    auto oldest = checkpoints.begin();
+    for (auto entry = checkpoints.begin(); entry != checkpoints.end(); ++entry) {
+        if (entry->second.lastUse < oldest->second.lastUse) {
+            oldest = entry;
+        }
+    }
+    storedBytes -= static_cast<size_t>(oldest->second.state.size()) * sizeof(std::complex<double>);
+    checkpoints.erase(oldest);
+}
@@ -0,0 +1,75 @@
+#ifndef INCREMENTAL_SIMULATOR_H
+#define INCREMENTAL_SIMULATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <Eigen/Dense>
+#include "QuantumCircuit.h"
+#include "QuantumRegister.h"
+
+//state after the first length gates of a program
+struct PrefixCheckpoint {
+    size_t length;
+    int numQubits;
+    Eigen::VectorXcd state;
+    std::uint64_t lastUse;
+};
+
+
+/*
+
+    IncrementalSimulator class
+
+    re-simulation of a program that is being edited. the hash of every prefix of the gate list is computed
+    incrementally (FNV-1a over the fields of each gate, seeded with the qubit count) and states are checkpointed
+    along the run under the hash of the prefix they follow. the next run looks for the longest prefix that still
+    has a checkpoint and only applies the gates after it, so an edit on gate k replays at most the gates from the
+    last checkpoint before k. the segments between checkpoints run through the compiled (fused) circuit.
+    checkpoints cost a full state each, they are spaced so a run stores at most what fits in the memory budget
+    and the least recently used ones are dropped first. comments and blank lines do not change the hashes.
+    not synchronized, a simulator belongs to one thread
+
+*/
+class IncrementalSimulator {
+private:
+    size_t memoryBudget;
+    size_t minimumInterval;
+    std::unordered_map<std::uint64_t, PrefixCheckpoint> checkpoints;
+    size_t storedBytes;
+    std::uint64_t useCounter;
+    QuantumRegister state;
+    size_t lastResumeLength;
+    size_t lastAppliedGates;
+
+    // Private helper methods
+    void storeCheckpoint(std::uint64_t hash, size_t length);
+    void evictLeastRecentlyUsed();
+    static void runSegment(QuantumRegister& quantumRegister, const std::vector<GateOperation>& operations, size_t first, size_t last);
+
+public:
+    // default budget of the checkpoints, 256 MiB
+    static constexpr size_t DEFAULT_MEMORY_BUDGET = static_cast<size_t>(256) << 20;
+    // checkpoints are never closer than this many gates
+    static constexpr size_t DEFAULT_MINIMUM_INTERVAL = 16;
+
+    // Constructor
+    IncrementalSimulator(size_t memoryBudgetBytes = DEFAULT_MEMORY_BUDGET, size_t minimumCheckpointInterval = DEFAULT_MINIMUM_INTERVAL);
+
+    // Getters
+    size_t getCheckpointCount() const { return checkpoints.size(); }
+    size_t getStoredBytes() const { return storedBytes; }
+    size_t getLastResumeLength() const { return lastResumeLength; }
+    size_t getLastAppliedGates() const { return lastAppliedGates; }
+    void clear();
+
+    //state of |0...0> after the gates, the reference stays valid until the next call. the angles must be constant
+    const QuantumRegister& simulate(int numQubits, const std::vector<GateOperation>& operations);
+    const QuantumRegister& simulate(const QuantumCircuit& circuit);
+
+    //hashes of the prefixes of every length, prefixHashes(...)[k] covers the first k gates
+    static std::vector<std::uint64_t> prefixHashes(int numQubits, const std::vector<GateOperation>& operations);
+};
+
+#endif // INCREMENTAL_SIMULATOR_H
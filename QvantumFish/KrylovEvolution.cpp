@@ -0,0 +1,244 @@
+#include "KrylovEvolution.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include <Eigen/Dense>
+#include <Eigen/SparseCore>
+#include "ParallelUtils.h"
+
+/*
+
+    CONSTRUCTORS
+
+    the operator is copied once into a shared object so the evolution does not depend
+    on the lifetime of the matrix or of the Pauli sum it was built from
+
+*/
+KrylovEvolution::KrylovEvolution(const Eigen::SparseMatrix<std::complex<double>>& hamiltonian)
+    : dimension(hamiltonian.rows()),
+    tolerance(DEFAULT_TOLERANCE),
+    maxKrylovDimension(DEFAULT_KRYLOV_DIMENSION),
+    lastStepCount(0),
+    lastProductCount(0) {
+
+    if (hamiltonian.rows() != hamiltonian.cols() || hamiltonian.rows() == 0) {
+        throw std::invalid_argument("Hamiltonian must be a non empty square matrix");
+    }
+    Eigen::SparseMatrix<std::complex<double>> adjoint = hamiltonian.adjoint();
+    if ((hamiltonian - adjoint).norm() > 1e-10 * std::max(1.0, hamiltonian.norm())) {
+        throw std::invalid_argument("Hamiltonian is not Hermitian");
+    }
+
+    auto matrix = std::make_shared<SparseHamiltonian>(hamiltonian);
+    matrix->makeCompressed();
+    multiply = [matrix](const Eigen::VectorXcd& input, Eigen::VectorXcd& output) {
+        multiplySparse(*matrix, input, output);
+    };
+}
+
+KrylovEvolution::KrylovEvolution(const PauliSum& hamiltonian)
+    : dimension(hamiltonian.getDimension()),
+    tolerance(DEFAULT_TOLERANCE),
+    maxKrylovDimension(DEFAULT_KRYLOV_DIMENSION),
+    lastStepCount(0),
+    lastProductCount(0) {
+
+    auto sum = std::make_shared<const PauliSum>(hamiltonian);
+    multiply = [sum](const Eigen::VectorXcd& input, Eigen::VectorXcd& output) {
+        sum->apply(input, output);
+    };
+}
+
+/*
+
+    FUNCTION: setTolerance(newTolerance) / setMaxKrylovDimension(newDimension):
+                tolerance is the error allowed on the whole evolution of a normalized state,
+                the Krylov dimension bounds the memory used, one state vector per basis vector
+
+*/
+void KrylovEvolution::setTolerance(double newTolerance) {
+    if (!(newTolerance > 0.0)) {
+        throw std::invalid_argument("Tolerance must be positive");
+    }
+    tolerance = newTolerance;
+}
+
+void KrylovEvolution::setMaxKrylovDimension(int newDimension) {
+    if (newDimension < 2) {
+        throw std::invalid_argument("Krylov dimension must be at least 2");
+    }
+    maxKrylovDimension = newDimension;
+}
+
+/*
+
+    FUNCTION: multiplySparse(matrix, input, output):
+                rows are independent so every worker owns a contiguous block of the output
+
+*/
+void KrylovEvolution::multiplySparse(const SparseHamiltonian& matrix, const Eigen::VectorXcd& input, Eigen::VectorXcd& output) {
+    if (input.size() != matrix.cols()) {
+        throw std::invalid_argument("State size does not match the Hamiltonian");
+    }
+    output.resize(matrix.rows());
+
+    parallelFor(0, static_cast<size_t>(matrix.rows()), static_cast<size_t>(1) << 12, [&](size_t begin, size_t end) {
+        for (size_t row = begin; row < end; ++row) {
+            std::complex<double> sum = 0.0;
+            for (SparseHamiltonian::InnerIterator it(matrix, static_cast<Eigen::Index>(row)); it; ++it) {
+                sum += it.value() * input(it.col());
+            }
+            output(static_cast<Eigen::Index>(row)) = sum;
+        }
+    });
+}
+
+/*
+
+    FUNCTION: evolve(state, time):
+                the Krylov space does not depend on tau, so each step builds the basis once and then
+                    - stops the Lanczos recursion early as soon as the error estimate for the proposed tau is met
+                    - otherwise shrinks tau on the same basis until the estimate is met, which costs no extra products
+                a vanishing residual means the space is invariant under H and the remaining time is done exactly.
+                the error estimate behaves like tau^m, which drives both the shrinking and the next proposal
+
+*/
+Eigen::VectorXcd KrylovEvolution::evolve(const Eigen::VectorXcd& state, double time) {
+    if (state.size() != dimension) {
+        throw std::invalid_argument("State size does not match the Hamiltonian");
+    }
+
+    lastStepCount = 0;
+    lastProductCount = 0;
+
+    Eigen::VectorXcd current = state;
+    const double totalTime = std::abs(time);
+    const double direction = time < 0.0 ? -1.0 : 1.0;
+    if (totalTime == 0.0) {
+        return current;
+    }
+
+    std::vector<Eigen::VectorXcd> basis;
+    basis.reserve(maxKrylovDimension);
+    Eigen::VectorXcd product(dimension);
+    std::vector<double> alpha;
+    std::vector<double> beta;
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> solver;
+
+    double remaining = totalTime;
+    double tau = totalTime;
+
+    while (remaining > 0.0) {
+        const double norm = current.norm();
+        if (norm == 0.0) {
+            return current;
+        }
+        tau = std::min(tau, remaining);
+
+        //small exponential exp(-i tau T) e_1 in the eigenbasis of T
+        auto smallExponential = [&](double stepTime) {
+            const Eigen::VectorXd& energies = solver.eigenvalues();
+            const Eigen::MatrixXd& vectors = solver.eigenvectors();
+            Eigen::VectorXcd weights(energies.size());
+            for (Eigen::Index k = 0; k < energies.size(); ++k) {
+                weights(k) = vectors(0, k) * std::polar(1.0, -direction * energies(k) * stepTime);
+            }
+            return Eigen::VectorXcd(vectors.cast<std::complex<double>>() * weights);
+        };
+
+        double residual = 0.0;
+        bool invariant = false;
+        alpha.clear();
+        beta.clear();
+        if (basis.empty()) {
+            basis.emplace_back(dimension);
+        }
+        basis[0] = current / norm;
+
+        auto errorFor = [&](double stepTime) {
+            Eigen::VectorXcd coefficients = smallExponential(stepTime);
+            return norm * residual * std::abs(coefficients(coefficients.size() - 1));
+        };
+        auto allowedFor = [&](double stepTime) {
+            return tolerance * norm * stepTime / totalTime;
+        };
+
+        for (int j = 0; j < maxKrylovDimension; ++j) {
+            multiply(basis[j], product);
+            ++lastProductCount;
+
+            double a = basis[j].dot(product).real();
+            product -= a * basis[j];
+            if (j > 0) {
+                product -= beta[j - 1] * basis[j - 1];
+            }
+            //second pass against the last two vectors only, this keeps the three term recurrence clean
+            //without the O(m) full reorthogonalization, the basis is rebuilt every step so drift cannot build up
+            for (int k = std::max(0, j - 1); k <= j; ++k) {
+                product -= basis[k].dot(product) * basis[k];
+            }
+            alpha.push_back(a);
+            residual = product.norm();
+
+            Eigen::Map<const Eigen::VectorXd> diagonal(alpha.data(), j + 1);
+            Eigen::Map<const Eigen::VectorXd> subdiagonal(beta.data(), j);
+            solver.computeFromTridiagonal(diagonal, subdiagonal, Eigen::ComputeEigenvectors);
+
+            double scale = std::abs(a) + (j > 0 ? beta[j - 1] : 0.0);
+            if (residual <= 1e-13 * std::max(scale, 1.0)) {
+                invariant = true;
+                break;
+            }
+            if (j + 1 == maxKrylovDimension || errorFor(tau) <= allowedFor(tau)) {
+                break;
+            }
+
+            beta.push_back(residual);
+            if (static_cast<int>(basis.size()) < j + 2) {
+                basis.emplace_back(dimension);
+            }
+            basis[j + 1] = product / residual;
+        }
+
+        const int size = static_cast<int>(alpha.size());
+        double growth = 2.0;
+        if (invariant) {
+            tau = remaining;
+        }
+        else {
+            double error = errorFor(tau);
+            while (error > allowedFor(tau)) {
+                tau *= std::max(0.2, 0.9 * std::pow(allowedFor(tau) / error, 1.0 / size));
+                error = errorFor(tau);
+            }
+            if (error > 0.0) {
+                growth = std::min(2.0, std::max(1.0, 0.9 * std::pow(allowedFor(tau) / error, 1.0 / size)));
+            }
+        }
+
+        Eigen::VectorXcd coefficients = smallExponential(tau);
+        current.setZero();
+        for (int k = 0; k < size; ++k) {
+            current += (norm * coefficients(k)) * basis[k];
+        }
+
+        ++lastStepCount;
+        remaining -= tau;
+        if (remaining <= 1e-14 * totalTime) {
+            break;
+        }
+        tau *= growth;
+    }
+
+    return current;
+}
+
+void KrylovEvolution::evolve(QuantumRegister& quantumRegister, double time) {
+    if (static_cast<Eigen::Index>(quantumRegister.getDimension()) != dimension) {
+        throw std::invalid_argument("Register size does not match the Hamiltonian");
+    }
+    quantumRegister.getAmplitudes() = evolve(quantumRegister.getAmplitudes(), time);
+}
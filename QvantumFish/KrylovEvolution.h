@@ -0,0 +1,67 @@
+#ifndef KRYLOV_EVOLUTION_H
+#define KRYLOV_EVOLUTION_H
+
+#include <complex>
+#include <functional>
+#include <Eigen/Dense>
+#include <Eigen/SparseCore>
+#include "PauliSum.h"
+#include "QuantumRegister.h"
+
+
+/*
+
+    KrylovEvolution class
+
+    exp(-iHt)|psi> for Hamiltonians too large to diagonalize, H is only used through H|v>.
+    every step builds the Lanczos basis V_m of span{v, Hv, ..., H^(m-1) v} and the tridiagonal T_m = V_m^dagger H V_m,
+    then
+                        exp(-iH tau)|v> ~ |v| V_m exp(-i tau T_m) e_1
+
+    the small exponential comes from the eigendecomposition of T_m, the step tau is chosen so that the
+    a posteriori error estimate |v| beta_m |[exp(-i tau T_m) e_1]_m| stays below tolerance * tau / t
+
+*/
+class KrylovEvolution {
+public:
+    using SparseHamiltonian = Eigen::SparseMatrix<std::complex<double>, Eigen::RowMajor>;
+
+private:
+    Eigen::Index dimension;
+    std::function<void(const Eigen::VectorXcd&, Eigen::VectorXcd&)> multiply;
+
+    double tolerance;
+    int maxKrylovDimension;
+
+    // statistics of the last evolve call
+    int lastStepCount;
+    int lastProductCount;
+
+public:
+    static constexpr double DEFAULT_TOLERANCE = 1e-10;
+    static constexpr int DEFAULT_KRYLOV_DIMENSION = 30;
+
+    // Constructors, the sparse matrix must be Hermitian
+    KrylovEvolution(const Eigen::SparseMatrix<std::complex<double>>& hamiltonian);
+    KrylovEvolution(const PauliSum& hamiltonian);
+
+    // Getters
+    Eigen::Index getDimension() const { return dimension; }
+    double getTolerance() const { return tolerance; }
+    int getMaxKrylovDimension() const { return maxKrylovDimension; }
+    int getLastStepCount() const { return lastStepCount; }
+    int getLastProductCount() const { return lastProductCount; }
+
+    // Setters
+    void setTolerance(double newTolerance);
+    void setMaxKrylovDimension(int newDimension);
+
+    // Evolution, negative times evolve backwards
+    Eigen::VectorXcd evolve(const Eigen::VectorXcd& state, double time);
+    void evolve(QuantumRegister& quantumRegister, double time);
+
+    //multithreaded row by row product of a row major sparse matrix
+    static void multiplySparse(const SparseHamiltonian& matrix, const Eigen::VectorXcd& input, Eigen::VectorXcd& output);
+};
+
+#endif // KRYLOV_EVOLUTION_H
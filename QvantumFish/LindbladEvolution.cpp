@@ -0,0 +1,56 @@
+#include "LindbladEvolution.h"
+#include <cmath>
+#include <stdexcept>
+#include <Eigen/Dense>
+
+/*
+
+    CONSTRUCTOR
+
+    complete positivity requires T2 <= 2 T1, pure dephasing can only shorten the coherence time
+
+*/
+LindbladEvolution::LindbladEvolution(double t1, double t2, double detuningFrequency, double steadyStateZ)
+    : relaxationTime(t1), dephasingTime(t2), detuning(detuningFrequency), equilibriumZ(steadyStateZ) {
+
+    if (!(t1 > 0.0) || !(t2 > 0.0)) {
+        throw std::invalid_argument("T1 and T2 must be positive");
+    }
+    if (t2 > 2.0 * t1 * (1.0 + 1e-12)) {
+        throw std::invalid_argument("T2 cannot exceed 2 T1");
+    }
+    if (std::abs(steadyStateZ) > 1.0) {
+        throw std::invalid_argument("Steady state must lie inside the Bloch sphere");
+    }
+}
+
+double LindbladEvolution::pureDephasingRate() const {
+    return 1.0 / dephasingTime - 0.5 / relaxationTime;
+}
+
+/*
+
+    FUNCTION: evolve(blochVector, time):
+                the transverse part rotates by Delta t and shrinks with T2, the longitudinal part relaxes
+                towards z_eq with T1, negative times are not allowed since the decay is not invertible
+
+*/
+Eigen::Vector3d LindbladEvolution::evolve(const Eigen::Vector3d& blochVector, double time) const {
+    if (time < 0.0) {
+        throw std::invalid_argument("Dissipative evolution cannot run backwards in time");
+    }
+
+    const double transverseDecay = std::exp(-time / dephasingTime);
+    const double longitudinalDecay = std::exp(-time / relaxationTime);
+    const double c = std::cos(detuning * time);
+    const double s = std::sin(detuning * time);
+
+    return Eigen::Vector3d(
+        transverseDecay * (c * blochVector.x() - s * blochVector.y()),
+        transverseDecay * (s * blochVector.x() + c * blochVector.y()),
+        equilibriumZ + (blochVector.z() - equilibriumZ) * longitudinalDecay);
+}
+
+MixedQubit LindbladEvolution::evolve(const MixedQubit& state, double time) const {
+    return MixedQubit(evolve(state.getBlochVector(), time));
+}
@@ -0,0 +1,58 @@
+#ifndef LINDBLAD_EVOLUTION_H
+#define LINDBLAD_EVOLUTION_H
+
+#include <limits>
+#include <Eigen/Dense>
+#include "MixedQubit.h"
+
+
+/*
+
+    LindbladEvolution class
+
+    single qubit under free precession, energy relaxation (T1) and dephasing (T2), the master equation
+
+            d rho/dt = -i[H, rho] + g1 D[sigma_-] rho + (gphi / 2) D[Z] rho,     H = (Delta / 2) Z
+
+    with g1 = 1/T1 and gphi = 1/T2 - 1/(2 T1) has the closed form solution on the Bloch vector
+
+            x(t) + i y(t) = (x0 + i y0) exp(i Delta t) exp(-t / T2)
+            z(t)          = z_eq + (z0 - z_eq) exp(-t / T1)
+
+    so any time point is evaluated in O(1) without integrating anything
+
+*/
+class LindbladEvolution {
+private:
+    double relaxationTime;      // T1
+    double dephasingTime;       // T2 <= 2 T1
+    double detuning;            // precession frequency around z
+    double equilibriumZ;        // z of the steady state, 1 is the ground state |0>
+
+    MixedQubit initialState;
+
+public:
+    static constexpr double NO_DECAY = std::numeric_limits<double>::infinity();
+
+    // Constructor, an infinite time switches that channel off
+    LindbladEvolution(double t1 = NO_DECAY, double t2 = NO_DECAY, double detuningFrequency = 0.0, double steadyStateZ = 1.0);
+
+    // Getters
+    double getRelaxationTime() const { return relaxationTime; }
+    double getDephasingTime() const { return dephasingTime; }
+    double getDetuning() const { return detuning; }
+    double getEquilibriumZ() const { return equilibriumZ; }
+    double pureDephasingRate() const;      // 1/T2 - 1/(2 T1)
+
+    // Evolution of any state
+    Eigen::Vector3d evolve(const Eigen::Vector3d& blochVector, double time) const;
+    MixedQubit evolve(const MixedQubit& state, double time) const;
+
+    // Evolution of a stored initial state, meant to be sampled once per frame
+    void setInitialState(const MixedQubit& state) { initialState = state; }
+    const MixedQubit& getInitialState() const { return initialState; }
+    Eigen::Vector3d blochVectorAt(double time) const { return evolve(initialState.getBlochVector(), time); }
+    MixedQubit stateAt(double time) const { return evolve(initialState, time); }
+};
+
+#endif // LINDBLAD_EVOLUTION_H
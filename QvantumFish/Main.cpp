@@ -11,6 +11,10 @@
 #include <complex>
 #include <thread>
 #include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
 #include <Eigen/Dense>
 #include <ImGui/imgui.h>
 #include <ImGui/imgui_impl_glfw.h>
@@ -29,6 +33,8 @@
 #include "BottomRightQuadrant.h"
 #include "SplashScreen.h"
 #include "DivisionLines.h"
+#include "SimulationWorker.h"
+#include "ProgramParser.h"
 
 // Global variables
 TopRightQuadrant* topRightQuadrant = nullptr;
@@ -36,6 +42,7 @@ TopLeftQuadrant* topLeftQuadrant = nullptr;
 BottomLeftQuadrant* bottomLeftQuadrant = nullptr;
 BottomRightQuadrant* bottomRightQuadrant = nullptr;
 SceneController* sceneController = nullptr;
+SimulationWorker* simulationWorker = nullptr;
 DivisionLines divisionLines;
 
 // Background quad shader and buffers
@@ -62,6 +69,16 @@ static int lastSelectedState = 0;
 static float lastCustomTheta = 45.0f;
 static float lastCustomPhi = 90.0f;
 
+// Last snapshot of the simulation thread shown by the quadrants
+static std::uint64_t shownSnapshot = 0;
+
+// Revision of the editor text that was last parsed
+static size_t parsedRevision = 0;
+
+// Request of the editor program whose outcome the status line waits for, 0 when none
+static std::uint64_t programSequence = 0;
+static std::string programSummary;
+
 static void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
     windowWidth = width;
     windowHeight = height;
@@ -380,6 +397,9 @@ static void initializeScene() {
     // Connect the bottom right quadrant to the top right quadrant's qubit
     bottomRightQuadrant->setQubit(&topRightQuadrant->getCurrentQubit());
 
+    // Simulation runs on its own thread, the render loop only reads its snapshots
+    simulationWorker = new SimulationWorker();
+
     // Initialize division lines using the new class
     if (!divisionLines.initialize()) {
         std::cerr << "Failed to initialize division lines" << std::endl;
@@ -393,6 +413,7 @@ static void initializeScene() {
 }
 
 static void cleanupScene() {
+    delete simulationWorker;
     delete topRightQuadrant;
     delete topLeftQuadrant;
     delete bottomLeftQuadrant;
@@ -525,29 +546,31 @@ static void renderTopRightQuadrant(float time) {
     topRightQuadrant->renderSettingsIcon(time, viewportX, viewportY, viewportWidth, viewportHeight);
 }
 
+//the state goes to the simulation thread, the quadrants are updated once its snapshot is published
+static void submitQubitState(const Qubit& qubit) {
+    SimulationRequest request;
+    request.initialState = qubit.getStateVector();
+    simulationWorker->submit(std::move(request));
+}
+
 static void handleQubitStateChanges() {
-    if (!topRightQuadrant || !bottomRightQuadrant) return;
+    if (!simulationWorker || !bottomRightQuadrant) return;
 
     // Check if state selection changed
     int currentSelectedState = bottomRightQuadrant->getSelectedState();
 
     if (currentSelectedState != lastSelectedState) {
-        Qubit newQubit = Qubit::ketZero();
         switch (currentSelectedState) {
-        case 0: newQubit = Qubit::ketZero(); break;
-        case 1: newQubit = Qubit::ketOne(); break;
-        case 2: newQubit = Qubit::ketPlus(); break;
-        case 3: newQubit = Qubit::ketMinus(); break;
-        case 4: newQubit = Qubit::ketPlusI(); break;
-        case 5: newQubit = Qubit::ketMinusI(); break;
+        case 0: submitQubitState(Qubit::ketZero()); break;
+        case 1: submitQubitState(Qubit::ketOne()); break;
+        case 2: submitQubitState(Qubit::ketPlus()); break;
+        case 3: submitQubitState(Qubit::ketMinus()); break;
+        case 4: submitQubitState(Qubit::ketPlusI()); break;
+        case 5: submitQubitState(Qubit::ketMinusI()); break;
         case 6:
             // Custom state - handled by parameter changes
             break;
         }
-        if (currentSelectedState != 6) {
-            topRightQuadrant->updateQubitState(newQubit);
-            bottomRightQuadrant->setQubit(&topRightQuadrant->getCurrentQubit());
-        }
         lastSelectedState = currentSelectedState;
     }
 
@@ -559,9 +582,7 @@ static void handleQubitStateChanges() {
         if (currentTheta != lastCustomTheta || currentPhi != lastCustomPhi) {
             double theta_rad = currentTheta * M_PI / 180.0;
             double phi_rad = currentPhi * M_PI / 180.0;
-            Qubit customQubit(std::cos(theta_rad / 2.0), std::exp(std::complex<double>(0, phi_rad)) * std::sin(theta_rad / 2.0));
-            topRightQuadrant->updateQubitState(customQubit);
-            bottomRightQuadrant->setQubit(&topRightQuadrant->getCurrentQubit());
+            submitQubitState(Qubit(std::cos(theta_rad / 2.0), std::exp(std::complex<double>(0, phi_rad)) * std::sin(theta_rad / 2.0)));
 
             lastCustomTheta = currentTheta;
             lastCustomPhi = currentPhi;
@@ -569,6 +590,79 @@ static void handleQubitStateChanges() {
     }
 }
 
+//the editor program is parsed again after every edit, a valid one is simulated from its longest unchanged prefix
+static void handleProgramChanges() {
+    if (!simulationWorker || !topLeftQuadrant) return;
+    if (topLeftQuadrant->getTextRevision() == parsedRevision) return;
+    parsedRevision = topLeftQuadrant->getTextRevision();
+
+    const ParsedProgram program = ProgramParser::parse(topLeftQuadrant->getTextLines());
+    programSequence = 0;
+    if (!program.isValid()) {
+        topLeftQuadrant->setProgramStatus("Ln " + std::to_string(program.errorLine + 1) + ": " + program.error, true);
+        return;
+    }
+    if (program.operations.empty()) {
+        topLeftQuadrant->setProgramStatus("", false);
+        return;
+    }
+
+    //the status only reports success once the snapshot of this request is back
+    programSummary = std::to_string(program.numQubits) + " qubits, " + std::to_string(program.operations.size()) + " gates";
+    topLeftQuadrant->setProgramStatus(programSummary + ", simulating...", false);
+    SimulationRequest request;
+    request.circuit = std::make_shared<QuantumCircuit>(program.toCircuit());
+    request.source = SimulationSource::Program;
+    programSequence = simulationWorker->submit(std::move(request));
+}
+
+//the outcome of the editor program goes to its status line, a snapshot of the qubit panel published right
+//after it can hide it, the status then keeps the summary without the timing
+static void reportProgramOutcome(const DisplaySnapshot& snapshot) {
+    if (programSequence == 0 || snapshot.sequence < programSequence) return;
+
+    if (snapshot.sequence != programSequence) {
+        topLeftQuadrant->setProgramStatus(programSummary, false);
+    }
+    else if (snapshot.failed) {
+        topLeftQuadrant->setProgramStatus("Simulation failed: " + snapshot.error, true);
+    }
+    else {
+        const int milliseconds = static_cast<int>(snapshot.simulationSeconds * 1000.0 + 0.5);
+        topLeftQuadrant->setProgramStatus(programSummary + ", " + std::to_string(milliseconds) + " ms", false);
+    }
+    programSequence = 0;
+}
+
+//never waits: without a new snapshot the quadrants keep showing the previous one
+static void applySimulationSnapshot() {
+    if (!simulationWorker || !topRightQuadrant || !bottomRightQuadrant || !topLeftQuadrant) return;
+
+    const DisplaySnapshot& snapshot = simulationWorker->latestSnapshot();
+    if (snapshot.sequence == shownSnapshot) return;
+    shownSnapshot = snapshot.sequence;
+    reportProgramOutcome(snapshot);
+
+    if (snapshot.failed) {
+        std::cerr << "Simulation request " << snapshot.sequence << " failed: " << snapshot.error << std::endl;
+        return;
+    }
+
+    if (snapshot.numQubits == 1) {
+        //the simulated state drifts from unit norm by rounding, the Qubit constructor would throw on it
+        const double norm = snapshot.amplitudes.norm();
+        if (!(norm > 0.0)) {
+            std::cerr << "Simulation request " << snapshot.sequence << " produced a null state" << std::endl;
+            return;
+        }
+        topRightQuadrant->updateQubitState(Qubit(snapshot.amplitudes(0) / norm, snapshot.amplitudes(1) / norm));
+        bottomRightQuadrant->setQubit(&topRightQuadrant->getCurrentQubit());
+    }
+    else {
+        topRightQuadrant->updateRegisterState(snapshot.blochVectors);
+    }
+}
+
 int main() {
     // Initialize GLFW
     if (!glfwInit()) {
@@ -658,6 +752,12 @@ int main() {
             // Handle qubit state changes from bottom right quadrant controls
             handleQubitStateChanges();
 
+            // Simulate the editor program when its text changed
+            handleProgramChanges();
+
+            // Show the latest finished simulation, the simulation thread keeps working in the background
+            applySimulationSnapshot();
+
             // Clear the entire window with black background ONCE at the beginning
             glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -0,0 +1,92 @@
+#include "MixedQubit.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <Eigen/Dense>
+
+/*
+
+    CONSTRUCTORS
+
+*/
+MixedQubit::MixedQubit() : blochVector(0.0, 0.0, 1.0) {
+}
+
+MixedQubit::MixedQubit(const Eigen::Vector3d& bloch) : blochVector(bloch) {
+    if (bloch.norm() > 1.0 + 1e-10) {
+        throw std::invalid_argument("Bloch vector longer than one is not a physical state");
+    }
+}
+
+MixedQubit::MixedQubit(const Qubit& pureState) {
+    std::complex<double> coherence = std::conj(pureState.getAlpha()) * pureState.getBeta();
+    blochVector = Eigen::Vector3d(2.0 * coherence.real(), 2.0 * coherence.imag(),
+        std::norm(pureState.getAlpha()) - std::norm(pureState.getBeta()));
+}
+
+/*
+
+    FUNCTION: fromDensityMatrix(densityMatrix):
+                r = (tr(rho X), tr(rho Y), tr(rho Z)) = (2 Re(rho10), 2 Im(rho10), rho00 - rho11)
+
+*/
+MixedQubit MixedQubit::fromDensityMatrix(const Eigen::Matrix2cd& densityMatrix) {
+    if (!densityMatrix.isApprox(densityMatrix.adjoint(), 1e-10)) {
+        throw std::invalid_argument("Density matrix is not Hermitian");
+    }
+    if (std::abs(densityMatrix.trace() - 1.0) > 1e-10) {
+        throw std::invalid_argument("Density matrix does not have unit trace");
+    }
+    std::complex<double> coherence = densityMatrix(1, 0);
+    return MixedQubit(Eigen::Vector3d(2.0 * coherence.real(), 2.0 * coherence.imag(),
+        (densityMatrix(0, 0) - densityMatrix(1, 1)).real()));
+}
+
+MixedQubit MixedQubit::maximallyMixed() {
+    return MixedQubit(Eigen::Vector3d::Zero());
+}
+
+Eigen::Matrix2cd MixedQubit::getDensityMatrix() const {
+    Eigen::Matrix2cd rho;
+    rho << (1.0 + blochVector.z()) / 2.0, std::complex<double>(blochVector.x(), -blochVector.y()) / 2.0,
+        std::complex<double>(blochVector.x(), blochVector.y()) / 2.0, (1.0 - blochVector.z()) / 2.0;
+    return rho;
+}
+
+/*
+
+    FUNCTION: purity() / vonNeumannEntropy() / isPure(tolerance):
+                the eigenvalues of rho are (1 +- |r|) / 2, so every property only needs the length of r
+
+*/
+double MixedQubit::purity() const {
+    return (1.0 + blochVector.squaredNorm()) / 2.0;
+}
+
+double MixedQubit::vonNeumannEntropy() const {
+    double length = std::min(blochVector.norm(), 1.0);
+    double entropy = 0.0;
+    for (double eigenvalue : { (1.0 + length) / 2.0, (1.0 - length) / 2.0 }) {
+        if (eigenvalue > 1e-15) {
+            entropy -= eigenvalue * std::log2(eigenvalue);
+        }
+    }
+    return entropy;
+}
+
+bool MixedQubit::isPure(double tolerance) const {
+    return std::abs(blochVector.norm() - 1.0) < tolerance;
+}
+
+double MixedQubit::probabilityZero() const {
+    return (1.0 + blochVector.z()) / 2.0;
+}
+
+double MixedQubit::probabilityOne() const {
+    return (1.0 - blochVector.z()) / 2.0;
+}
+
+double MixedQubit::fidelity(const Qubit& pureState) const {
+    return (1.0 + blochVector.dot(MixedQubit(pureState).getBlochVector())) / 2.0;
+}
@@ -0,0 +1,46 @@
+#ifndef MIXED_QUBIT_H
+#define MIXED_QUBIT_H
+
+#include <Eigen/Dense>
+#include "Qubit.h"
+
+
+/*
+
+    MixedQubit class
+
+    single qubit density matrix stored through its Bloch vector
+
+                        rho = (I + x X + y Y + z Z) / 2,        |r| <= 1
+
+    pure states sit on the sphere, mixed states inside and the maximally mixed state at the center
+
+*/
+class MixedQubit {
+private:
+    Eigen::Vector3d blochVector;
+
+public:
+    // Constructors, the default state is |0>
+    MixedQubit();
+    MixedQubit(const Eigen::Vector3d& bloch);
+    MixedQubit(const Qubit& pureState);
+
+    //rho must be Hermitian, positive and of unit trace
+    static MixedQubit fromDensityMatrix(const Eigen::Matrix2cd& densityMatrix);
+    static MixedQubit maximallyMixed();
+
+    // Getters
+    const Eigen::Vector3d& getBlochVector() const { return blochVector; }
+    Eigen::Matrix2cd getDensityMatrix() const;
+
+    // Properties of the state
+    double purity() const;                  // tr(rho^2) = (1 + |r|^2) / 2
+    double vonNeumannEntropy() const;       // in bits
+    bool isPure(double tolerance = 1e-10) const;
+    double probabilityZero() const;
+    double probabilityOne() const;
+    double fidelity(const Qubit& pureState) const;     // <psi|rho|psi>
+};
+
+#endif // MIXED_QUBIT_H
@@ -0,0 +1,101 @@
+#ifndef PARALLEL_UTILS_H
+#define PARALLEL_UTILS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "TaskScheduler.h"
+
+/*
+
+    Parallel helpers shared by the simulation classes, the loops run on the process wide TaskScheduler
+
+*/
+
+//number of workers we are going to use for parallel loops (at least one)
+inline unsigned int parallelWorkerCount() {
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads == 0 ? 1 : hardwareThreads;
+}
+
+//true while the current thread is already running inside a parallel region,
+//nested loops then run inline instead of spawning more threads
+inline bool& insideParallelRegion() {
+    thread_local bool inside = false;
+    return inside;
+}
+
+/*
+
+    FUNCTION: parallelFor(begin, end, minChunk, body):
+                split the range [begin, end) in contiguous chunks of at least minChunk elements and call
+                body(chunkBegin, chunkEnd) on each of them. the chunks are tasks of the shared TaskScheduler with the
+                priority and cancellation token of the calling thread, a few per worker so that interactive work can
+                take over the cores between two chunks of a batch loop. the calling thread runs the first chunk and then
+                helps with the pending tasks. small ranges and nested calls run on the calling thread.
+                every call is a cancellation point: TaskCancelled is thrown when the token of the caller is cancelled,
+                before the loop starts or once its chunks returned. the first exception thrown by a chunk is rethrown
+                on the calling thread once every chunk finished
+
+*/
+constexpr size_t PARALLEL_CHUNKS_PER_WORKER = 4;
+
+template <typename Function>
+void parallelFor(size_t begin, size_t end, size_t minChunk, Function&& body) {
+    const TaskContext context = currentTaskContext();
+    context.token.throwIfCancelled();
+    if (end <= begin) {
+        return;
+    }
+
+    size_t total = end - begin;
+    size_t chunks = std::min<size_t>(parallelWorkerCount() * PARALLEL_CHUNKS_PER_WORKER, std::max<size_t>(1, total / std::max<size_t>(1, minChunk)));
+
+    if (parallelWorkerCount() <= 1 || chunks <= 1 || insideParallelRegion()) {
+        body(begin, end);
+        return;
+    }
+
+    size_t chunk = (total + chunks - 1) / chunks;
+    chunks = (total + chunk - 1) / chunk;
+    std::shared_ptr<TaskGroup> group = std::make_shared<TaskGroup>(chunks);
+
+    //a chunk runs as a parallel region so that loops nested in the body stay inline, submitted tasks are not marked
+    auto runChunk = [begin, end, chunk, group, &body](size_t index) {
+        const bool previous = insideParallelRegion();
+        insideParallelRegion() = true;
+        std::exception_ptr error;
+        try {
+            //chunks of a cancelled loop are skipped, the caller throws once the group is done
+            if (!currentTaskContext().token.isCancelled()) {
+                size_t chunkBegin = begin + index * chunk;
+                body(chunkBegin, std::min(end, chunkBegin + chunk));
+            }
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+        insideParallelRegion() = previous;
+        group->finish(error);
+    };
+
+    TaskScheduler& scheduler = TaskScheduler::instance();
+    for (size_t index = 1; index < chunks; ++index) {
+        ScheduledTask task;
+        task.work = [runChunk, index]() { runChunk(index); };
+        task.context = context;
+        scheduler.push(std::move(task));
+    }
+
+    //the calling thread takes the first chunk
+    runChunk(0);
+
+    group->wait(context.priority);
+    context.token.throwIfCancelled();
+}
+
+#endif // PARALLEL_UTILS_H
@@ -0,0 +1,114 @@
+#include "ParameterSweep.h"
+#include <stdexcept>
+#include "ParallelUtils.h"
+
+/*
+
+    CONSTRUCTOR
+
+*/
+ParameterSweep::ParameterSweep(const CompiledCircuit& compiledCircuit) : circuit(compiledCircuit) {
+}
+
+/*
+
+    OBSERVABLES
+
+*/
+void ParameterSweep::addObservable(const std::string& name, const std::function<double(const QuantumRegister&)>& evaluate) {
+    observables.push_back({ name, evaluate });
+}
+
+void ParameterSweep::addExpectationZ(int qubit) {
+    addObservable("Z" + std::to_string(qubit), [qubit](const QuantumRegister& quantumRegister) {
+        return quantumRegister.expectationZ(qubit);
+    });
+}
+
+void ParameterSweep::addProbabilityOne(int qubit) {
+    addObservable("P1_" + std::to_string(qubit), [qubit](const QuantumRegister& quantumRegister) {
+        return quantumRegister.probabilityOne(qubit);
+    });
+}
+
+/*
+
+    FUNCTION: buildGrid(axes):
+                cartesian product of the values of every parameter, the last parameter changes fastest
+
+*/
+std::vector<std::vector<double>> ParameterSweep::buildGrid(const std::vector<std::vector<double>>& axes) {
+    size_t total = axes.empty() ? 0 : 1;
+    for (const std::vector<double>& axis : axes) {
+        total *= axis.size();
+    }
+
+    std::vector<std::vector<double>> bindings(total, std::vector<double>(axes.size()));
+    for (size_t row = 0; row < total; ++row) {
+        size_t remainder = row;
+        for (size_t parameter = axes.size(); parameter-- > 0;) {
+            bindings[row][parameter] = axes[parameter][remainder % axes[parameter].size()];
+            remainder /= axes[parameter].size();
+        }
+    }
+    return bindings;
+}
+
+/*
+
+    FUNCTION: run(bindings, sink):
+                the rows are split in a few chunks per worker, every chunk allocates its register once and runs
+                its rows serially to avoid oversubscribing the cores. each finished row is written straight into its
+                slot of the columnar table and handed to the sink, so results stream out while the other chunks are
+                still running, and the chunk boundaries let interactive work take the cores back in the middle of a
+                long sweep
+
+*/
+SweepResultTable ParameterSweep::run(const std::vector<std::vector<double>>& bindings, const SweepRowSink& sink) const {
+    const size_t parameterCount = static_cast<size_t>(circuit.getNumParameters());
+    for (const std::vector<double>& binding : bindings) {
+        if (binding.size() < parameterCount) {
+            throw std::invalid_argument("Sweep binding has fewer values than the circuit parameters");
+        }
+    }
+
+    std::vector<std::string> names;
+    for (size_t parameter = 0; parameter < parameterCount; ++parameter) {
+        names.push_back("p" + std::to_string(parameter));
+    }
+    for (const SweepObservable& observable : observables) {
+        names.push_back(observable.name);
+    }
+
+    SweepResultTable table(names, bindings.size());
+    if (bindings.empty()) {
+        return table;
+    }
+
+    //a chunk never holds fewer rows than this, smaller ones would spend more on the register than on the rows
+    const size_t minimumRows = 16;
+
+    parallelFor(0, bindings.size(), minimumRows, [&](size_t begin, size_t end) {
+        QuantumRegister quantumRegister(circuit.getNumQubits());
+        std::vector<double> values(names.size());
+        for (size_t row = begin; row < end; ++row) {
+            quantumRegister.reset();
+            circuit.execute(quantumRegister, bindings[row]);
+
+            for (size_t parameter = 0; parameter < parameterCount; ++parameter) {
+                values[parameter] = bindings[row][parameter];
+            }
+            for (size_t observable = 0; observable < observables.size(); ++observable) {
+                values[parameterCount + observable] = observables[observable].evaluate(quantumRegister);
+            }
+            for (size_t column = 0; column < values.size(); ++column) {
+                table.set(row, column, values[column]);
+            }
+            if (sink) {
+                sink(row, values);
+            }
+        }
+    });
+
+    return table;
+}
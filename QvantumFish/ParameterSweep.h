@@ -0,0 +1,53 @@
+#ifndef PARAMETER_SWEEP_H
+#define PARAMETER_SWEEP_H
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "CompiledCircuit.h"
+#include "QuantumRegister.h"
+#include "SweepResultTable.h"
+
+//a value recorded for every binding of the sweep
+struct SweepObservable {
+    std::string name;
+    std::function<double(const QuantumRegister&)> evaluate;
+};
+
+//receives every row as soon as it is finished, values follow the columns of the result table.
+//it is called from the worker threads, concurrently and in no particular row order
+using SweepRowSink = std::function<void(size_t row, const std::vector<double>& values)>;
+
+
+/*
+
+    ParameterSweep class
+
+    evaluates one compiled circuit on many parameter bindings, the chunks of rows share the compiled plan
+    and each of them owns a single register that is reset between bindings
+
+*/
+class ParameterSweep {
+private:
+    const CompiledCircuit& circuit;
+    std::vector<SweepObservable> observables;
+
+public:
+    // Constructor
+    ParameterSweep(const CompiledCircuit& compiledCircuit);
+
+    // Observables, one result column each
+    void addObservable(const std::string& name, const std::function<double(const QuantumRegister&)>& evaluate);
+    void addExpectationZ(int qubit);
+    void addProbabilityOne(int qubit);
+    size_t getObservableCount() const { return observables.size(); }
+
+    // Bindings helpers
+    static std::vector<std::vector<double>> buildGrid(const std::vector<std::vector<double>>& axes);
+
+    // Execution, the table holds one column per parameter followed by one column per observable,
+    // the sink (when given) sees each row while the rest of the sweep is still running
+    SweepResultTable run(const std::vector<std::vector<double>>& bindings, const SweepRowSink& sink = nullptr) const;
+};
+
+#endif // PARAMETER_SWEEP_H
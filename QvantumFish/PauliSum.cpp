@@ -0,0 +1,318 @@
+#include "PauliSum.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+#include <Eigen/Dense>
+#include <Eigen/SparseCore>
+#include "BitUtils.h"
+#include "ParallelUtils.h"
+
+/*
+
+    FUNCTION: checkMasks(xMask, zMask) / pauliBits(pauli, qubit, xPart):
+                masks must not touch qubits outside of the sum, pauliBits gives the contribution
+                of a single letter to the x or z mask
+
+*/
+void PauliSum::checkMasks(std::uint64_t xMask, std::uint64_t zMask) const {
+    if (((xMask | zMask) >> numQubits) != 0) {
+        throw std::out_of_range("Pauli term acts on a qubit outside of the sum");
+    }
+}
+
+std::uint64_t PauliSum::pauliBits(char pauli, int qubit, bool xPart) {
+    std::uint64_t bit = static_cast<std::uint64_t>(1) << qubit;
+    switch (pauli) {
+    case 'I': case 'i':
+        return 0;
+    case 'X': case 'x':
+        return xPart ? bit : 0;
+    case 'Y': case 'y':
+        return bit;
+    case 'Z': case 'z':
+        return xPart ? 0 : bit;
+    default:
+        throw std::invalid_argument("Unknown Pauli operator, expected one of I, X, Y, Z");
+    }
+}
+
+/*
+
+    CONSTRUCTOR
+
+*/
+PauliSum::PauliSum(int qubitCount) : numQubits(qubitCount) {
+    if (qubitCount < 1 || qubitCount > MAX_QUBITS) {
+        throw std::invalid_argument("PauliSum supports between 1 and 30 qubits");
+    }
+}
+
+/*
+
+    FUNCTION: addTerm(coefficient, ...) / addSingle / addPair:
+                append c * P to the sum, if the same string is already there only its coefficient changes.
+                the grouped copy is updated in place, a new string is inserted at its xMask position
+
+*/
+void PauliSum::addTerm(double coefficient, std::uint64_t xMask, std::uint64_t zMask) {
+    checkMasks(xMask, zMask);
+    for (PauliTerm& term : terms) {
+        if (term.xMask == xMask && term.zMask == zMask) {
+            term.coefficient += coefficient;
+            placeSorted(term);
+            return;
+        }
+    }
+    terms.push_back({ coefficient, xMask, zMask });
+    placeSorted(terms.back());
+}
+
+void PauliSum::placeSorted(const PauliTerm& term) {
+    const auto range = std::equal_range(sortedXMasks.begin(), sortedXMasks.end(), term.xMask);
+    size_t position = static_cast<size_t>(range.first - sortedXMasks.begin());
+    const size_t groupEnd = static_cast<size_t>(range.second - sortedXMasks.begin());
+    while (position < groupEnd && sortedZMasks[position] != term.zMask) {
+        ++position;
+    }
+
+    const std::complex<double> phase = termPhase(term);
+    if (position < groupEnd) {
+        realPhases[position] = phase.real();
+        imagPhases[position] = phase.imag();
+        return;
+    }
+
+    const std::ptrdiff_t offset = static_cast<std::ptrdiff_t>(position);
+    sortedXMasks.insert(sortedXMasks.begin() + offset, term.xMask);
+    sortedZMasks.insert(sortedZMasks.begin() + offset, term.zMask);
+    realPhases.insert(realPhases.begin() + offset, phase.real());
+    imagPhases.insert(imagPhases.begin() + offset, phase.imag());
+
+    groupStart.clear();
+    for (size_t k = 0; k < sortedXMasks.size(); ++k) {
+        if (k == 0 || sortedXMasks[k] != sortedXMasks[k - 1]) {
+            groupStart.push_back(k);
+        }
+    }
+    groupStart.push_back(sortedXMasks.size());
+}
+
+void PauliSum::addTerm(double coefficient, const std::string& paulis) {
+    if (static_cast<int>(paulis.size()) != numQubits) {
+        throw std::invalid_argument("Pauli string length does not match the number of qubits");
+    }
+    std::uint64_t xMask = 0;
+    std::uint64_t zMask = 0;
+    for (int position = 0; position < numQubits; ++position) {
+        int qubit = numQubits - 1 - position;
+        xMask |= pauliBits(paulis[position], qubit, true);
+        zMask |= pauliBits(paulis[position], qubit, false);
+    }
+    addTerm(coefficient, xMask, zMask);
+}
+
+void PauliSum::addSingle(double coefficient, char pauli, int qubit) {
+    if (qubit < 0 || qubit >= numQubits) {
+        throw std::out_of_range("Qubit index outside of the sum");
+    }
+    addTerm(coefficient, pauliBits(pauli, qubit, true), pauliBits(pauli, qubit, false));
+}
+
+void PauliSum::addPair(double coefficient, char pauliA, int qubitA, char pauliB, int qubitB) {
+    if (qubitA < 0 || qubitA >= numQubits || qubitB < 0 || qubitB >= numQubits) {
+        throw std::out_of_range("Qubit index outside of the sum");
+    }
+    if (qubitA == qubitB) {
+        throw std::invalid_argument("Pauli pair needs two different qubits");
+    }
+    addTerm(coefficient,
+        pauliBits(pauliA, qubitA, true) | pauliBits(pauliB, qubitB, true),
+        pauliBits(pauliA, qubitA, false) | pauliBits(pauliB, qubitB, false));
+}
+
+/*
+
+    FUNCTION: pauliAt(term, qubit) / termString(term, qubitCount):
+                letter acting on one qubit, and the whole string written like a ket
+
+*/
+char PauliSum::pauliAt(const PauliTerm& term, int qubit) {
+    bool x = ((term.xMask >> qubit) & 1) != 0;
+    bool z = ((term.zMask >> qubit) & 1) != 0;
+    if (x && z) {
+        return 'Y';
+    }
+    return x ? 'X' : (z ? 'Z' : 'I');
+}
+
+std::string PauliSum::termString(const PauliTerm& term, int qubitCount) {
+    std::string result;
+    for (int qubit = qubitCount - 1; qubit >= 0; --qubit) {
+        result += pauliAt(term, qubit);
+    }
+    return result;
+}
+
+/*
+
+    FUNCTION: commute(first, second):
+                two strings commute when they anticommute on an even number of qubits,
+                the symplectic product x1.z2 + z1.x2 counts those qubits
+
+*/
+bool PauliSum::commute(const PauliTerm& first, const PauliTerm& second) {
+    return bitParity((first.xMask & second.zMask) ^ (first.zMask & second.xMask)) == 0;
+}
+
+/*
+
+    FUNCTION: termPhase(term):
+                c * i^(#Y), Y = i X Z so every Y contributes a factor i on top of the X and Z parts
+
+*/
+std::complex<double> PauliSum::termPhase(const PauliTerm& term) {
+    static const std::complex<double> powersOfI[4] = { { 1.0, 0.0 }, { 0.0, 1.0 }, { -1.0, 0.0 }, { 0.0, -1.0 } };
+    return term.coefficient * powersOfI[bitCount(term.xMask & term.zMask) & 3];
+}
+
+/*
+
+    FUNCTION: apply(input, output):
+                output(i) = sum_k c_k i^(#Y) (-1)^(popcount(j & zMask)) input(j) with j = i ^ xMask.
+                terms sharing the same xMask read the same input entry, so they are grouped (once, by addTerm)
+                and their phases summed first, c_k i^(#Y) is either real or imaginary which keeps that sum in
+                plain doubles and leaves a single complex product per group and entry.
+                every output entry is written by exactly one worker so the chunks need no locking,
+                looping over the groups inside a chunk keeps the reads of input in a contiguous block
+
+*/
+void PauliSum::apply(const Eigen::VectorXcd& input, Eigen::VectorXcd& output) const {
+    const Eigen::Index dimension = getDimension();
+    if (input.size() != dimension) {
+        throw std::invalid_argument("State size does not match the Pauli sum");
+    }
+    if (&input == &output) {
+        throw std::invalid_argument("Pauli sum cannot be applied in place");
+    }
+    output.resize(dimension);
+
+    const std::complex<double>* source = input.data();
+    std::complex<double>* destination = output.data();
+
+    //tiles of the output small enough to stay in cache while every group is added to them
+    const size_t tileSize = static_cast<size_t>(1) << 10;
+
+    parallelFor(0, static_cast<size_t>(dimension), static_cast<size_t>(1) << 12, [&](size_t begin, size_t end) {
+        for (size_t tileBegin = begin; tileBegin < end; tileBegin += tileSize) {
+            const size_t tileEnd = std::min(end, tileBegin + tileSize);
+            for (size_t i = tileBegin; i < tileEnd; ++i) {
+                destination[i] = 0.0;
+            }
+            for (size_t group = 0; group + 1 < groupStart.size(); ++group) {
+                const size_t first = groupStart[group];
+                const size_t last = groupStart[group + 1];
+                const std::uint64_t xMask = sortedXMasks[first];
+                for (size_t i = tileBegin; i < tileEnd; ++i) {
+                    const size_t j = i ^ xMask;
+                    double factorReal = 0.0;
+                    double factorImag = 0.0;
+                    for (size_t k = first; k < last; ++k) {
+                        double sign = bitParity(j & sortedZMasks[k]) ? -1.0 : 1.0;
+                        factorReal += sign * realPhases[k];
+                        factorImag += sign * imagPhases[k];
+                    }
+                    const double sourceReal = source[j].real();
+                    const double sourceImag = source[j].imag();
+                    destination[i] += std::complex<double>(factorReal * sourceReal - factorImag * sourceImag,
+                        factorReal * sourceImag + factorImag * sourceReal);
+                }
+            }
+        }
+    });
+}
+
+Eigen::VectorXcd PauliSum::apply(const Eigen::VectorXcd& input) const {
+    Eigen::VectorXcd output;
+    apply(input, output);
+    return output;
+}
+
+double PauliSum::expectation(const Eigen::VectorXcd& state) const {
+    return state.dot(apply(state)).real();
+}
+
+/*
+
+    FUNCTION: toSparse():
+                one entry per basis state and term, repeated positions are summed by setFromTriplets
+
+*/
+Eigen::SparseMatrix<std::complex<double>> PauliSum::toSparse() const {
+    const Eigen::Index dimension = getDimension();
+    std::vector<Eigen::Triplet<std::complex<double>>> entries;
+    entries.reserve(static_cast<size_t>(dimension) * terms.size());
+
+    for (const PauliTerm& term : terms) {
+        std::complex<double> phase = termPhase(term);
+        for (Eigen::Index j = 0; j < dimension; ++j) {
+            std::uint64_t column = static_cast<std::uint64_t>(j);
+            std::complex<double> value = bitParity(column & term.zMask) ? -phase : phase;
+            entries.emplace_back(static_cast<Eigen::Index>(column ^ term.xMask), j, value);
+        }
+    }
+
+    Eigen::SparseMatrix<std::complex<double>> matrix(dimension, dimension);
+    matrix.setFromTriplets(entries.begin(), entries.end());
+    matrix.prune(std::complex<double>(0.0, 0.0));
+    return matrix;
+}
+
+/*
+
+    FUNCTION: transverseFieldIsing(qubitCount, coupling, field, periodic):
+                H = -J sum_i Z_i Z_(i+1) - h sum_i X_i
+
+*/
+PauliSum PauliSum::transverseFieldIsing(int qubitCount, double coupling, double field, bool periodic) {
+    PauliSum hamiltonian(qubitCount);
+    int bonds = periodic && qubitCount > 2 ? qubitCount : qubitCount - 1;
+    for (int i = 0; i < bonds; ++i) {
+        hamiltonian.addPair(-coupling, 'Z', i, 'Z', (i + 1) % qubitCount);
+    }
+    for (int i = 0; i < qubitCount; ++i) {
+        hamiltonian.addSingle(-field, 'X', i);
+    }
+    return hamiltonian;
+}
+
+/*
+
+    FUNCTION: heisenbergChain(qubitCount, jx, jy, jz, field, periodic):
+                H = sum_i (Jx X_i X_(i+1) + Jy Y_i Y_(i+1) + Jz Z_i Z_(i+1)) + h sum_i Z_i
+
+*/
+PauliSum PauliSum::heisenbergChain(int qubitCount, double jx, double jy, double jz, double field, bool periodic) {
+    PauliSum hamiltonian(qubitCount);
+    int bonds = periodic && qubitCount > 2 ? qubitCount : qubitCount - 1;
+    for (int i = 0; i < bonds; ++i) {
+        int next = (i + 1) % qubitCount;
+        if (jx != 0.0) {
+            hamiltonian.addPair(jx, 'X', i, 'X', next);
+        }
+        if (jy != 0.0) {
+            hamiltonian.addPair(jy, 'Y', i, 'Y', next);
+        }
+        if (jz != 0.0) {
+            hamiltonian.addPair(jz, 'Z', i, 'Z', next);
+        }
+    }
+    if (field != 0.0) {
+        for (int i = 0; i < qubitCount; ++i) {
+            hamiltonian.addSingle(field, 'Z', i);
+        }
+    }
+    return hamiltonian;
+}
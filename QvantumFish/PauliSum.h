@@ -0,0 +1,88 @@
+#ifndef PAULI_SUM_H
+#define PAULI_SUM_H
+
+#include <complex>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <Eigen/Dense>
+#include <Eigen/SparseCore>
+
+//c * P with P a tensor product of I, X, Y, Z, qubit k is X or Y when bit k of xMask is set, Z or Y when bit k of zMask is set
+struct PauliTerm {
+    double coefficient;
+    std::uint64_t xMask;
+    std::uint64_t zMask;
+};
+
+
+/*
+
+    PauliSum class
+
+    Hamiltonian H = sum_k c_k P_k stored as Pauli strings, never as a matrix. a string maps a basis state
+    to a single other one
+
+                    P|j> = i^(#Y) (-1)^(popcount(j & zMask)) |j ^ xMask>
+
+    so H|psi> is evaluated one term at a time with a gather over the register. next to the terms (in the order
+    they were added) the sum keeps a copy grouped by xMask with the phases c_k i^(#Y) already split in real and
+    imaginary parts, addTerm keeps it up to date so apply never sorts
+
+*/
+class PauliSum {
+private:
+    int numQubits;
+    std::vector<PauliTerm> terms;
+
+    // terms ordered by xMask, the layout apply reads
+    std::vector<std::uint64_t> sortedXMasks;
+    std::vector<std::uint64_t> sortedZMasks;
+    std::vector<double> realPhases;         // c_k i^(#Y) is either real or imaginary
+    std::vector<double> imagPhases;
+    std::vector<size_t> groupStart;         // first sorted term of every xMask, then the term count
+
+    // Private helper methods
+    void checkMasks(std::uint64_t xMask, std::uint64_t zMask) const;
+    void placeSorted(const PauliTerm& term);
+    static std::uint64_t pauliBits(char pauli, int qubit, bool xPart);
+
+public:
+    // same limit as QuantumRegister
+    static constexpr int MAX_QUBITS = 30;
+
+    // Constructor, empty sum
+    PauliSum(int qubitCount);
+
+    // Getters
+    int getNumQubits() const { return numQubits; }
+    Eigen::Index getDimension() const { return static_cast<Eigen::Index>(1) << numQubits; }
+    const std::vector<PauliTerm>& getTerms() const { return terms; }
+    size_t getTermCount() const { return terms.size(); }
+
+    // Builders, terms with the same string are merged
+    void addTerm(double coefficient, std::uint64_t xMask, std::uint64_t zMask);
+    void addTerm(double coefficient, const std::string& paulis);   // written like a ket, paulis[0] is the highest qubit
+    void addSingle(double coefficient, char pauli, int qubit);
+    void addPair(double coefficient, char pauliA, int qubitA, char pauliB, int qubitB);
+
+    // Pauli string helpers
+    static char pauliAt(const PauliTerm& term, int qubit);
+    static std::string termString(const PauliTerm& term, int qubitCount);
+    static bool commute(const PauliTerm& first, const PauliTerm& second);
+    static std::complex<double> termPhase(const PauliTerm& term);  // c * i^(#Y)
+
+    // Action on a state, output = H input (multithreaded for large registers)
+    void apply(const Eigen::VectorXcd& input, Eigen::VectorXcd& output) const;
+    Eigen::VectorXcd apply(const Eigen::VectorXcd& input) const;
+    double expectation(const Eigen::VectorXcd& state) const;
+
+    //explicit matrix, only meant for small systems and for the sparse solvers
+    Eigen::SparseMatrix<std::complex<double>> toSparse() const;
+
+    // Spin chain models
+    static PauliSum transverseFieldIsing(int qubitCount, double coupling, double field, bool periodic = false);
+    static PauliSum heisenbergChain(int qubitCount, double jx, double jy, double jz, double field = 0.0, bool periodic = false);
+};
+
+#endif // PAULI_SUM_H
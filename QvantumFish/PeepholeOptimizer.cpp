@@ -0,0 +1,328 @@
+#define _USE_MATH_DEFINES
+
+#include "PeepholeOptimizer.h"
+#include "GateLibrary.h"
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+/*
+
+    CONSTRUCTOR
+
+*/
+PeepholeOptimizer::PeepholeOptimizer(double angleTolerance)
+    : tolerance(angleTolerance), cancelledCount(0), mergedCount(0), droppedCount(0) {
+    if (angleTolerance < 0.0) {
+        throw std::invalid_argument("Optimizer tolerance cannot be negative");
+    }
+}
+
+/*
+
+    FUNCTION: optimize(circuit):
+                every gate is first dropped if it is the identity, then cancelled against the last gate of its
+                qubits, then merged into a rotation or a diagonal gate already placed, and appended otherwise
+
+*/
+QuantumCircuit PeepholeOptimizer::optimize(const QuantumCircuit& circuit) {
+    reset(circuit.getNumQubits());
+
+    for (const GateOperation& operation : circuit.getOperations()) {
+        if (isIdentity(operation)) {
+            ++droppedCount;
+            continue;
+        }
+        if (tryCancel(operation) || tryMergeRotation(operation) || tryMergeDiagonal(operation)) {
+            continue;
+        }
+        append(operation);
+    }
+
+    QuantumCircuit result(circuit.getNumQubits());
+    for (const Node& node : nodes) {
+        if (node.alive) {
+            result.addOperation(node.operation);
+        }
+    }
+    return result;
+}
+
+void PeepholeOptimizer::reset(int qubitCount) {
+    cancelledCount = 0;
+    mergedCount = 0;
+    droppedCount = 0;
+    nodes.clear();
+    lastGate.assign(qubitCount, -1);
+    lastDiagonal.assign(qubitCount, -1);
+}
+
+int PeepholeOptimizer::slotOf(const Node& node, int qubit) {
+    return node.operation.target == qubit ? 0 : 1;
+}
+
+/*
+
+    FUNCTION: append(operation) / remove(index):
+                the node is linked at the end of the list of each of its qubits, removing it relinks its neighbours,
+                when the removed gate was the last one the previous gate becomes the last again
+
+*/
+void PeepholeOptimizer::append(const GateOperation& operation) {
+    const int index = static_cast<int>(nodes.size());
+    Node node{ operation, true, { -1, -1 }, { -1, -1 } };
+    const int qubits[2] = { operation.target, QuantumCircuit::isTwoQubit(operation.type) ? operation.control : -1 };
+
+    for (int slot = 0; slot < 2; ++slot) {
+        if (qubits[slot] < 0) {
+            continue;
+        }
+        int previous = lastGate[qubits[slot]];
+        node.previous[slot] = previous;
+        if (previous >= 0) {
+            nodes[previous].next[slotOf(nodes[previous], qubits[slot])] = index;
+        }
+        lastGate[qubits[slot]] = index;
+    }
+    nodes.push_back(node);
+    updateDiagonalIndex(index);
+}
+
+void PeepholeOptimizer::remove(int index) {
+    Node& node = nodes[index];
+    node.alive = false;
+    const int qubits[2] = { node.operation.target, QuantumCircuit::isTwoQubit(node.operation.type) ? node.operation.control : -1 };
+
+    for (int slot = 0; slot < 2; ++slot) {
+        const int qubit = qubits[slot];
+        if (qubit < 0) {
+            continue;
+        }
+        const int previous = node.previous[slot];
+        const int next = node.next[slot];
+        if (previous >= 0) {
+            nodes[previous].next[slotOf(nodes[previous], qubit)] = next;
+        }
+        if (next >= 0) {
+            nodes[next].previous[slotOf(nodes[next], qubit)] = previous;
+        }
+        else {
+            lastGate[qubit] = previous;
+        }
+
+        if (lastDiagonal[qubit] == index) {
+            lastDiagonal[qubit] = -1;
+        }
+        //a diagonal gate that is again the last one of its qubit can take later merges
+        if (next < 0 && previous >= 0 && lastDiagonal[qubit] < 0) {
+            const GateOperation& exposed = nodes[previous].operation;
+            if (!QuantumCircuit::isTwoQubit(exposed.type) && isDiagonal(exposed.type)) {
+                lastDiagonal[qubit] = previous;
+            }
+        }
+    }
+}
+
+/*
+
+    FUNCTION: updateDiagonalIndex(index):
+                a diagonal gate commutes with the control of a CNOT and with both qubits of CZ and controlled
+                phases, any other gate on the qubit stops later diagonal gates from reaching it
+
+*/
+void PeepholeOptimizer::updateDiagonalIndex(int index) {
+    const GateOperation& operation = nodes[index].operation;
+    switch (operation.type) {
+    case GateType::CNOT:
+        lastDiagonal[operation.target] = -1;
+        break;
+    case GateType::CZ:
+    case GateType::ControlledPhase:
+        break;
+    case GateType::Swap:
+        lastDiagonal[operation.target] = -1;
+        lastDiagonal[operation.control] = -1;
+        break;
+    default:
+        lastDiagonal[operation.target] = isDiagonal(operation.type) ? index : -1;
+        break;
+    }
+}
+
+/*
+
+    FUNCTION: tryCancel(operation):
+                the last gate must be the inverse and be the last gate of every qubit of the new one
+
+*/
+bool PeepholeOptimizer::tryCancel(const GateOperation& operation) {
+    const int last = lastGate[operation.target];
+    if (last < 0) {
+        return false;
+    }
+    if (QuantumCircuit::isTwoQubit(operation.type) && lastGate[operation.control] != last) {
+        return false;
+    }
+    if (!areInverse(nodes[last].operation, operation)) {
+        return false;
+    }
+
+    remove(last);
+    cancelledCount += 2;
+    return true;
+}
+
+/*
+
+    FUNCTION: tryMergeRotation(operation):
+                RX and RY after a rotation about the same axis, controlled phases on the same pair.
+                constant angles add, parametric ones add their scales when they read the same parameter
+
+*/
+bool PeepholeOptimizer::tryMergeRotation(const GateOperation& operation) {
+    if (operation.type != GateType::RotationX && operation.type != GateType::RotationY && operation.type != GateType::ControlledPhase) {
+        return false;
+    }
+
+    const int last = lastGate[operation.target];
+    if (last < 0) {
+        return false;
+    }
+    GateOperation& previous = nodes[last].operation;
+    if (previous.type != operation.type || previous.parameterIndex != operation.parameterIndex) {
+        return false;
+    }
+    if (operation.type == GateType::ControlledPhase) {
+        //the controlled phase is symmetric in its two qubits
+        if (lastGate[operation.control] != last) {
+            return false;
+        }
+    }
+    else if (previous.target != operation.target) {
+        return false;
+    }
+
+    previous.angle += operation.angle;
+    ++mergedCount;
+    if (isIdentity(previous)) {
+        remove(last);
+        ++droppedCount;
+    }
+    return true;
+}
+
+/*
+
+    FUNCTION: tryMergeDiagonal(operation):
+                two RZ keep the RZ form, any other pair of constant diagonal gates becomes the phase gate
+                diag(1, e^(i (phi1 + phi2))) written as Z, S, T, their inverses or a Phase rotation
+
+*/
+bool PeepholeOptimizer::tryMergeDiagonal(const GateOperation& operation) {
+    if (QuantumCircuit::isTwoQubit(operation.type) || !isDiagonal(operation.type)) {
+        return false;
+    }
+
+    const int diagonal = lastDiagonal[operation.target];
+    if (diagonal < 0) {
+        return false;
+    }
+    GateOperation& previous = nodes[diagonal].operation;
+
+    if (previous.parameterIndex >= 0 || operation.parameterIndex >= 0) {
+        if (previous.type != operation.type || previous.parameterIndex != operation.parameterIndex) {
+            return false;
+        }
+        previous.angle += operation.angle;
+    }
+    else if (previous.type == GateType::RotationZ && operation.type == GateType::RotationZ) {
+        previous.angle += operation.angle;
+    }
+    else {
+        previous = phaseGate(operation.target, diagonalPhase(previous) + diagonalPhase(operation), tolerance);
+    }
+
+    ++mergedCount;
+    if (isIdentity(previous)) {
+        remove(diagonal);
+        ++droppedCount;
+    }
+    return true;
+}
+
+/*
+
+    FUNCTION: isIdentity(operation) / isNegligibleAngle(angle):
+                rotations by a multiple of 2 pi are the identity up to a global phase, a controlled phase
+                by a multiple of 2 pi is exactly the identity, a parametric gate only with a zero scale
+
+*/
+bool PeepholeOptimizer::isIdentity(const GateOperation& operation) const {
+    if (operation.type == GateType::Identity) {
+        return true;
+    }
+    if (!QuantumCircuit::isParametric(operation.type)) {
+        return false;
+    }
+    if (operation.parameterIndex >= 0) {
+        return std::abs(operation.angle) <= tolerance;
+    }
+    return isNegligibleAngle(operation.angle);
+}
+
+bool PeepholeOptimizer::isNegligibleAngle(double angle) const {
+    return std::abs(std::remainder(angle, 2.0 * M_PI)) <= tolerance;
+}
+
+/*
+
+    GATE CLASSIFICATION
+
+*/
+bool PeepholeOptimizer::isDiagonal(GateType type) {
+    const GateTraits traits = gateTraits(type);
+    return type != GateType::Identity && traits.qubitCount == 1 && traits.diagonal;
+}
+
+bool PeepholeOptimizer::areInverse(const GateOperation& first, const GateOperation& second) {
+    const GateTraits traits = gateTraits(first.type);
+    if (traits.qubitCount != gateTraits(second.type).qubitCount || first.type == GateType::Identity) {
+        return false;
+    }
+
+    if (traits.qubitCount == 2) {
+        if (first.type != second.type || !traits.selfInverse) {
+            return false;
+        }
+        bool sameOrder = first.target == second.target && first.control == second.control;
+        bool swapped = first.target == second.control && first.control == second.target;
+        //CZ and Swap do not distinguish their two qubits
+        return sameOrder || (swapped && traits.symmetric);
+    }
+
+    //rotations are merged instead
+    return first.target == second.target && !traits.parametric && traits.namedInverse && second.type == traits.inverse;
+}
+
+double PeepholeOptimizer::diagonalPhase(const GateOperation& operation) {
+    if (!isDiagonal(operation.type)) {
+        throw std::invalid_argument("Gate is not diagonal");
+    }
+    const GateTraits traits = gateTraits(operation.type);
+    return traits.parametric ? operation.angle : traits.phase;
+}
+
+GateOperation PeepholeOptimizer::phaseGate(int qubit, double phase, double tolerance) {
+    const double reduced = std::remainder(phase, 2.0 * M_PI);
+    const struct { double phase; GateType type; } named[] = {
+        { 0.0, GateType::Identity }, { M_PI, GateType::PauliZ }, { -M_PI, GateType::PauliZ },
+        { M_PI / 2.0, GateType::S }, { -M_PI / 2.0, GateType::SDagger },
+        { M_PI / 4.0, GateType::T }, { -M_PI / 4.0, GateType::TDagger }
+    };
+    for (const auto& candidate : named) {
+        if (std::abs(reduced - candidate.phase) <= tolerance) {
+            return { candidate.type, qubit, -1, 0.0, -1 };
+        }
+    }
+    return { GateType::Phase, qubit, -1, reduced, -1 };
+}
@@ -0,0 +1,70 @@
+#ifndef PEEPHOLE_OPTIMIZER_H
+#define PEEPHOLE_OPTIMIZER_H
+
+#include <cstddef>
+#include <vector>
+#include "QuantumCircuit.h"
+
+
+/*
+
+    PeepholeOptimizer class
+
+    single pass optimization of a gate list: adjacent inverse pairs (H H, X X, CNOT CNOT, S S^dagger, ...)
+    cancel, rotations about the same axis merge, diagonal gates merge through the controls of CNOT and through
+    CZ and controlled phases (which they commute with) and gates equivalent to the identity up to a global phase
+    are dropped. every qubit keeps the index of its last gate and of its last diagonal gate still reachable,
+    the gates on a qubit are a doubly linked list, so each gate is handled in O(1) and the pass is linear.
+    global phases of uncontrolled gates are not preserved
+
+*/
+class PeepholeOptimizer {
+private:
+    //a gate of the output, linked to the previous and next gate of each of its qubits (slot 0 target, slot 1 control)
+    struct Node {
+        GateOperation operation;
+        bool alive;
+        int previous[2];
+        int next[2];
+    };
+
+    double tolerance;
+    size_t cancelledCount;
+    size_t mergedCount;
+    size_t droppedCount;
+
+    std::vector<Node> nodes;
+    std::vector<int> lastGate;          // last alive gate of every qubit, -1 when none
+    std::vector<int> lastDiagonal;      // last single qubit diagonal gate that later gates on the qubit commute with
+
+    // Private helper methods
+    void reset(int qubitCount);
+    void append(const GateOperation& operation);
+    void remove(int index);
+    bool tryCancel(const GateOperation& operation);
+    bool tryMergeRotation(const GateOperation& operation);
+    bool tryMergeDiagonal(const GateOperation& operation);
+    void updateDiagonalIndex(int index);
+    bool isIdentity(const GateOperation& operation) const;
+    bool isNegligibleAngle(double angle) const;
+    static int slotOf(const Node& node, int qubit);
+
+public:
+    // Constructor, angles within tolerance of a multiple of 2 pi count as the identity
+    PeepholeOptimizer(double angleTolerance = 1e-10);
+
+    // Getters, counts of the last optimize call
+    size_t getCancelledCount() const { return cancelledCount; }
+    size_t getMergedCount() const { return mergedCount; }
+    size_t getDroppedCount() const { return droppedCount; }
+
+    QuantumCircuit optimize(const QuantumCircuit& circuit);
+
+    // Gate classification used by the pass
+    static bool isDiagonal(GateType type);                                  // single qubit gates diag(1, e^(i phi)) up to a phase
+    static bool areInverse(const GateOperation& first, const GateOperation& second);
+    static double diagonalPhase(const GateOperation& operation);            // phi of a constant diagonal gate
+    static GateOperation phaseGate(int qubit, double phase, double tolerance);   // named gate for phi when there is one
+};
+
+#endif // PEEPHOLE_OPTIMIZER_H
@@ -0,0 +1,218 @@
+#define _USE_MATH_DEFINES
+
+#include "ProgramParser.h"
+#include "GateLibrary.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+static std::string toLower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+//the whole token must be a number, the message names what was expected
+static double parseNumber(const std::string& text, const std::string& what) {
+    size_t used = 0;
+    double value = 0.0;
+    try {
+        value = std::stod(text, &used);
+    }
+    catch (const std::exception&) {
+        used = 0;
+    }
+    if (text.empty() || used != text.size()) {
+        throw std::invalid_argument("Invalid " + what + " " + text);
+    }
+    return value;
+}
+
+/*
+
+    FUNCTION: tokenize(line):
+                comments are cut and the rest is split on whitespace and commas
+
+*/
+std::vector<std::string> ProgramParser::tokenize(const std::string& line) {
+    std::string code = line.substr(0, std::min(line.find('#'), line.find("//")));
+    std::replace(code.begin(), code.end(), ',', ' ');
+
+    std::vector<std::string> tokens;
+    std::istringstream stream(code);
+    std::string token;
+    while (stream >> token) {
+        tokens.push_back(token);
+    }
+    return tokens;
+}
+
+//the names of the trait table, plus the usual cx and id spellings
+bool ProgramParser::parseGateName(const std::string& token, GateType& type) {
+    static const GateType types[] = {
+        GateType::Identity, GateType::PauliX, GateType::PauliY, GateType::PauliZ, GateType::Hadamard,
+        GateType::S, GateType::SDagger, GateType::T, GateType::TDagger, GateType::SqrtX,
+        GateType::RotationX, GateType::RotationY, GateType::RotationZ, GateType::Phase,
+        GateType::CNOT, GateType::CZ, GateType::ControlledPhase, GateType::Swap
+    };
+
+    const std::string name = toLower(token);
+    if (name == "cx") {
+        type = GateType::CNOT;
+        return true;
+    }
+    if (name == "id") {
+        type = GateType::Identity;
+        return true;
+    }
+    for (GateType candidate : types) {
+        if (name == toLower(gateTraits(candidate).name)) {
+            type = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+
+    FUNCTION: parseAngle(token):
+                [-][factor[*]]pi[/divisor] or a plain number
+
+*/
+double ProgramParser::parseAngle(const std::string& token) {
+    std::string text = toLower(token);
+    double sign = 1.0;
+    if (!text.empty() && (text[0] == '-' || text[0] == '+')) {
+        sign = text[0] == '-' ? -1.0 : 1.0;
+        text = text.substr(1);
+    }
+
+    double divisor = 1.0;
+    const size_t slash = text.find('/');
+    if (slash != std::string::npos) {
+        divisor = parseNumber(text.substr(slash + 1), "angle divisor");
+        if (divisor == 0.0) {
+            throw std::invalid_argument("Angle divisor cannot be zero");
+        }
+        text = text.substr(0, slash);
+    }
+
+    double value = 0.0;
+    const size_t pi = text.find("pi");
+    if (pi != std::string::npos) {
+        if (pi + 2 != text.size()) {
+            throw std::invalid_argument("Invalid angle " + token);
+        }
+        std::string factor = text.substr(0, pi);
+        if (!factor.empty() && factor.back() == '*') {
+            factor.pop_back();
+        }
+        value = M_PI;
+        if (!factor.empty()) {
+            value *= parseNumber(factor, "angle factor");
+        }
+    }
+    else {
+        value = parseNumber(text, "angle");
+    }
+    return sign * value / divisor;
+}
+
+//a count or index above MAX_QUBITS stops here, index MAX_QUBITS itself fails the register size check in parse
+int ProgramParser::parseQubit(const std::string& token) {
+    const bool digits = !token.empty() && token.size() <= 9 &&
+        std::all_of(token.begin(), token.end(), [](unsigned char c) { return std::isdigit(c) != 0; });
+    if (!digits) {
+        throw std::invalid_argument("Invalid qubit index " + token);
+    }
+    const int value = std::stoi(token);
+    if (value > MAX_QUBITS) {
+        throw std::out_of_range("At most " + std::to_string(MAX_QUBITS) + " qubits are supported");
+    }
+    return value;
+}
+
+/*
+
+    FUNCTION: parse(lines):
+                every line is read on its own so the first broken line is reported with its number,
+                the lines before it are kept
+
+*/
+ParsedProgram ProgramParser::parse(const std::vector<std::string>& lines) {
+    ParsedProgram program;
+    int declaredQubits = 0;
+    int usedQubits = 0;
+
+    for (size_t line = 0; line < lines.size() && program.isValid(); ++line) {
+        const std::vector<std::string> tokens = tokenize(lines[line]);
+        if (tokens.empty()) {
+            continue;
+        }
+
+        try {
+            if (toLower(tokens[0]) == "qubits") {
+                if (tokens.size() != 2 || !program.operations.empty()) {
+                    throw std::invalid_argument("qubits takes one count and must come before the gates");
+                }
+                declaredQubits = parseQubit(tokens[1]);
+                if (declaredQubits < 1) {
+                    throw std::invalid_argument("A program needs at least one qubit");
+                }
+                continue;
+            }
+
+            GateType type;
+            if (!parseGateName(tokens[0], type)) {
+                throw std::invalid_argument("Unknown gate " + tokens[0]);
+            }
+            const GateTraits traits = gateTraits(type);
+            const size_t expected = 1 + (traits.parametric ? 1 : 0) + traits.qubitCount;
+            if (tokens.size() != expected) {
+                throw std::invalid_argument(std::string(traits.name) + " takes " + std::to_string(expected - 1) + " arguments");
+            }
+
+            size_t next = 1;
+            const double angle = traits.parametric ? parseAngle(tokens[next++]) : 0.0;
+            GateOperation operation{ type, -1, -1, angle, -1 };
+            if (traits.qubitCount == 2) {
+                operation.control = parseQubit(tokens[next++]);
+                operation.target = parseQubit(tokens[next++]);
+                if (operation.control == operation.target) {
+                    throw std::invalid_argument("A two qubit gate needs two different qubits");
+                }
+                usedQubits = std::max(usedQubits, operation.control + 1);
+            }
+            else {
+                operation.target = parseQubit(tokens[next++]);
+            }
+            usedQubits = std::max(usedQubits, operation.target + 1);
+
+            if (usedQubits > MAX_QUBITS) {
+                throw std::out_of_range("At most " + std::to_string(MAX_QUBITS) + " qubits are supported");
+            }
+            if (declaredQubits > 0 && usedQubits > declaredQubits) {
+                throw std::out_of_range("Qubit outside of the declared register");
+            }
+            program.operations.push_back(operation);
+            program.sourceLines.push_back(static_cast<int>(line));
+        }
+        catch (const std::exception& error) {
+            program.errorLine = static_cast<int>(line);
+            program.error = error.what();
+        }
+    }
+
+    program.numQubits = declaredQubits > 0 ? declaredQubits : std::max(1, usedQubits);
+    return program;
+}
+
+QuantumCircuit ParsedProgram::toCircuit() const {
+    QuantumCircuit circuit(numQubits);
+    for (const GateOperation& operation : operations) {
+        circuit.addOperation(operation);
+    }
+    return circuit;
+}
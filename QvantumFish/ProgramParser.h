@@ -0,0 +1,54 @@
+#ifndef PROGRAM_PARSER_H
+#define PROGRAM_PARSER_H
+
+#include <string>
+#include <vector>
+#include "QuantumCircuit.h"
+
+//gates of an editor program, every operation remembers the line it came from
+struct ParsedProgram {
+    int numQubits = 0;
+    std::vector<GateOperation> operations;
+    std::vector<int> sourceLines;       // 0 based line of every operation
+    int errorLine = -1;                 // first line that could not be read, -1 when the program is valid
+    std::string error;
+
+    bool isValid() const { return errorLine < 0; }
+    QuantumCircuit toCircuit() const;
+};
+
+
+/*
+
+    ProgramParser class
+
+    reads the text of the editor, one instruction per line
+
+                    qubits 4                declares the register, otherwise the highest qubit used + 1
+                    h 0                     single qubit gates: id x y z h s sdg t tdg sx
+                    rz pi/4 1               rotations and phase gates take the angle first: rx ry rz p
+                    cx 0 1                  two qubit gates take control then target: cnot (cx) cz, cp angle c t
+                    swap 2 3
+
+    names are not case sensitive and come from the GateLibrary table. angles are numbers or multiples of pi
+    (pi, -pi/2, 3*pi/4, 0.25). text after # or // is a comment, blank lines are skipped. the editor simulates
+    the program after every keystroke, so registers are capped at MAX_QUBITS and a larger count or index is
+    an error on its line instead of a huge allocation on the simulation thread
+
+*/
+class ProgramParser {
+private:
+    // Private helper methods
+    static std::vector<std::string> tokenize(const std::string& line);
+    static bool parseGateName(const std::string& token, GateType& type);
+    static double parseAngle(const std::string& token);
+    static int parseQubit(const std::string& token);
+
+public:
+    // largest register a program may declare or use, 2^24 amplitudes are 256 MiB
+    static constexpr int MAX_QUBITS = 24;
+
+    static ParsedProgram parse(const std::vector<std::string>& lines);
+};
+
+#endif // PROGRAM_PARSER_H
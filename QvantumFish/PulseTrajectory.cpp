@@ -0,0 +1,131 @@
+#include "PulseTrajectory.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <vector>
+#include <Eigen/Dense>
+#include "ParallelUtils.h"
+
+/*
+
+    CONSTRUCTORS
+
+*/
+PulseTrajectory::PulseTrajectory()
+    : sampleTime(1.0), blochVectors(3, 0), unitary(Eigen::Matrix2cd::Identity()), finalState(1.0, 0.0) {
+}
+
+PulseTrajectory::PulseTrajectory(const ControlPulse& pulse, const Qubit& initialState)
+    : sampleTime(pulse.getSampleTime()),
+    blochVectors(3, static_cast<Eigen::Index>(pulse.getSampleCount()) + 1),
+    unitary(Eigen::Matrix2cd::Identity()),
+    finalState(initialState.getStateVector()) {
+
+    blochVectors.col(0) = blochVector(finalState);
+    for (size_t sample = 0; sample < pulse.getSampleCount(); ++sample) {
+        Eigen::Matrix2cd step = sampleUnitary(pulse.rotationVector(sample), sampleTime);
+        finalState = step * finalState;
+        unitary = step * unitary;
+        blochVectors.col(static_cast<Eigen::Index>(sample) + 1) = blochVector(finalState);
+    }
+}
+
+/*
+
+    FUNCTION: finalQubit():
+                state at the end of the pulse, renormalized to absorb the round off of the products
+
+*/
+Qubit PulseTrajectory::finalQubit() const {
+    return Qubit(Eigen::Vector2cd(finalState.normalized()));
+}
+
+/*
+
+    FUNCTION: blochVectorAt(time):
+                linear interpolation between the two stored samples around time, pulled back on the sphere
+
+*/
+Eigen::Vector3d PulseTrajectory::blochVectorAt(double time) const {
+    if (isEmpty()) {
+        throw std::logic_error("Empty pulse trajectory");
+    }
+
+    const Eigen::Index last = blochVectors.cols() - 1;
+    double position = std::min(std::max(time / sampleTime, 0.0), static_cast<double>(last));
+    Eigen::Index index = std::min(static_cast<Eigen::Index>(position), std::max<Eigen::Index>(last - 1, 0));
+    if (last == 0) {
+        return blochVectors.col(0);
+    }
+
+    double fraction = position - static_cast<double>(index);
+    Eigen::Vector3d result = (1.0 - fraction) * blochVectors.col(index) + fraction * blochVectors.col(index + 1);
+    double length = result.norm();
+    return length > 1e-12 ? Eigen::Vector3d(result / length) : result;
+}
+
+/*
+
+    FUNCTION: sampleUnitary(rotationVector, duration):
+                closed form of exp(-i duration (Omega . sigma) / 2) with n = Omega / |Omega|
+
+                    | c - i s nz        -s ny - i s nx |
+                    | s ny - i s nx      c + i s nz    |
+
+*/
+Eigen::Matrix2cd PulseTrajectory::sampleUnitary(const Eigen::Vector3d& rotationVector, double duration) {
+    const double frequency = rotationVector.norm();
+    if (frequency * duration < 1e-15) {
+        return Eigen::Matrix2cd::Identity();
+    }
+
+    const Eigen::Vector3d axis = rotationVector / frequency;
+    const double c = std::cos(frequency * duration / 2.0);
+    const double s = std::sin(frequency * duration / 2.0);
+
+    Eigen::Matrix2cd result;
+    result << std::complex<double>(c, -s * axis.z()), std::complex<double>(-s * axis.y(), -s * axis.x()),
+        std::complex<double>(s * axis.y(), -s * axis.x()), std::complex<double>(c, s * axis.z());
+    return result;
+}
+
+Eigen::Matrix2cd PulseTrajectory::pulseUnitary(const ControlPulse& pulse) {
+    Eigen::Matrix2cd result = Eigen::Matrix2cd::Identity();
+    for (size_t sample = 0; sample < pulse.getSampleCount(); ++sample) {
+        result = sampleUnitary(pulse.rotationVector(sample), pulse.getSampleTime()) * result;
+    }
+    return result;
+}
+
+/*
+
+    FUNCTION: pulseUnitaries(pulses):
+                the variants of a pulse design sweep are independent, every worker integrates its own block
+
+*/
+std::vector<Eigen::Matrix2cd> PulseTrajectory::pulseUnitaries(const std::vector<ControlPulse>& pulses) {
+    std::vector<Eigen::Matrix2cd> results(pulses.size());
+    parallelFor(0, pulses.size(), 16, [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; ++k) {
+            results[k] = pulseUnitary(pulses[k]);
+        }
+    });
+    return results;
+}
+
+double PulseTrajectory::gateFidelity(const Eigen::Matrix2cd& actual, const Eigen::Matrix2cd& target) {
+    double overlap = std::norm((target.adjoint() * actual).trace());
+    return (overlap + 2.0) / 6.0;
+}
+
+/*
+
+    FUNCTION: blochVector(state):
+                x = 2 Re(conj(a) b), y = 2 Im(conj(a) b), z = |a|^2 - |b|^2
+
+*/
+Eigen::Vector3d PulseTrajectory::blochVector(const Eigen::Vector2cd& state) {
+    std::complex<double> coherence = std::conj(state(0)) * state(1);
+    return Eigen::Vector3d(2.0 * coherence.real(), 2.0 * coherence.imag(), std::norm(state(0)) - std::norm(state(1)));
+}
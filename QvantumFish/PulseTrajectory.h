@@ -0,0 +1,56 @@
+#ifndef PULSE_TRAJECTORY_H
+#define PULSE_TRAJECTORY_H
+
+#include <vector>
+#include <Eigen/Dense>
+#include "ControlPulse.h"
+#include "Qubit.h"
+
+
+/*
+
+    PulseTrajectory class
+
+    Bloch vector of a qubit driven by a ControlPulse, integrated once with the exact propagator of every
+    piecewise constant sample
+
+                    U_k = exp(-i theta/2 n.sigma) = cos(theta/2) I - i sin(theta/2) n.sigma,     theta = |Omega| dt
+
+    and stored sample by sample so the renderer only interpolates between two stored vectors per frame
+
+*/
+class PulseTrajectory {
+private:
+    double sampleTime;
+    Eigen::Matrix3Xd blochVectors;      // column k is the state after k samples
+    Eigen::Matrix2cd unitary;           // propagator of the whole pulse
+    Eigen::Vector2cd finalState;
+
+public:
+    // Constructors, the default one is an empty trajectory
+    PulseTrajectory();
+    PulseTrajectory(const ControlPulse& pulse, const Qubit& initialState);
+
+    // Getters
+    bool isEmpty() const { return blochVectors.cols() == 0; }
+    double getDuration() const { return sampleTime * static_cast<double>(blochVectors.cols() > 0 ? blochVectors.cols() - 1 : 0); }
+    const Eigen::Matrix3Xd& getBlochVectors() const { return blochVectors; }
+    const Eigen::Matrix2cd& getUnitary() const { return unitary; }
+    Qubit finalQubit() const;
+
+    //Bloch vector at any time of the pulse in O(1), times outside the pulse are clamped
+    Eigen::Vector3d blochVectorAt(double time) const;
+
+    // Propagators without storing the trajectory, for pulse design loops
+    static Eigen::Matrix2cd sampleUnitary(const Eigen::Vector3d& rotationVector, double duration);
+    static Eigen::Matrix2cd pulseUnitary(const ControlPulse& pulse);
+    static std::vector<Eigen::Matrix2cd> pulseUnitaries(const std::vector<ControlPulse>& pulses);
+
+    //average gate fidelity (|tr(V^dagger U)|^2 + 2) / 6 of U against the target V
+    static double gateFidelity(const Eigen::Matrix2cd& actual, const Eigen::Matrix2cd& target);
+
+    //(x, y, z) of a normalized single qubit state
+    static Eigen::Vector3d blochVector(const Eigen::Vector2cd& state);
+};
+
+#endif // PULSE_TRAJECTORY_H
@@ -0,0 +1,232 @@
+#include "QAOACircuit.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <Eigen/Dense>
+#include "BitUtils.h"
+#include "ParallelUtils.h"
+#include "QuantumCircuit.h"
+
+/*
+
+    CONSTRUCTOR
+
+    C(x) = sum_k c_k (-1)^(popcount(x & zMask_k)), accumulated in double for each chunk of the table
+    and stored as float, half of the memory traffic of every later sweep
+
+*/
+QAOACircuit::QAOACircuit(const PauliSum& cost) : numQubits(cost.getNumQubits()) {
+    if (numQubits > 30) {
+        throw std::invalid_argument("QAOACircuit supports up to 30 qubits");
+    }
+
+    std::vector<std::uint64_t> zMasks;
+    std::vector<double> coefficients;
+    for (const PauliTerm& term : cost.getTerms()) {
+        if (term.xMask != 0) {
+            throw std::invalid_argument("QAOA cost must be diagonal in the computational basis");
+        }
+        zMasks.push_back(term.zMask);
+        coefficients.push_back(term.coefficient);
+    }
+
+    const size_t dimension = static_cast<size_t>(1) << numQubits;
+    costTable.resize(dimension);
+
+    parallelFor(0, dimension, 4096, [&](size_t first, size_t last) {
+        std::vector<double> values(std::min<size_t>(last - first, 4096));
+        for (size_t begin = first; begin < last; begin += values.size()) {
+            const size_t count = std::min(values.size(), last - begin);
+            std::fill(values.begin(), values.begin() + count, 0.0);
+            for (size_t k = 0; k < zMasks.size(); ++k) {
+                const std::uint64_t mask = zMasks[k];
+                const double coefficient = coefficients[k];
+                for (size_t x = 0; x < count; ++x) {
+                    values[x] += bitParity((begin + x) & mask) ? -coefficient : coefficient;
+                }
+            }
+            for (size_t x = 0; x < count; ++x) {
+                costTable[begin + x] = static_cast<float>(values[x]);
+            }
+        }
+    });
+}
+
+double QAOACircuit::minimumCost() const {
+    return *std::min_element(costTable.begin(), costTable.end());
+}
+
+double QAOACircuit::maximumCost() const {
+    return *std::max_element(costTable.begin(), costTable.end());
+}
+
+/*
+
+    FUNCTION: prepareUniform(quantumRegister):
+                |+...+> written directly, every amplitude is 2^(-N/2)
+
+*/
+void QAOACircuit::prepareUniform(QuantumRegister& quantumRegister) const {
+    if (quantumRegister.getNumQubits() != numQubits) {
+        throw std::invalid_argument("Register size does not match the QAOA cost");
+    }
+    quantumRegister.getAmplitudes().setConstant(1.0 / std::sqrt(static_cast<double>(quantumRegister.getDimension())));
+}
+
+/*
+
+    FUNCTION: applyCostLayer(quantumRegister, gamma):
+                psi_x *= exp(-i gamma C(x)), one pass over the register and the table
+
+*/
+void QAOACircuit::applyCostLayer(QuantumRegister& quantumRegister, double gamma) const {
+    if (quantumRegister.getNumQubits() != numQubits) {
+        throw std::invalid_argument("Register size does not match the QAOA cost");
+    }
+
+    std::complex<double>* data = quantumRegister.getAmplitudes().data();
+    const float* table = costTable.data();
+    auto sweep = [=](size_t first, size_t last) {
+        for (size_t x = first; x < last; ++x) {
+            const double angle = gamma * table[x];
+            data[x] *= std::complex<double>(std::cos(angle), -std::sin(angle));
+        }
+    };
+
+    const size_t dimension = quantumRegister.getDimension();
+    if (numQubits >= QuantumRegister::PARALLEL_QUBIT_THRESHOLD) {
+        parallelFor(0, dimension, dimension / parallelWorkerCount() + 1, sweep);
+    }
+    else {
+        sweep(0, dimension);
+    }
+}
+
+/*
+
+    FUNCTION: applyMixerLayer(quantumRegister, beta):
+                exp(-i beta X) = RX(2 beta) on every qubit, the gates commute and share one layer pass
+
+*/
+void QAOACircuit::applyMixerLayer(QuantumRegister& quantumRegister, double beta) const {
+    if (quantumRegister.getNumQubits() != numQubits) {
+        throw std::invalid_argument("Register size does not match the QAOA cost");
+    }
+
+    std::vector<int> targets(numQubits);
+    for (int qubit = 0; qubit < numQubits; ++qubit) {
+        targets[qubit] = qubit;
+    }
+    std::vector<Eigen::Matrix2cd> gates(numQubits, QuantumCircuit::gateMatrix(GateType::RotationX, 2.0 * beta));
+    quantumRegister.applySingleQubitLayer(targets, gates);
+}
+
+/*
+
+    FUNCTION: execute(quantumRegister, gammas, betas) / run(gammas, betas):
+                the register is overwritten with |+...+> before the layers
+
+*/
+void QAOACircuit::execute(QuantumRegister& quantumRegister, const std::vector<double>& gammas, const std::vector<double>& betas) const {
+    if (gammas.size() != betas.size()) {
+        throw std::invalid_argument("QAOA needs one gamma and one beta per layer");
+    }
+
+    prepareUniform(quantumRegister);
+    for (size_t layer = 0; layer < gammas.size(); ++layer) {
+        applyCostLayer(quantumRegister, gammas[layer]);
+        applyMixerLayer(quantumRegister, betas[layer]);
+    }
+}
+
+QuantumRegister QAOACircuit::run(const std::vector<double>& gammas, const std::vector<double>& betas) const {
+    QuantumRegister quantumRegister(numQubits);
+    execute(quantumRegister, gammas, betas);
+    return quantumRegister;
+}
+
+/*
+
+    FUNCTION: energy(quantumRegister) / expectation(gammas, betas):
+                sum_x C(x) |psi_x|^2 with a partial sum per worker
+
+*/
+double QAOACircuit::energy(const QuantumRegister& quantumRegister) const {
+    if (quantumRegister.getNumQubits() != numQubits) {
+        throw std::invalid_argument("Register size does not match the QAOA cost");
+    }
+
+    const std::complex<double>* data = quantumRegister.getAmplitudes().data();
+    const size_t dimension = quantumRegister.getDimension();
+    const size_t chunks = numQubits >= QuantumRegister::PARALLEL_QUBIT_THRESHOLD ? parallelWorkerCount() : 1;
+    const size_t chunkSize = (dimension + chunks - 1) / chunks;
+    std::vector<double> partial(chunks, 0.0);
+
+    parallelFor(0, chunks, 1, [&](size_t first, size_t last) {
+        for (size_t chunk = first; chunk < last; ++chunk) {
+            double sum = 0.0;
+            const size_t end = std::min(dimension, (chunk + 1) * chunkSize);
+            for (size_t x = chunk * chunkSize; x < end; ++x) {
+                sum += costTable[x] * std::norm(data[x]);
+            }
+            partial[chunk] = sum;
+        }
+    });
+
+    double total = 0.0;
+    for (double value : partial) {
+        total += value;
+    }
+    return total;
+}
+
+double QAOACircuit::expectation(const std::vector<double>& gammas, const std::vector<double>& betas) const {
+    return energy(run(gammas, betas));
+}
+
+/*
+
+    FUNCTION: maxCutCost(qubitCount, edges, weights) / isingCost(fields, couplings, strengths):
+                the cut of edge (i, j) is w (1 - Z_i Z_j) / 2, so C(x) is the weight of the cut x,
+                the Ising energy is sum h_i Z_i + sum J_ij Z_i Z_j
+
+*/
+PauliSum QAOACircuit::maxCutCost(int qubitCount, const std::vector<std::pair<int, int>>& edges, const std::vector<double>& weights) {
+    if (!weights.empty() && weights.size() != edges.size()) {
+        throw std::invalid_argument("MaxCut needs one weight per edge");
+    }
+
+    PauliSum cost(qubitCount);
+    for (size_t k = 0; k < edges.size(); ++k) {
+        if (edges[k].first == edges[k].second) {
+            throw std::invalid_argument("MaxCut edge must join two different vertices");
+        }
+        double weight = weights.empty() ? 1.0 : weights[k];
+        cost.addTerm(weight / 2.0, 0, 0);
+        cost.addPair(-weight / 2.0, 'Z', edges[k].first, 'Z', edges[k].second);
+    }
+    return cost;
+}
+
+PauliSum QAOACircuit::isingCost(const std::vector<double>& fields, const std::vector<std::pair<int, int>>& couplings,
+    const std::vector<double>& strengths) {
+
+    if (strengths.size() != couplings.size()) {
+        throw std::invalid_argument("Ising cost needs one strength per coupling");
+    }
+
+    PauliSum cost(static_cast<int>(fields.size()));
+    for (size_t qubit = 0; qubit < fields.size(); ++qubit) {
+        if (fields[qubit] != 0.0) {
+            cost.addSingle(fields[qubit], 'Z', static_cast<int>(qubit));
+        }
+    }
+    for (size_t k = 0; k < couplings.size(); ++k) {
+        cost.addPair(strengths[k], 'Z', couplings[k].first, 'Z', couplings[k].second);
+    }
+    return cost;
+}
@@ -0,0 +1,58 @@
+#ifndef QAOA_CIRCUIT_H
+#define QAOA_CIRCUIT_H
+
+#include <utility>
+#include <vector>
+#include "PauliSum.h"
+#include "QuantumRegister.h"
+
+
+/*
+
+    QAOACircuit class
+
+    QAOA on a classical cost function C, a sum of products of Z. C is diagonal, so it is evaluated once for every
+    basis state and kept as a float table, then every layer of
+
+                    |psi(gamma, beta)> = prod_p exp(-i beta_p sum_k X_k) exp(-i gamma_p C) |+...+>
+
+    is one elementwise phase sweep for the cost and one single qubit layer for the mixer, and the energy
+    <C> = sum_x C(x) |psi_x|^2 is a single dot product. no ZZ rotation gate is ever applied
+
+*/
+class QAOACircuit {
+private:
+    int numQubits;
+    std::vector<float> costTable;   // C(x) for every basis state x
+
+public:
+    // Constructor, every term of the cost must be diagonal (no X or Y)
+    QAOACircuit(const PauliSum& cost);
+
+    // Getters
+    int getNumQubits() const { return numQubits; }
+    const std::vector<float>& getCostTable() const { return costTable; }
+    double cost(size_t basisState) const { return costTable[basisState]; }
+    double minimumCost() const;
+    double maximumCost() const;
+
+    // Layers
+    void prepareUniform(QuantumRegister& quantumRegister) const;
+    void applyCostLayer(QuantumRegister& quantumRegister, double gamma) const;
+    void applyMixerLayer(QuantumRegister& quantumRegister, double beta) const;
+
+    // Execution, starts from |+...+> with one (gamma, beta) pair per layer
+    void execute(QuantumRegister& quantumRegister, const std::vector<double>& gammas, const std::vector<double>& betas) const;
+    QuantumRegister run(const std::vector<double>& gammas, const std::vector<double>& betas) const;
+
+    //<C> of the register
+    double energy(const QuantumRegister& quantumRegister) const;
+    double expectation(const std::vector<double>& gammas, const std::vector<double>& betas) const;
+
+    // Cost functions
+    static PauliSum maxCutCost(int qubitCount, const std::vector<std::pair<int, int>>& edges, const std::vector<double>& weights = {});
+    static PauliSum isingCost(const std::vector<double>& fields, const std::vector<std::pair<int, int>>& couplings,
+        const std::vector<double>& strengths);
+};
+
+#endif // QAOA_CIRCUIT_H
@@ -0,0 +1,185 @@
+#define _USE_MATH_DEFINES
+
+#include "QuantumCircuit.h"
+#include "GateLibrary.h"
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <algorithm>
+#include <Eigen/Dense>
+
+/*
+
+    CONSTRUCTOR
+
+*/
+QuantumCircuit::QuantumCircuit(int qubitCount) : numQubits(qubitCount), numParameters(0) {
+    if (qubitCount < 1) {
+        throw std::invalid_argument("A circuit needs at least one qubit");
+    }
+}
+
+/*
+
+    FUNCTION:   checkOperation():
+                    validate the qubits touched by an operation before storing it
+
+*/
+void QuantumCircuit::checkOperation(const GateOperation& operation) const {
+    if (operation.target < 0 || operation.target >= numQubits) {
+        throw std::out_of_range("Gate target outside of the circuit");
+    }
+    if (isTwoQubit(operation.type)) {
+        if (operation.control < 0 || operation.control >= numQubits) {
+            throw std::out_of_range("Gate control outside of the circuit");
+        }
+        if (operation.control == operation.target) {
+            throw std::invalid_argument("A two qubit gate needs two different qubits");
+        }
+    }
+    if (operation.parameterIndex >= 0 && !isParametric(operation.type)) {
+        throw std::invalid_argument("Only rotation gates can be bound to a parameter");
+    }
+}
+
+/*
+
+    BUILDERS
+
+*/
+void QuantumCircuit::addOperation(const GateOperation& operation) {
+    checkOperation(operation);
+    operations.push_back(operation);
+    if (operation.parameterIndex >= 0) {
+        numParameters = std::max(numParameters, operation.parameterIndex + 1);
+    }
+}
+
+void QuantumCircuit::addGate(GateType type, int target) {
+    addOperation({ type, target, -1, 0.0, -1 });
+}
+
+void QuantumCircuit::addRotation(GateType type, int target, double angle) {
+    addOperation({ type, target, -1, angle, -1 });
+}
+
+void QuantumCircuit::addParameterizedRotation(GateType type, int target, int parameterIndex, double scale) {
+    addOperation({ type, target, -1, scale, parameterIndex });
+}
+
+void QuantumCircuit::addControlledGate(GateType type, int control, int target, double angle) {
+    addOperation({ type, target, control, angle, -1 });
+}
+
+void QuantumCircuit::addParameterizedControlledGate(GateType type, int control, int target, int parameterIndex, double scale) {
+    addOperation({ type, target, control, scale, parameterIndex });
+}
+
+void QuantumCircuit::addSwap(int qubitA, int qubitB) {
+    addOperation({ GateType::Swap, qubitA, qubitB, 0.0, -1 });
+}
+
+/*
+
+    FUNCTION: addQFT(firstQubit, count, inverse, withSwaps):
+                with the block value read little endian (firstQubit is the least significant bit)
+                the forward transform is, from the top qubit j = count-1 down to 0,
+
+                    H(j)  CP(pi/2^(j-m)) on (j, m) for m = j-1 ... 0
+
+                followed by the swaps that reverse the qubit order, the inverse is the same list reversed
+                with negated angles. the compiler recognizes this exact sequence and runs it as FFTs
+
+*/
+void QuantumCircuit::addQFT(int firstQubit, int count, bool inverse, bool withSwaps) {
+    if (count < 1 || firstQubit < 0 || firstQubit + count > numQubits) {
+        throw std::out_of_range("QFT block outside of the circuit");
+    }
+
+    for (const GateOperation& operation : qftOperations(firstQubit, count, inverse, withSwaps)) {
+        addOperation(operation);
+    }
+}
+
+std::vector<GateOperation> QuantumCircuit::qftOperations(int firstQubit, int count, bool inverse, bool withSwaps) {
+    std::vector<GateOperation> block;
+    for (int j = count - 1; j >= 0; --j) {
+        block.push_back({ GateType::Hadamard, firstQubit + j, -1, 0.0, -1 });
+        for (int m = j - 1; m >= 0; --m) {
+            block.push_back({ GateType::ControlledPhase, firstQubit + j, firstQubit + m, M_PI / static_cast<double>(1 << (j - m)), -1 });
+        }
+    }
+    if (withSwaps) {
+        for (int i = 0; i < count / 2; ++i) {
+            block.push_back({ GateType::Swap, firstQubit + i, firstQubit + count - 1 - i, 0.0, -1 });
+        }
+    }
+
+    if (inverse) {
+        std::reverse(block.begin(), block.end());
+        for (GateOperation& operation : block) {
+            operation.angle = -operation.angle;
+        }
+    }
+    return block;
+}
+
+/*
+
+    GATE CLASSIFICATION
+
+*/
+bool QuantumCircuit::isParametric(GateType type) {
+    return gateTraits(type).parametric;
+}
+
+bool QuantumCircuit::isControlled(GateType type) {
+    return gateTraits(type).controlled;
+}
+
+bool QuantumCircuit::isTwoQubit(GateType type) {
+    return gateTraits(type).qubitCount == 2;
+}
+
+/*
+
+    FUNCTION: gateMatrix(type, angle):
+                2x2 unitary of the gate, controlled gates return the operator applied to the target.
+                the fixed gates are the compile time tables of GateLibrary
+
+                    RX(a) = exp(-i a X/2)    RY(a) = exp(-i a Y/2)    RZ(a) = exp(-i a Z/2)    P(a) = diag(1, exp(i a))
+
+*/
+Eigen::Matrix2cd QuantumCircuit::gateMatrix(GateType type, double angle) {
+    switch (type) {
+    case GateType::RotationX:
+        return rotationX(angle);
+    case GateType::RotationY:
+        return rotationY(angle);
+    case GateType::RotationZ:
+        return rotationZ(angle);
+    case GateType::Phase:
+    case GateType::ControlledPhase:
+        return phaseShift(angle);
+    case GateType::Swap:
+        throw std::invalid_argument("Gate has no 2x2 representation");
+    default:
+        return toMatrix(fixedGateMatrix(type));
+    }
+}
+
+/*
+
+    FUNCTION: resolveAngle(operation, parameters):
+                constant gates keep their angle, parametric gates scale the bound parameter by it
+
+*/
+double QuantumCircuit::resolveAngle(const GateOperation& operation, const std::vector<double>& parameters) {
+    if (operation.parameterIndex < 0) {
+        return operation.angle;
+    }
+    if (operation.parameterIndex >= static_cast<int>(parameters.size())) {
+        throw std::out_of_range("Missing value for circuit parameter");
+    }
+    return operation.angle * parameters[operation.parameterIndex];
+}
@@ -0,0 +1,93 @@
+#ifndef QUANTUM_CIRCUIT_H
+#define QUANTUM_CIRCUIT_H
+
+#include <vector>
+#include <Eigen/Dense>
+
+//gates understood by the circuit layer
+enum class GateType {
+    Identity,
+    PauliX,
+    PauliY,
+    PauliZ,
+    Hadamard,
+    S,
+    SDagger,
+    T,
+    TDagger,
+    SqrtX,
+    RotationX,
+    RotationY,
+    RotationZ,
+    Phase,
+    CNOT,
+    CZ,
+    ControlledPhase,
+    Swap
+};
+
+//a single gate of the circuit
+struct GateOperation {
+    GateType type;
+    int target;
+    int control;            // control qubit (second qubit for Swap), -1 for single qubit gates
+    double angle;           // rotation angle, or scale factor of the bound parameter
+    int parameterIndex;     // -1 when the angle is constant
+};
+
+
+/*
+
+    QuantumCircuit class
+
+    ordered list of gates on numQubits qubits, parametric gates can read their angle
+    from a parameter vector that is bound only when the circuit is executed
+
+*/
+class QuantumCircuit {
+private:
+    int numQubits;
+    int numParameters;
+    std::vector<GateOperation> operations;
+
+    // Private helper method
+    void checkOperation(const GateOperation& operation) const;
+
+public:
+    // Constructor
+    QuantumCircuit(int qubitCount);
+
+    // Getters
+    int getNumQubits() const { return numQubits; }
+    int getNumParameters() const { return numParameters; }
+    const std::vector<GateOperation>& getOperations() const { return operations; }
+    size_t getGateCount() const { return operations.size(); }
+
+    // Builders
+    void addOperation(const GateOperation& operation);
+    void addGate(GateType type, int target);
+    void addRotation(GateType type, int target, double angle);
+    void addParameterizedRotation(GateType type, int target, int parameterIndex, double scale = 1.0);
+    void addControlledGate(GateType type, int control, int target, double angle = 0.0);
+    void addParameterizedControlledGate(GateType type, int control, int target, int parameterIndex, double scale = 1.0);
+    void addSwap(int qubitA, int qubitB);
+
+    //textbook QFT of the qubits [firstQubit, firstQubit + count), expanded to H, controlled phases and swaps
+    void addQFT(int firstQubit, int count, bool inverse = false, bool withSwaps = true);
+
+    //gates of the textbook QFT block, shared by addQFT and the compiler that recognizes it
+    static std::vector<GateOperation> qftOperations(int firstQubit, int count, bool inverse, bool withSwaps);
+
+    // Gate classification
+    static bool isParametric(GateType type);
+    static bool isControlled(GateType type);
+    static bool isTwoQubit(GateType type);
+
+    //2x2 matrix of a single qubit gate, or of the target part of a controlled gate
+    static Eigen::Matrix2cd gateMatrix(GateType type, double angle = 0.0);
+
+    //effective angle of an operation once the parameters are bound
+    static double resolveAngle(const GateOperation& operation, const std::vector<double>& parameters);
+};
+
+#endif // QUANTUM_CIRCUIT_H
@@ -0,0 +1,909 @@
+#define _USE_MATH_DEFINES
+
+#include "QuantumRegister.h"
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <complex>
+#include <string>
+#include <Eigen/Dense>
+#include "BitUtils.h"
+#include "ParallelUtils.h"
+
+//out of class definition, std::min in applySingleQubitLayer binds the constant to a reference
+constexpr int QuantumRegister::LAYER_SEGMENT_QUBITS;
+
+/*
+
+    FUNCTION:   checkQubitIndex():
+                    throw if the qubit is not part of the register
+
+*/
+void QuantumRegister::checkQubitIndex(int qubit) const {
+    if (qubit < 0 || qubit >= numQubits) {
+        throw std::out_of_range("Qubit index outside of the register");
+    }
+}
+
+/*
+
+    CONSTRUCTORS
+
+*/
+QuantumRegister::QuantumRegister(int qubitCount) : numQubits(qubitCount) {
+    if (qubitCount < 1 || qubitCount > MAX_QUBITS) {
+        throw std::invalid_argument("QuantumRegister supports between 1 and " + std::to_string(MAX_QUBITS) + " qubits");
+    }
+    amplitudes = Eigen::VectorXcd::Zero(static_cast<Eigen::Index>(1) << qubitCount);
+    amplitudes(0) = 1.0;
+}
+
+QuantumRegister::QuantumRegister(const Eigen::VectorXcd& initialAmplitudes) : numQubits(0) {
+    setState(initialAmplitudes);
+}
+
+/*
+
+    FUNCTION: reset() / setState():
+                reset brings the register back to |0...0> reusing the allocated memory,
+                setState loads a normalized state vector whose size must be a power of two, at most 2^MAX_QUBITS
+
+*/
+void QuantumRegister::reset() {
+    amplitudes.setZero();
+    amplitudes(0) = 1.0;
+}
+
+void QuantumRegister::setState(const Eigen::VectorXcd& newAmplitudes) {
+    Eigen::Index size = newAmplitudes.size();
+    if (size < 2 || (size & (size - 1)) != 0) {
+        throw std::invalid_argument("State vector size must be a power of two");
+    }
+    if (size > (static_cast<Eigen::Index>(1) << MAX_QUBITS)) {
+        throw std::invalid_argument("QuantumRegister supports between 1 and " + std::to_string(MAX_QUBITS) + " qubits");
+    }
+    if (std::abs(newAmplitudes.squaredNorm() - 1.0) > 1e-10) {
+        throw std::invalid_argument("State vector does not satisfy normalization condition");
+    }
+
+    int qubits = 0;
+    while ((static_cast<Eigen::Index>(1) << qubits) < size) {
+        ++qubits;
+    }
+    numQubits = qubits;
+    amplitudes = newAmplitudes;
+}
+
+/*
+
+    FUNCTION: applySingleQubitGate(target, gate):
+                the amplitudes are visited in pairs (i0, i1) that differ only in the target bit,
+                pair k is obtained by inserting a zero at the target position of k
+
+                             |a'|   | g00 g01 | |a(i0)|
+                             |b'| = | g10 g11 | |a(i1)|
+
+*/
+void QuantumRegister::applySingleQubitGate(int target, const Eigen::Matrix2cd& gate) {
+    checkQubitIndex(target);
+
+    const size_t stride = static_cast<size_t>(1) << target;
+    const size_t lowMask = stride - 1;
+    const size_t pairs = getDimension() >> 1;
+    const std::complex<double> g00 = gate(0, 0), g01 = gate(0, 1), g10 = gate(1, 0), g11 = gate(1, 1);
+    std::complex<double>* data = amplitudes.data();
+
+    auto sweep = [=](size_t first, size_t last) {
+        for (size_t k = first; k < last; ++k) {
+            size_t i0 = ((k & ~lowMask) << 1) | (k & lowMask);
+            size_t i1 = i0 | stride;
+            std::complex<double> a = data[i0];
+            std::complex<double> b = data[i1];
+            data[i0] = g00 * a + g01 * b;
+            data[i1] = g10 * a + g11 * b;
+        }
+    };
+
+    if (numQubits >= PARALLEL_QUBIT_THRESHOLD) {
+        parallelFor(0, pairs, pairs / parallelWorkerCount() + 1, sweep);
+    }
+    else {
+        sweep(0, pairs);
+    }
+}
+
+/*
+
+    FUNCTION: applyControlledGate(control, target, gate):
+                same pair sweep of the single qubit gate restricted to the pairs whose control bit is set
+
+*/
+void QuantumRegister::applyControlledGate(int control, int target, const Eigen::Matrix2cd& gate) {
+    checkQubitIndex(control);
+    checkQubitIndex(target);
+    if (control == target) {
+        throw std::invalid_argument("Control and target qubits must be different");
+    }
+
+    const size_t stride = static_cast<size_t>(1) << target;
+    const size_t controlMask = static_cast<size_t>(1) << control;
+    const size_t lowMask = stride - 1;
+    const size_t pairs = getDimension() >> 1;
+    const std::complex<double> g00 = gate(0, 0), g01 = gate(0, 1), g10 = gate(1, 0), g11 = gate(1, 1);
+    std::complex<double>* data = amplitudes.data();
+
+    auto sweep = [=](size_t first, size_t last) {
+        for (size_t k = first; k < last; ++k) {
+            size_t i0 = ((k & ~lowMask) << 1) | (k & lowMask);
+            if ((i0 & controlMask) == 0) {
+                continue;
+            }
+            size_t i1 = i0 | stride;
+            std::complex<double> a = data[i0];
+            std::complex<double> b = data[i1];
+            data[i0] = g00 * a + g01 * b;
+            data[i1] = g10 * a + g11 * b;
+        }
+    };
+
+    if (numQubits >= PARALLEL_QUBIT_THRESHOLD) {
+        parallelFor(0, pairs, pairs / parallelWorkerCount() + 1, sweep);
+    }
+    else {
+        sweep(0, pairs);
+    }
+}
+
+/*
+
+    FUNCTION: applySwap(qubitA, qubitB):
+                exchange the amplitudes of the basis states where the two bits differ (01 <-> 10)
+
+*/
+void QuantumRegister::applySwap(int qubitA, int qubitB) {
+    checkQubitIndex(qubitA);
+    checkQubitIndex(qubitB);
+    if (qubitA == qubitB) {
+        return;
+    }
+
+    const size_t maskA = static_cast<size_t>(1) << qubitA;
+    const size_t maskB = static_cast<size_t>(1) << qubitB;
+    const size_t dimension = getDimension();
+    std::complex<double>* data = amplitudes.data();
+
+    auto sweep = [=](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            //visit every pair once from its |..1..0..> member (bit A set, bit B clear)
+            if ((i & maskA) != 0 && (i & maskB) == 0) {
+                std::swap(data[i], data[(i & ~maskA) | maskB]);
+            }
+        }
+    };
+
+    if (numQubits >= PARALLEL_QUBIT_THRESHOLD) {
+        parallelFor(0, dimension, dimension / parallelWorkerCount() + 1, sweep);
+    }
+    else {
+        sweep(0, dimension);
+    }
+}
+
+/*
+
+    FUNCTION: applyDiagonalGate(target, d0, d1, control):
+                a diagonal gate never mixes the pair, so each amplitude is only scaled. the usual case d0 = 1
+                (Z, S, T, phase gates) reads and writes the |1> half of the pairs only. with a control the
+                quarters with both bits set are visited directly by inserting a zero at both positions
+
+*/
+void QuantumRegister::applyDiagonalGate(int target, std::complex<double> d0, std::complex<double> d1, int control) {
+    checkQubitIndex(target);
+    if (control >= 0) {
+        checkQubitIndex(control);
+        if (control == target) {
+            throw std::invalid_argument("Control and target qubits must be different");
+        }
+    }
+
+    const size_t stride = static_cast<size_t>(1) << target;
+    const size_t controlMask = control >= 0 ? static_cast<size_t>(1) << control : 0;
+    const int lowQubit = control >= 0 ? std::min(target, control) : target;
+    const int highQubit = control >= 0 ? std::max(target, control) : target;
+    const size_t lowMask = (static_cast<size_t>(1) << lowQubit) - 1;
+    const size_t highMask = (static_cast<size_t>(1) << highQubit) - 1;
+    const size_t groups = getDimension() >> (control >= 0 ? 2 : 1);
+    const bool onlyOne = d0 == std::complex<double>(1.0, 0.0);
+    std::complex<double>* data = amplitudes.data();
+
+    auto sweep = [=](size_t first, size_t last) {
+        for (size_t k = first; k < last; ++k) {
+            size_t i0 = ((k & ~lowMask) << 1) | (k & lowMask);
+            if (controlMask != 0) {
+                i0 = (((i0 & ~highMask) << 1) | (i0 & highMask)) | controlMask;
+            }
+            if (!onlyOne) {
+                data[i0] *= d0;
+            }
+            data[i0 | stride] *= d1;
+        }
+    };
+
+    if (numQubits >= PARALLEL_QUBIT_THRESHOLD) {
+        parallelFor(0, groups, groups / parallelWorkerCount() + 1, sweep);
+    }
+    else {
+        sweep(0, groups);
+    }
+}
+
+/*
+
+    FUNCTION: applyAntiDiagonalGate(target, upper, lower):
+                the pair is exchanged and scaled, a' = upper b and b' = lower a
+
+*/
+void QuantumRegister::applyAntiDiagonalGate(int target, std::complex<double> upper, std::complex<double> lower) {
+    checkQubitIndex(target);
+
+    const size_t stride = static_cast<size_t>(1) << target;
+    const size_t lowMask = stride - 1;
+    const size_t pairs = getDimension() >> 1;
+    std::complex<double>* data = amplitudes.data();
+
+    auto sweep = [=](size_t first, size_t last) {
+        for (size_t k = first; k < last; ++k) {
+            size_t i0 = ((k & ~lowMask) << 1) | (k & lowMask);
+            size_t i1 = i0 | stride;
+            std::complex<double> a = data[i0];
+            data[i0] = upper * data[i1];
+            data[i1] = lower * a;
+        }
+    };
+
+    if (numQubits >= PARALLEL_QUBIT_THRESHOLD) {
+        parallelFor(0, pairs, pairs / parallelWorkerCount() + 1, sweep);
+    }
+    else {
+        sweep(0, pairs);
+    }
+}
+
+/*
+
+    FUNCTION: applyGate(operation):
+                runtime counterpart of applyGate<Type>, the kernel comes from the GateLibrary table
+                instead of looking at the entries of the matrix
+
+*/
+void QuantumRegister::applyGate(const GateOperation& operation) {
+    if (operation.parameterIndex >= 0) {
+        throw std::invalid_argument("Gate needs a constant angle");
+    }
+
+    const GateTraits traits = gateTraits(operation.type);
+    switch (traits.kernel) {
+    case GateKernel::Identity:
+        break;
+    case GateKernel::Diagonal: {
+        const std::array<std::complex<double>, 2> entries = diagonalEntries(operation.type, operation.angle);
+        applyDiagonalGate(operation.target, entries[0], entries[1]);
+        break;
+    }
+    case GateKernel::AntiDiagonal: {
+        const FixedGateMatrix entries = fixedGateMatrix(operation.type);
+        applyAntiDiagonalGate(operation.target, entries[1], entries[2]);
+        break;
+    }
+    case GateKernel::Dense:
+        applySingleQubitGate(operation.target, QuantumCircuit::gateMatrix(operation.type, operation.angle));
+        break;
+    case GateKernel::Controlled:
+        if (traits.diagonal) {
+            const std::array<std::complex<double>, 2> entries = diagonalEntries(operation.type, operation.angle);
+            applyDiagonalGate(operation.target, entries[0], entries[1], operation.control);
+        }
+        else {
+            applyControlledGate(operation.control, operation.target, QuantumCircuit::gateMatrix(operation.type, operation.angle));
+        }
+        break;
+    case GateKernel::Swap:
+        applySwap(operation.target, operation.control);
+        break;
+    }
+}
+
+/*
+
+    FUNCTION: applyMultiQubitGate(qubits, gate):
+                the 2^k amplitudes that differ only in the gate qubits are gathered, multiplied and scattered back,
+                group k is obtained by depositing the bits of k on the qubits outside of the gate
+
+*/
+void QuantumRegister::applyMultiQubitGate(const std::vector<int>& qubits, const Eigen::MatrixXcd& gate) {
+    size_t mask = 0;
+    for (int qubit : qubits) {
+        checkQubitIndex(qubit);
+        if ((mask >> qubit) & 1) {
+            throw std::invalid_argument("Gate qubits must be distinct");
+        }
+        mask |= static_cast<size_t>(1) << qubit;
+    }
+    const size_t size = static_cast<size_t>(1) << qubits.size();
+    if (qubits.empty() || static_cast<size_t>(gate.rows()) != size || static_cast<size_t>(gate.cols()) != size) {
+        throw std::invalid_argument("Gate size does not match its qubits");
+    }
+
+    std::vector<size_t> offsets(size, 0);
+    for (size_t s = 0; s < size; ++s) {
+        for (size_t j = 0; j < qubits.size(); ++j) {
+            if ((s >> j) & 1) {
+                offsets[s] |= static_cast<size_t>(1) << qubits[j];
+            }
+        }
+    }
+
+    const size_t groups = getDimension() / size;
+    std::complex<double>* data = amplitudes.data();
+
+    auto sweep = [&](size_t first, size_t last) {
+        Eigen::VectorXcd buffer(static_cast<Eigen::Index>(size));
+        Eigen::VectorXcd result(static_cast<Eigen::Index>(size));
+
+        //base of the first group of the chunk, the following ones come from the increment that skips the gate bits
+        size_t base = 0;
+        size_t remaining = first;
+        for (size_t bit = 1; remaining != 0; bit <<= 1) {
+            if ((mask & bit) == 0) {
+                if ((remaining & 1) != 0) {
+                    base |= bit;
+                }
+                remaining >>= 1;
+            }
+        }
+
+        for (size_t group = first; group < last; ++group) {
+            for (size_t s = 0; s < size; ++s) {
+                buffer(static_cast<Eigen::Index>(s)) = data[base + offsets[s]];
+            }
+            result.noalias() = gate * buffer;
+            for (size_t s = 0; s < size; ++s) {
+                data[base + offsets[s]] = result(static_cast<Eigen::Index>(s));
+            }
+            base = ((base | mask) + 1) & ~mask;
+        }
+    };
+
+    if (numQubits >= PARALLEL_QUBIT_THRESHOLD) {
+        parallelFor(0, groups, groups / parallelWorkerCount() + 1, sweep);
+    }
+    else {
+        sweep(0, groups);
+    }
+}
+
+/*
+
+    FUNCTION: applySingleQubitLayer(targets, gates):
+                a layer of gates on distinct qubits commutes, so the order inside the layer is free.
+                the register is cut in blocks, each one made of the 2^h contiguous segments of 2^s amplitudes
+                that the h high targets (qubit >= s) connect, the low targets act inside every segment.
+                a block is small enough to stay in cache while every gate of the layer is applied to it,
+                so the whole layer costs one pass over memory instead of one sweep per gate.
+                layers with more high targets than a block can hold are split in a few passes
+
+*/
+void QuantumRegister::applySingleQubitLayer(const std::vector<int>& targets, const std::vector<Eigen::Matrix2cd>& gates) {
+    if (targets.size() != gates.size()) {
+        throw std::invalid_argument("Every target of the layer needs its own gate");
+    }
+    size_t usedMask = 0;
+    for (int target : targets) {
+        checkQubitIndex(target);
+        size_t bit = static_cast<size_t>(1) << target;
+        if ((usedMask & bit) != 0) {
+            throw std::invalid_argument("Gates of a layer must act on distinct qubits");
+        }
+        usedMask |= bit;
+    }
+    if (targets.size() == 1) {
+        applySingleQubitGate(targets[0], gates[0]);
+        return;
+    }
+
+    const int segmentQubits = std::min(LAYER_SEGMENT_QUBITS, numQubits);
+    const size_t highPerPass = static_cast<size_t>(std::max(1, LAYER_BLOCK_QUBITS - segmentQubits));
+
+    std::vector<int> lowTargets, highTargets;
+    std::vector<Eigen::Matrix2cd> lowGates, highGates;
+    for (size_t k = 0; k < targets.size(); ++k) {
+        if (targets[k] < segmentQubits) {
+            lowTargets.push_back(targets[k]);
+            lowGates.push_back(gates[k]);
+        }
+        else {
+            highTargets.push_back(targets[k]);
+            highGates.push_back(gates[k]);
+        }
+    }
+
+    //the low gates ride along with the first pass
+    size_t first = 0;
+    do {
+        size_t last = std::min(highTargets.size(), first + highPerPass);
+        std::vector<int> passTargets(highTargets.begin() + first, highTargets.begin() + last);
+        std::vector<Eigen::Matrix2cd> passGates(highGates.begin() + first, highGates.begin() + last);
+        if (first == 0) {
+            applyLayerPass(lowTargets, lowGates, passTargets, passGates, segmentQubits);
+        }
+        else {
+            applyLayerPass({}, {}, passTargets, passGates, segmentQubits);
+        }
+        first = last;
+    } while (first < highTargets.size());
+}
+
+void QuantumRegister::applyLayerPass(const std::vector<int>& lowTargets, const std::vector<Eigen::Matrix2cd>& lowGates,
+    const std::vector<int>& highTargets, const std::vector<Eigen::Matrix2cd>& highGates, int segmentQubits) {
+
+    const size_t segment = static_cast<size_t>(1) << segmentQubits;
+    const size_t segmentsPerBlock = static_cast<size_t>(1) << highTargets.size();
+    const size_t blocks = getDimension() / (segment * segmentsPerBlock);
+
+    size_t highMask = 0;
+    for (int target : highTargets) {
+        highMask |= static_cast<size_t>(1) << target;
+    }
+    //bits that stay fixed inside a block, the block bases run over all the others
+    const size_t fixedMask = highMask | (segment - 1);
+
+    //offset of every segment of a block, the bits of s are spread over the high targets
+    std::vector<size_t> offsets(segmentsPerBlock, 0);
+    for (size_t s = 0; s < segmentsPerBlock; ++s) {
+        for (size_t j = 0; j < highTargets.size(); ++j) {
+            if ((s >> j) & 1) {
+                offsets[s] |= static_cast<size_t>(1) << highTargets[j];
+            }
+        }
+    }
+
+    std::complex<double>* data = amplitudes.data();
+
+    auto sweep = [&](size_t firstBlock, size_t lastBlock) {
+        //base of the first block, the bits of its index go in the free positions from the lowest up
+        size_t base = 0;
+        size_t index = firstBlock;
+        for (int bit = segmentQubits; bit < numQubits && index != 0; ++bit) {
+            if ((fixedMask >> bit) & 1) {
+                continue;
+            }
+            base |= (index & 1) << bit;
+            index >>= 1;
+        }
+
+        for (size_t block = firstBlock; block < lastBlock; ++block) {
+            for (size_t s = 0; s < segmentsPerBlock; ++s) {
+                std::complex<double>* segmentData = data + base + offsets[s];
+                for (size_t g = 0; g < lowTargets.size(); ++g) {
+                    const size_t stride = static_cast<size_t>(1) << lowTargets[g];
+                    const size_t lowMask = stride - 1;
+                    const std::complex<double> g00 = lowGates[g](0, 0), g01 = lowGates[g](0, 1), g10 = lowGates[g](1, 0), g11 = lowGates[g](1, 1);
+                    for (size_t k = 0; k < segment / 2; ++k) {
+                        size_t i0 = ((k & ~lowMask) << 1) | (k & lowMask);
+                        std::complex<double> a = segmentData[i0];
+                        std::complex<double> b = segmentData[i0 | stride];
+                        segmentData[i0] = g00 * a + g01 * b;
+                        segmentData[i0 | stride] = g10 * a + g11 * b;
+                    }
+                }
+            }
+
+            for (size_t j = 0; j < highTargets.size(); ++j) {
+                const size_t bit = static_cast<size_t>(1) << j;
+                const std::complex<double> g00 = highGates[j](0, 0), g01 = highGates[j](0, 1), g10 = highGates[j](1, 0), g11 = highGates[j](1, 1);
+                for (size_t s = 0; s < segmentsPerBlock; ++s) {
+                    if ((s & bit) != 0) {
+                        continue;
+                    }
+                    std::complex<double>* zero = data + base + offsets[s];
+                    std::complex<double>* one = data + base + offsets[s | bit];
+                    for (size_t t = 0; t < segment; ++t) {
+                        std::complex<double> a = zero[t];
+                        std::complex<double> b = one[t];
+                        zero[t] = g00 * a + g01 * b;
+                        one[t] = g10 * a + g11 * b;
+                    }
+                }
+            }
+
+            base = ((base | fixedMask) + 1) & ~fixedMask;
+        }
+    };
+
+    if (numQubits >= PARALLEL_QUBIT_THRESHOLD) {
+        parallelFor(0, blocks, 1, sweep);
+    }
+    else {
+        sweep(0, blocks);
+    }
+}
+
+/*
+
+    FUNCTION: applyDiagonalPhases(zMasks, angles):
+                a product of Z operators is diagonal with entries (-1)^(popcount(i & zMask)), so a whole set of
+                commuting Z strings multiplies every amplitude by a single phase
+
+                    a_i -> exp(-i sum_k angle_k (-1)^(popcount(i & zMask_k))) a_i
+
+*/
+void QuantumRegister::applyDiagonalPhases(const std::vector<std::uint64_t>& zMasks, const std::vector<double>& angles) {
+    if (zMasks.size() != angles.size()) {
+        throw std::invalid_argument("Every Z string needs its own angle");
+    }
+    for (std::uint64_t zMask : zMasks) {
+        if ((zMask >> numQubits) != 0) {
+            throw std::out_of_range("Z string acts on a qubit outside of the register");
+        }
+    }
+
+    const size_t dimension = getDimension();
+    std::complex<double>* data = amplitudes.data();
+
+    auto sweep = [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            double phase = 0.0;
+            for (size_t k = 0; k < zMasks.size(); ++k) {
+                phase += bitParity(i & zMasks[k]) ? angles[k] : -angles[k];
+            }
+            data[i] *= std::polar(1.0, phase);
+        }
+    };
+
+    if (numQubits >= PARALLEL_QUBIT_THRESHOLD) {
+        parallelFor(0, dimension, dimension / parallelWorkerCount() + 1, sweep);
+    }
+    else {
+        sweep(0, dimension);
+    }
+}
+
+/*
+
+    FUNCTION: fourierTransform(buffer, size, twiddles, inverse):
+                iterative radix-2 FFT of a power of two buffer, the sign convention is the one of the QFT
+
+                    y_k = 1/sqrt(K) sum_x exp(+2 pi i x k / K) a_x
+
+                twiddles holds exp(+2 pi i j / K) for j < K/2 and is conjugated for the inverse transform
+
+*/
+static void fourierTransform(std::complex<double>* buffer, size_t size, const std::vector<std::complex<double>>& twiddles, bool inverse) {
+    //bit reversal reordering
+    for (size_t i = 1, j = 0; i < size; ++i) {
+        size_t bit = size >> 1;
+        for (; (j & bit) != 0; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            std::swap(buffer[i], buffer[j]);
+        }
+    }
+
+    //butterflies
+    for (size_t length = 2; length <= size; length <<= 1) {
+        const size_t half = length >> 1;
+        const size_t step = size / length;
+        for (size_t start = 0; start < size; start += length) {
+            for (size_t k = 0; k < half; ++k) {
+                std::complex<double> twiddle = inverse ? std::conj(twiddles[k * step]) : twiddles[k * step];
+                std::complex<double> even = buffer[start + k];
+                std::complex<double> odd = buffer[start + k + half] * twiddle;
+                buffer[start + k] = even + odd;
+                buffer[start + k + half] = even - odd;
+            }
+        }
+    }
+
+    const double normalization = 1.0 / std::sqrt(static_cast<double>(size));
+    for (size_t i = 0; i < size; ++i) {
+        buffer[i] *= normalization;
+    }
+}
+
+/*
+
+    FUNCTION: applyQFT(firstQubit, count, inverse):
+                the value x of the block of qubits is a digit of the basis index with stride 2^firstQubit,
+                so the QFT is one DFT of length K = 2^count for every value of the other qubits.
+                each DFT gathers its K amplitudes, runs in cache and scatters them back, when the block starts
+                at qubit 0 the amplitudes are already contiguous and are transformed in place
+
+*/
+void QuantumRegister::applyQFT(int firstQubit, int count, bool inverse) {
+    if (count < 1 || firstQubit < 0 || firstQubit + count > numQubits) {
+        throw std::out_of_range("QFT block outside of the register");
+    }
+
+    const size_t size = static_cast<size_t>(1) << count;
+    const size_t stride = static_cast<size_t>(1) << firstQubit;
+    const size_t batches = getDimension() / size;
+    std::complex<double>* data = amplitudes.data();
+
+    std::vector<std::complex<double>> twiddles(size / 2);
+    for (size_t j = 0; j < twiddles.size(); ++j) {
+        double angle = 2.0 * M_PI * static_cast<double>(j) / static_cast<double>(size);
+        twiddles[j] = std::complex<double>(std::cos(angle), std::sin(angle));
+    }
+
+    auto sweep = [&](size_t first, size_t last) {
+        std::vector<std::complex<double>> buffer(stride == 1 ? 0 : size);
+        for (size_t batch = first; batch < last; ++batch) {
+            const size_t low = batch & (stride - 1);
+            const size_t high = batch >> firstQubit;
+            const size_t base = (high << (firstQubit + count)) | low;
+
+            if (stride == 1) {
+                fourierTransform(data + base, size, twiddles, inverse);
+                continue;
+            }
+
+            for (size_t x = 0; x < size; ++x) {
+                buffer[x] = data[base + x * stride];
+            }
+            fourierTransform(buffer.data(), size, twiddles, inverse);
+            for (size_t x = 0; x < size; ++x) {
+                data[base + x * stride] = buffer[x];
+            }
+        }
+    };
+
+    if (numQubits >= PARALLEL_QUBIT_THRESHOLD) {
+        parallelFor(0, batches, 1, sweep);
+    }
+    else {
+        sweep(0, batches);
+    }
+}
+
+/*
+
+    FUNCTION: measure(qubit, random) / resetQubit(qubit, random) / collapse(qubit, outcome, probability):
+                the outcome is 1 when random < P(1). collapse and renormalization share one pass over the pairs,
+                the discarded half is zeroed while the kept one is scaled by 1 / sqrt(p). a reset is a measurement
+                whose kept half is written on the |0> side, so a qubit found in |1> costs no extra X sweep
+
+*/
+int QuantumRegister::sampleOutcome(int qubit, double random, double& probability) const {
+    const double probabilityOfOne = probabilityOne(qubit);
+    const int outcome = random < probabilityOfOne ? 1 : 0;
+    probability = outcome == 1 ? probabilityOfOne : 1.0 - probabilityOfOne;
+    return outcome;
+}
+
+int QuantumRegister::measure(int qubit, double random) {
+    double probability = 0.0;
+    const int outcome = sampleOutcome(qubit, random, probability);
+    collapsePairs(qubit, outcome, probability, false);
+    return outcome;
+}
+
+void QuantumRegister::resetQubit(int qubit, double random) {
+    double probability = 0.0;
+    const int outcome = sampleOutcome(qubit, random, probability);
+    collapsePairs(qubit, outcome, probability, true);
+}
+
+void QuantumRegister::collapse(int qubit, int outcome, double probability) {
+    checkQubitIndex(qubit);
+    if (outcome != 0 && outcome != 1) {
+        throw std::invalid_argument("Measurement outcome must be 0 or 1");
+    }
+    collapsePairs(qubit, outcome, probability, false);
+}
+
+void QuantumRegister::collapsePairs(int qubit, int outcome, double probability, bool moveToZero) {
+    if (probability <= 0.0) {
+        throw std::logic_error("Measurement outcome has zero probability");
+    }
+
+    const size_t stride = static_cast<size_t>(1) << qubit;
+    const size_t lowMask = stride - 1;
+    const size_t pairs = getDimension() >> 1;
+    const double scale = 1.0 / std::sqrt(probability);
+    std::complex<double>* data = amplitudes.data();
+
+    auto sweep = [=](size_t first, size_t last) {
+        for (size_t k = first; k < last; ++k) {
+            size_t i0 = ((k & ~lowMask) << 1) | (k & lowMask);
+            size_t i1 = i0 | stride;
+            std::complex<double> kept = scale * data[outcome == 1 ? i1 : i0];
+            if (moveToZero || outcome == 0) {
+                data[i0] = kept;
+                data[i1] = 0.0;
+            }
+            else {
+                data[i0] = 0.0;
+                data[i1] = kept;
+            }
+        }
+    };
+
+    if (numQubits >= PARALLEL_QUBIT_THRESHOLD) {
+        parallelFor(0, pairs, pairs / parallelWorkerCount() + 1, sweep);
+    }
+    else {
+        sweep(0, pairs);
+    }
+}
+
+/*
+
+    FUNCTION: measureAndDiscard(qubit, random):
+                the kept half is gathered, renormalized, into a vector of half the size: amplitude k of the
+                smaller register is the one whose index is k with the outcome inserted at the qubit position.
+                the old vector is released when the new one takes its place
+
+*/
+int QuantumRegister::measureAndDiscard(int qubit, double random) {
+    checkQubitIndex(qubit);
+    if (numQubits == 1) {
+        throw std::logic_error("The last qubit of a register cannot be discarded");
+    }
+
+    double probability = 0.0;
+    const int outcome = sampleOutcome(qubit, random, probability);
+    if (probability <= 0.0) {
+        throw std::logic_error("Measurement outcome has zero probability");
+    }
+
+    const size_t stride = static_cast<size_t>(1) << qubit;
+    const size_t lowMask = stride - 1;
+    const size_t offset = outcome == 1 ? stride : 0;
+    const size_t pairs = getDimension() >> 1;
+    const double scale = 1.0 / std::sqrt(probability);
+    Eigen::VectorXcd remaining(static_cast<Eigen::Index>(pairs));
+    const std::complex<double>* source = amplitudes.data();
+    std::complex<double>* destination = remaining.data();
+
+    auto sweep = [=](size_t first, size_t last) {
+        for (size_t k = first; k < last; ++k) {
+            destination[k] = scale * source[(((k & ~lowMask) << 1) | (k & lowMask)) | offset];
+        }
+    };
+
+    if (numQubits >= PARALLEL_QUBIT_THRESHOLD) {
+        parallelFor(0, pairs, pairs / parallelWorkerCount() + 1, sweep);
+    }
+    else {
+        sweep(0, pairs);
+    }
+
+    amplitudes.swap(remaining);
+    --numQubits;
+    return outcome;
+}
+
+/*
+
+    FUNCTION: probabilityOne(qubit) / expectationZ(qubit) / probabilities():
+                marginal probability of reading 1 on a qubit, <Z> = P(0) - P(1) and the full distribution |a_i|^2
+
+*/
+double QuantumRegister::probabilityOne(int qubit) const {
+    checkQubitIndex(qubit);
+
+    const size_t mask = static_cast<size_t>(1) << qubit;
+    double probability = 0.0;
+    for (size_t i = 0; i < getDimension(); ++i) {
+        if ((i & mask) != 0) {
+            probability += std::norm(amplitudes(static_cast<Eigen::Index>(i)));
+        }
+    }
+    return probability;
+}
+
+double QuantumRegister::expectationZ(int qubit) const {
+    return 1.0 - 2.0 * probabilityOne(qubit);
+}
+
+Eigen::VectorXd QuantumRegister::probabilities() const {
+    return amplitudes.cwiseAbs2();
+}
+
+/*
+
+    FUNCTION: marginalProbabilities(qubitCount):
+                the outcome of the low qubits is i & (2^qubitCount - 1), so the histogram is one sweep that adds
+                |a_i|^2 into its bin. the register is cut in a few blocks per worker, every block fills a private
+                histogram and they are added together in block order at the end
+
+*/
+Eigen::VectorXd QuantumRegister::marginalProbabilities(int qubitCount) const {
+    if (qubitCount < 1 || qubitCount > numQubits) {
+        throw std::out_of_range("Marginal needs between one qubit and the whole register");
+    }
+
+    const size_t dimension = getDimension();
+    const size_t binMask = (static_cast<size_t>(1) << qubitCount) - 1;
+    const size_t blocks = numQubits >= PARALLEL_QUBIT_THRESHOLD ? parallelWorkerCount() * PARALLEL_CHUNKS_PER_WORKER : 1;
+    const size_t blockSize = (dimension + blocks - 1) / blocks;
+    const std::complex<double>* data = amplitudes.data();
+    std::vector<Eigen::VectorXd> partial(blocks, Eigen::VectorXd::Zero(static_cast<Eigen::Index>(binMask + 1)));
+
+    parallelFor(0, blocks, 1, [&](size_t firstBlock, size_t lastBlock) {
+        for (size_t block = firstBlock; block < lastBlock; ++block) {
+            double* bins = partial[block].data();
+            const size_t end = std::min(dimension, (block + 1) * blockSize);
+            for (size_t i = block * blockSize; i < end; ++i) {
+                bins[i & binMask] += std::norm(data[i]);
+            }
+        }
+    });
+
+    Eigen::VectorXd result = partial[0];
+    for (size_t block = 1; block < blocks; ++block) {
+        result += partial[block];
+    }
+    return result;
+}
+
+/*
+
+    FUNCTION: reducedBlochVectors():
+                the reduced density matrix of qubit q only needs two sums over the amplitudes
+
+                    rho00 - rho11 = sum_i (-1)^(bit q of i) |a_i|^2          rho01 = sum_(bit q of i = 0) a_i conj(a_(i + 2^q))
+
+                and the Bloch vector is (2 Re(rho01), -2 Im(rho01), rho00 - rho11), its length drops below one
+                when the qubit is entangled with the rest of the register. every index contributes to all the qubits
+                at once so the register is read in a single sweep instead of one partial trace per qubit. the register
+                is cut in a few blocks per worker, each block accumulates a private copy of the sums that are added
+                together in block order at the end
+
+*/
+std::vector<Eigen::Vector3d> QuantumRegister::reducedBlochVectors() const {
+    const size_t dimension = getDimension();
+    const size_t blocks = numQubits >= PARALLEL_QUBIT_THRESHOLD ? parallelWorkerCount() * PARALLEL_CHUNKS_PER_WORKER : 1;
+    const size_t blockSize = (dimension + blocks - 1) / blocks;
+    const std::complex<double>* data = amplitudes.data();
+    const int qubits = numQubits;
+
+    std::vector<std::vector<std::complex<double>>> coherences(blocks, std::vector<std::complex<double>>(qubits));
+    std::vector<std::vector<double>> populations(blocks, std::vector<double>(qubits));
+
+    parallelFor(0, blocks, 1, [&](size_t firstBlock, size_t lastBlock) {
+        for (size_t block = firstBlock; block < lastBlock; ++block) {
+            std::complex<double>* coherence = coherences[block].data();
+            double* population = populations[block].data();
+            size_t begin = block * blockSize;
+            size_t end = std::min(dimension, begin + blockSize);
+
+            for (size_t i = begin; i < end; ++i) {
+                const std::complex<double> amplitude = data[i];
+                const double probability = std::norm(amplitude);
+                for (int q = 0; q < qubits; ++q) {
+                    const size_t mask = static_cast<size_t>(1) << q;
+                    if ((i & mask) == 0) {
+                        population[q] += probability;
+                        coherence[q] += amplitude * std::conj(data[i | mask]);
+                    }
+                    else {
+                        population[q] -= probability;
+                    }
+                }
+            }
+        }
+    });
+
+    std::vector<Eigen::Vector3d> blochVectors(qubits, Eigen::Vector3d::Zero());
+    for (size_t block = 0; block < blocks; ++block) {
+        for (int q = 0; q < qubits; ++q) {
+            blochVectors[q] += Eigen::Vector3d(2.0 * coherences[block][q].real(),
+                -2.0 * coherences[block][q].imag(),
+                populations[block][q]);
+        }
+    }
+    return blochVectors;
+}
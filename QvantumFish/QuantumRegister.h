@@ -0,0 +1,150 @@
+#ifndef QUANTUM_REGISTER_H
+#define QUANTUM_REGISTER_H
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <Eigen/Dense>
+#include "GateLibrary.h"
+
+
+/*
+
+    QuantumRegister class
+
+    state vector of N qubits, qubit k is bit k of the basis index
+    so |q(N-1) ... q1 q0> is stored at index sum(qk * 2^k)
+
+*/
+class QuantumRegister {
+private:
+    int numQubits;
+    Eigen::VectorXcd amplitudes;
+
+    // Private helper methods
+    void checkQubitIndex(int qubit) const;
+    int sampleOutcome(int qubit, double random, double& probability) const;
+    void collapsePairs(int qubit, int outcome, double probability, bool moveToZero);
+    void applyLayerPass(const std::vector<int>& lowTargets, const std::vector<Eigen::Matrix2cd>& lowGates,
+        const std::vector<int>& highTargets, const std::vector<Eigen::Matrix2cd>& highGates, int segmentQubits);
+
+    //one overload per GateKernel, selected by the tag of the gate type at compile time
+    template <GateType Type>
+    void applyKernel(KernelTag<GateKernel::Identity>, int, int, double) {}
+
+    template <GateType Type>
+    void applyKernel(KernelTag<GateKernel::Diagonal>, int target, int, double angle) {
+        const std::array<std::complex<double>, 2> entries = diagonalEntries(Type, angle);
+        applyDiagonalGate(target, entries[0], entries[1]);
+    }
+
+    template <GateType Type>
+    void applyKernel(KernelTag<GateKernel::AntiDiagonal>, int target, int, double) {
+        constexpr FixedGateMatrix entries = fixedGateMatrix(Type);
+        applyAntiDiagonalGate(target, entries[1], entries[2]);
+    }
+
+    template <GateType Type>
+    void applyKernel(KernelTag<GateKernel::Dense>, int target, int, double angle) {
+        applySingleQubitGate(target, QuantumCircuit::gateMatrix(Type, angle));
+    }
+
+    template <GateType Type>
+    void applyKernel(KernelTag<GateKernel::Controlled>, int target, int control, double angle) {
+        //CZ and controlled phases only touch the amplitudes where both qubits are set
+        if (gateTraits(Type).diagonal) {
+            const std::array<std::complex<double>, 2> entries = diagonalEntries(Type, angle);
+            applyDiagonalGate(target, entries[0], entries[1], control);
+        }
+        else {
+            applyControlledGate(control, target, QuantumCircuit::gateMatrix(Type, angle));
+        }
+    }
+
+    template <GateType Type>
+    void applyKernel(KernelTag<GateKernel::Swap>, int target, int control, double) {
+        applySwap(target, control);
+    }
+
+public:
+    // largest register, 2^30 amplitudes are 16 GiB
+    static constexpr int MAX_QUBITS = 30;
+
+    // registers at or above this size spread their gate sweeps across cores
+    static constexpr int PARALLEL_QUBIT_THRESHOLD = 14;
+
+    // a layer sweep works on blocks of 2^LAYER_BLOCK_QUBITS amplitudes made of contiguous segments of 2^LAYER_SEGMENT_QUBITS
+    static constexpr int LAYER_SEGMENT_QUBITS = 10;
+    static constexpr int LAYER_BLOCK_QUBITS = 16;
+
+    // Constructors
+    QuantumRegister(int qubitCount);
+    QuantumRegister(const Eigen::VectorXcd& initialAmplitudes);
+
+    // Getters
+    int getNumQubits() const { return numQubits; }
+    size_t getDimension() const { return static_cast<size_t>(amplitudes.size()); }
+    const Eigen::VectorXcd& getAmplitudes() const { return amplitudes; }
+    Eigen::VectorXcd& getAmplitudes() { return amplitudes; }
+
+    // State preparation (no reallocation when the size does not change)
+    void reset();
+    void setState(const Eigen::VectorXcd& newAmplitudes);
+
+    // Gate kernels, every call is a single sweep over the amplitudes
+    void applySingleQubitGate(int target, const Eigen::Matrix2cd& gate);
+    void applyControlledGate(int control, int target, const Eigen::Matrix2cd& gate);
+    void applySwap(int qubitA, int qubitB);
+
+    //diag(d0, d1) on the target, restricted to the amplitudes whose control is set when control >= 0
+    void applyDiagonalGate(int target, std::complex<double> d0, std::complex<double> d1, int control = -1);
+
+    //[[0, upper], [lower, 0]] on the target, X and Y without multiplications by zero
+    void applyAntiDiagonalGate(int target, std::complex<double> upper, std::complex<double> lower);
+
+    //gate of a circuit through the kernel of its type, the angle must be constant
+    void applyGate(const GateOperation& operation);
+
+    //gate known at compile time, the kernel is chosen by overload resolution (control is the second qubit of Swap)
+    template <GateType Type>
+    void applyGate(int target, int control = -1, double angle = 0.0) {
+        applyKernel<Type>(GateKernelTag<Type>(), target, control, angle);
+    }
+
+    //dense 2^k x 2^k gate, gate index bit j is qubit qubits[j]
+    void applyMultiQubitGate(const std::vector<int>& qubits, const Eigen::MatrixXcd& gate);
+
+    //tensor product of single qubit gates on distinct qubits, all of them applied while the amplitudes are in cache
+    void applySingleQubitLayer(const std::vector<int>& targets, const std::vector<Eigen::Matrix2cd>& gates);
+
+    //exp(-i sum_k angle_k Z_k) where Z_k is the product of Z on the qubits of zMasks[k], done in one diagonal sweep
+    void applyDiagonalPhases(const std::vector<std::uint64_t>& zMasks, const std::vector<double>& angles);
+
+    //quantum Fourier transform of the qubits [firstQubit, firstQubit + count) done as batched in-place FFTs
+    void applyQFT(int firstQubit, int count, bool inverse = false);
+
+    // Mid circuit measurement, random is a uniform draw in [0, 1) that picks the outcome
+    int measure(int qubit, double random);
+    void resetQubit(int qubit, double random);
+
+    //projection on the outcome and renormalization in one sweep, probability is the weight of the outcome
+    void collapse(int qubit, int outcome, double probability);
+
+    //measurement of a qubit that is never used again, the register drops it and qubits above move down by one
+    int measureAndDiscard(int qubit, double random);
+
+    // Measurement statistics
+    double probabilityOne(int qubit) const;
+    double expectationZ(int qubit) const;
+    Eigen::VectorXd probabilities() const;
+
+    //distribution of the lowest qubitCount qubits, the others traced out (entry k is the probability of reading k on them)
+    Eigen::VectorXd marginalProbabilities(int qubitCount) const;
+    double squaredNorm() const { return amplitudes.squaredNorm(); }
+
+    // Reduced single qubit states, Bloch vectors (x, y, z) of every qubit computed in one sweep
+    std::vector<Eigen::Vector3d> reducedBlochVectors() const;
+};
+
+#endif // QUANTUM_REGISTER_H
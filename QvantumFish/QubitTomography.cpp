@@ -0,0 +1,233 @@
+#include "QubitTomography.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <vector>
+#include <Eigen/Dense>
+#include "ParallelUtils.h"
+
+/*
+
+    FUNCTION: linearInversion(counts) / projectToSphere(blochVector):
+                a basis without shots gives no information and reads as 0
+
+*/
+Eigen::Vector3d QubitTomography::linearInversion(const BasisCounts& counts) {
+    auto expectation = [](double plus, double minus) {
+        if (plus < 0.0 || minus < 0.0) {
+            throw std::invalid_argument("Measurement counts cannot be negative");
+        }
+        double total = plus + minus;
+        return total > 0.0 ? (plus - minus) / total : 0.0;
+    };
+    return Eigen::Vector3d(expectation(counts.plusX, counts.minusX), expectation(counts.plusY, counts.minusY),
+        expectation(counts.plusZ, counts.minusZ));
+}
+
+Eigen::Vector3d QubitTomography::projectToSphere(const Eigen::Vector3d& blochVector) {
+    double length = blochVector.norm();
+    return length > 1.0 ? Eigen::Vector3d(blochVector / length) : blochVector;
+}
+
+/*
+
+    FUNCTION: maximumLikelihood(counts):
+                inside the ball the likelihood is separable and peaks at the frequencies, so only
+                unphysical frequencies need the constrained fit
+
+*/
+Eigen::Vector3d QubitTomography::maximumLikelihood(const BasisCounts& counts) {
+    Eigen::Vector3d linear = linearInversion(counts);
+    if (linear.squaredNorm() <= 1.0) {
+        return linear;
+    }
+    return maximumLikelihoodOnSphere(counts);
+}
+
+/*
+
+    FUNCTION: axisOnSphere(plus, minus, multiplier):
+                root in (-1, 1) of  n+ / (1 + r) - n- / (1 - r) = 2 lambda r,  that is of the cubic
+
+                    f(r) = 2 lambda r^3 - (N + 2 lambda) r + D,     N = n+ + n-,  D = n+ - n-
+
+                with f(-1) = 2 n+ >= 0 and f(1) = -2 n- <= 0. Newton steps that leave the bracket fall back to bisection
+
+*/
+double QubitTomography::axisOnSphere(double plus, double minus, double multiplier) {
+    const double total = plus + minus;
+    if (total <= 0.0) {
+        return 0.0;
+    }
+
+    const double difference = plus - minus;
+    double low = -1.0;
+    double high = 1.0;
+    double r = difference / (total + 2.0 * multiplier);
+    for (int iteration = 0; iteration < LIKELIHOOD_ITERATIONS; ++iteration) {
+        double value = 2.0 * multiplier * r * r * r - (total + 2.0 * multiplier) * r + difference;
+        if (value > 0.0) {
+            low = r;
+        }
+        else {
+            high = r;
+        }
+
+        double slope = 6.0 * multiplier * r * r - total - 2.0 * multiplier;
+        double next = slope != 0.0 ? r - value / slope : low;
+        if (!(next > low && next < high)) {
+            next = (low + high) / 2.0;
+        }
+        if (std::abs(next - r) < 1e-15) {
+            return next;
+        }
+        r = next;
+    }
+    return r;
+}
+
+/*
+
+    FUNCTION: maximumLikelihoodOnSphere(counts):
+                every axis solves its stationarity condition for a given multiplier lambda and |r(lambda)|
+                decreases with lambda. the multiplier that puts r on the sphere is found with safeguarded Newton
+                steps, the derivative of each axis comes from the implicit function dr/dlambda = -(2 r^3 - 2 r) / f'(r)
+
+*/
+Eigen::Vector3d QubitTomography::maximumLikelihoodOnSphere(const BasisCounts& counts) {
+    const double plus[3] = { counts.plusX, counts.plusY, counts.plusZ };
+    const double minus[3] = { counts.minusX, counts.minusY, counts.minusZ };
+
+    Eigen::Vector3d r;
+    auto excess = [&](double multiplier, double& derivative) {
+        derivative = 0.0;
+        for (int axis = 0; axis < 3; ++axis) {
+            r(axis) = axisOnSphere(plus[axis], minus[axis], multiplier);
+            double slope = 6.0 * multiplier * r(axis) * r(axis) - plus[axis] - minus[axis] - 2.0 * multiplier;
+            if (slope != 0.0) {
+                derivative += 2.0 * r(axis) * (-(2.0 * r(axis) * r(axis) * r(axis) - 2.0 * r(axis)) / slope);
+            }
+        }
+        return r.squaredNorm() - 1.0;
+    };
+
+    double derivative = 0.0;
+    double low = 0.0;
+    double high = 1.0;
+    while (excess(high, derivative) > 0.0) {
+        low = high;
+        high *= 2.0;
+    }
+
+    double multiplier = (low + high) / 2.0;
+    for (int iteration = 0; iteration < LIKELIHOOD_ITERATIONS; ++iteration) {
+        double value = excess(multiplier, derivative);
+        if (std::abs(value) < 1e-14) {
+            break;
+        }
+        if (value > 0.0) {
+            low = multiplier;
+        }
+        else {
+            high = multiplier;
+        }
+
+        double next = derivative < 0.0 ? multiplier - value / derivative : low;
+        if (!(next > low && next < high)) {
+            next = (low + high) / 2.0;
+        }
+        multiplier = next;
+    }
+    excess(multiplier, derivative);
+    return projectToSphere(r);
+}
+
+Eigen::Vector3d QubitTomography::reconstruct(const BasisCounts& counts, TomographyMethod method) {
+    switch (method) {
+    case TomographyMethod::LinearInversion:
+        return linearInversion(counts);
+    case TomographyMethod::MaximumLikelihood:
+        return maximumLikelihood(counts);
+    default:
+        return projectToSphere(linearInversion(counts));
+    }
+}
+
+MixedQubit QubitTomography::reconstructState(const BasisCounts& counts, TomographyMethod method) {
+    Eigen::Vector3d bloch = reconstruct(counts, method);
+    if (method == TomographyMethod::LinearInversion) {
+        //MixedQubit only holds physical states
+        bloch = projectToSphere(bloch);
+    }
+    return MixedQubit(bloch);
+}
+
+/*
+
+    FUNCTION: reconstructBatch(counts, method):
+                the counts are laid out as 3 x K arrays of plus and minus outcomes, the frequencies and their
+                norms are Eigen array expressions that vectorize over the whole batch
+
+*/
+Eigen::Matrix3Xd QubitTomography::reconstructBatch(const std::vector<BasisCounts>& counts, TomographyMethod method) {
+    const Eigen::Index size = static_cast<Eigen::Index>(counts.size());
+    Eigen::Array3Xd plus(3, size);
+    Eigen::Array3Xd minus(3, size);
+    for (Eigen::Index k = 0; k < size; ++k) {
+        const BasisCounts& entry = counts[static_cast<size_t>(k)];
+        plus.col(k) << entry.plusX, entry.plusY, entry.plusZ;
+        minus.col(k) << entry.minusX, entry.minusY, entry.minusZ;
+    }
+    if ((plus < 0.0).any() || (minus < 0.0).any()) {
+        throw std::invalid_argument("Measurement counts cannot be negative");
+    }
+
+    const Eigen::Array3Xd total = plus + minus;
+    Eigen::Matrix3Xd result = ((total > 0.0).select((plus - minus) / total, 0.0)).matrix();
+    if (method == TomographyMethod::LinearInversion) {
+        return result;
+    }
+
+    const Eigen::Array<double, 1, Eigen::Dynamic> lengths = result.colwise().norm().array();
+    if (method == TomographyMethod::Projected) {
+        result.array().rowwise() /= (lengths > 1.0).select(lengths, 1.0);
+        return result;
+    }
+
+    std::vector<Eigen::Index> outside;
+    for (Eigen::Index k = 0; k < size; ++k) {
+        if (lengths(k) > 1.0) {
+            outside.push_back(k);
+        }
+    }
+    parallelFor(0, outside.size(), 64, [&](size_t first, size_t last) {
+        for (size_t j = first; j < last; ++j) {
+            result.col(outside[j]) = maximumLikelihoodOnSphere(counts[static_cast<size_t>(outside[j])]);
+        }
+    });
+    return result;
+}
+
+/*
+
+    FUNCTION: nearestPureState(blochVector):
+                |psi> = cos(theta/2)|0> + e^(i phi) sin(theta/2)|1> in the direction of the vector
+
+*/
+Qubit QubitTomography::nearestPureState(const Eigen::Vector3d& blochVector) {
+    double length = blochVector.norm();
+    if (length < 1e-15) {
+        return Qubit::ketZero();
+    }
+    double theta = std::acos(std::max(-1.0, std::min(1.0, blochVector.z() / length)));
+    double phi = std::atan2(blochVector.y(), blochVector.x());
+    return Qubit(std::complex<double>(std::cos(theta / 2.0), 0.0), std::polar(std::sin(theta / 2.0), phi));
+}
+
+BasisCounts QubitTomography::expectedCounts(const MixedQubit& state, double shotsPerBasis) {
+    const Eigen::Vector3d& r = state.getBlochVector();
+    return { shotsPerBasis * (1.0 + r.x()) / 2.0, shotsPerBasis * (1.0 - r.x()) / 2.0,
+        shotsPerBasis * (1.0 + r.y()) / 2.0, shotsPerBasis * (1.0 - r.y()) / 2.0,
+        shotsPerBasis * (1.0 + r.z()) / 2.0, shotsPerBasis * (1.0 - r.z()) / 2.0 };
+}
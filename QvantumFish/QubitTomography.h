@@ -0,0 +1,67 @@
+#ifndef QUBIT_TOMOGRAPHY_H
+#define QUBIT_TOMOGRAPHY_H
+
+#include <vector>
+#include <Eigen/Dense>
+#include "MixedQubit.h"
+#include "Qubit.h"
+
+//measurement counts of one qubit, "plus" is the +1 eigenvalue of each basis (|0> for Z)
+struct BasisCounts {
+    double plusX, minusX;
+    double plusY, minusY;
+    double plusZ, minusZ;
+};
+
+//how a Bloch vector is reconstructed from the counts
+enum class TomographyMethod {
+    LinearInversion,    // raw frequencies, can fall outside the sphere
+    Projected,          // linear inversion pulled back on the sphere when it is outside
+    MaximumLikelihood   // most likely physical state
+};
+
+
+/*
+
+    QubitTomography class
+
+    single qubit state tomography from counts in the X, Y and Z bases. linear inversion reads the Bloch vector
+    as the expectation values r_a = (n+_a - n-_a) / (n+_a + n-_a). with finite shots |r| can exceed 1,
+    the projection scales it back on the sphere (closest physical state in Hilbert-Schmidt distance) and the
+    maximum likelihood fit maximizes
+
+                    L(r) = sum_a n+_a log(1 + r_a) + n-_a log(1 - r_a),     |r| <= 1
+
+    the linear estimate is already the maximum when it is physical, otherwise the maximum is on the sphere
+    and is found from the stationarity condition with a Lagrange multiplier
+
+*/
+class QubitTomography {
+private:
+    // Private helper methods
+    static double axisOnSphere(double plus, double minus, double multiplier);
+    static Eigen::Vector3d maximumLikelihoodOnSphere(const BasisCounts& counts);
+
+public:
+    // upper bound on the safeguarded Newton steps of each root search of the maximum likelihood fit
+    static constexpr int LIKELIHOOD_ITERATIONS = 100;
+
+    // One experiment
+    static Eigen::Vector3d linearInversion(const BasisCounts& counts);
+    static Eigen::Vector3d projectToSphere(const Eigen::Vector3d& blochVector);
+    static Eigen::Vector3d maximumLikelihood(const BasisCounts& counts);
+    static Eigen::Vector3d reconstruct(const BasisCounts& counts, TomographyMethod method = TomographyMethod::Projected);
+    static MixedQubit reconstructState(const BasisCounts& counts, TomographyMethod method = TomographyMethod::Projected);
+
+    //column k is the Bloch vector of counts[k], linear inversion and projection run as array operations on the
+    //whole batch, the maximum likelihood fits of the unphysical columns are spread over the workers
+    static Eigen::Matrix3Xd reconstructBatch(const std::vector<BasisCounts>& counts, TomographyMethod method = TomographyMethod::Projected);
+
+    //pure state in the direction of the Bloch vector (|0> for the null vector)
+    static Qubit nearestPureState(const Eigen::Vector3d& blochVector);
+
+    //expected counts of a state, useful to replay simulated experiments
+    static BasisCounts expectedCounts(const MixedQubit& state, double shotsPerBasis);
+};
+
+#endif // QUBIT_TOMOGRAPHY_H
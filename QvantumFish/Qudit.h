@@ -0,0 +1,251 @@
+#ifndef QUDIT_H
+#define QUDIT_H
+
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <Eigen/Dense>
+
+
+/*
+
+    Qudit class template
+
+    pure state of a D level system, |psi> = a0|0> + ... + a(D-1)|D-1>. the dimension is a template parameter so
+    states and gates are fixed size Eigen objects: D = 3 (qutrits) and D = 4 (transmon levels up to |3>) kernels
+    are unrolled by the compiler and never allocate. the template lives entirely in the header.
+
+    the Bloch vector generalizes to the D^2 - 1 expectations of the generalized Gell-Mann matrices
+
+                    rho = I/D + 1/2 sum_k n_k lambda_k,       n_k = <psi|lambda_k|psi>,       |n|^2 = 2 (1 - 1/D) when pure
+
+    ordered as the usual ones: for every level k = 1 .. D-1 the symmetric and antisymmetric pairs (j, k) with j < k
+    followed by the diagonal matrix of the first k + 1 levels. for D = 2 they are X, Y, Z and for D = 3 lambda_1 .. lambda_8
+
+*/
+template <int D>
+class Qudit {
+    static_assert(D >= 2, "A qudit has at least two levels");
+
+public:
+    typedef Eigen::Matrix<std::complex<double>, D, 1> StateVector;
+    typedef Eigen::Matrix<std::complex<double>, D, D> GateMatrix;
+    typedef Eigen::Matrix<double, D, 1> LevelVector;
+    typedef Eigen::Matrix<double, D * D - 1, 1> GellMannVector;
+
+    static constexpr int LEVELS = D;
+    static constexpr int GELL_MANN_COUNT = D * D - 1;
+    // M_PI needs _USE_MATH_DEFINES before the first <cmath>, which a header cannot guarantee
+    static constexpr double TWO_PI = 6.283185307179586476925;
+
+private:
+    StateVector states;
+
+public:
+    // Constructors, the default state is |0>
+    Qudit();
+    Qudit(const StateVector& inputStates);
+
+    // Getters
+    const StateVector& getStateVector() const { return states; }
+    std::complex<double> amplitude(int level) const { return states(level); }
+    double probability(int level) const { return std::norm(states(level)); }
+    LevelVector probabilities() const { return states.cwiseAbs2(); }
+    GateMatrix densityMatrix() const { return states * states.adjoint(); }
+
+    //fixed size product, the state stays normalized for unitary gates
+    void applyGate(const GateMatrix& gate) { states = gate * states; }
+
+    //<psi|lambda_k|psi> without building the matrices
+    GellMannVector gellMannVector() const;
+
+    //static factory
+    static Qudit basisState(int level);
+    static Qudit uniformSuperposition();
+
+    // Gates
+    static GateMatrix shiftGate();                  // X|j> = |j + 1 mod D>
+    static GateMatrix clockGate();                  // Z|j> = exp(2 pi i j / D)|j>
+    static GateMatrix fourierGate();                // F|j> = sum_k exp(2 pi i j k / D)|k> / sqrt(D)
+    static GateMatrix transitionRotation(int levelA, int levelB, double angle, double phase = 0.0);
+
+    //lambda_k in the ordering of gellMannVector, index from 0 to D^2 - 2
+    static GateMatrix gellMannMatrix(int index);
+
+    //expectations of a density matrix, for reduced or mixed states
+    static GellMannVector gellMannVector(const GateMatrix& rho);
+
+    static void checkLevel(int level);
+};
+
+typedef Qudit<3> Qutrit;
+
+/*
+
+    CONSTRUCTORS
+
+*/
+template <int D>
+Qudit<D>::Qudit() : states(StateVector::Zero()) {
+    states(0) = 1.0;
+}
+
+template <int D>
+Qudit<D>::Qudit(const StateVector& inputStates) : states(inputStates) {
+    //same tolerance of the Qubit normalization check
+    if (std::abs(states.squaredNorm() - 1.0) >= 1e-10) {
+        throw std::invalid_argument("Qudit states do not satisfy normalization condition");
+    }
+}
+
+template <int D>
+void Qudit<D>::checkLevel(int level) {
+    if (level < 0 || level >= D) {
+        throw std::out_of_range("Level outside of the qudit");
+    }
+}
+
+template <int D>
+Qudit<D> Qudit<D>::basisState(int level) {
+    checkLevel(level);
+    StateVector basis = StateVector::Zero();
+    basis(level) = 1.0;
+    return Qudit(basis);
+}
+
+template <int D>
+Qudit<D> Qudit<D>::uniformSuperposition() {
+    return Qudit(StateVector::Constant(1.0 / std::sqrt(static_cast<double>(D))));
+}
+
+/*
+
+    FUNCTION: gellMannVector() / gellMannVector(densityMatrix):
+                with rho(j, k) = a_j conj(a_k) the three kinds of generalized Gell-Mann matrices give
+
+                    symmetric (j, k):        2 Re(rho(j, k))
+                    antisymmetric (j, k):   -2 Im(rho(j, k))
+                    diagonal k:              sqrt(2 / (k (k + 1))) (rho(0, 0) + ... + rho(k-1, k-1) - k rho(k, k))
+
+*/
+template <int D>
+typename Qudit<D>::GellMannVector Qudit<D>::gellMannVector() const {
+    return gellMannVector(densityMatrix());
+}
+
+template <int D>
+typename Qudit<D>::GellMannVector Qudit<D>::gellMannVector(const GateMatrix& rho) {
+    GellMannVector result;
+    int index = 0;
+    double lowerPopulation = rho(0, 0).real();
+    for (int k = 1; k < D; ++k) {
+        for (int j = 0; j < k; ++j) {
+            result(index++) = 2.0 * rho(j, k).real();
+            result(index++) = -2.0 * rho(j, k).imag();
+        }
+        result(index++) = std::sqrt(2.0 / (k * (k + 1.0))) * (lowerPopulation - k * rho(k, k).real());
+        lowerPopulation += rho(k, k).real();
+    }
+    return result;
+}
+
+template <int D>
+typename Qudit<D>::GateMatrix Qudit<D>::gellMannMatrix(int index) {
+    if (index < 0 || index >= GELL_MANN_COUNT) {
+        throw std::out_of_range("Gell-Mann index outside of the basis");
+    }
+
+    const std::complex<double> i(0.0, 1.0);
+    GateMatrix result = GateMatrix::Zero();
+    //level k owns the 2k + 1 indices after the k^2 - 1 of the lower levels
+    int k = 1;
+    while ((k + 1) * (k + 1) - 1 <= index) {
+        ++k;
+    }
+    const int offset = index - (k * k - 1);
+    if (offset == 2 * k) {
+        const double factor = std::sqrt(2.0 / (k * (k + 1.0)));
+        for (int level = 0; level < k; ++level) {
+            result(level, level) = factor;
+        }
+        result(k, k) = -k * factor;
+    }
+    else if (offset % 2 == 0) {
+        result(offset / 2, k) = 1.0;
+        result(k, offset / 2) = 1.0;
+    }
+    else {
+        result(offset / 2, k) = -i;
+        result(k, offset / 2) = i;
+    }
+    return result;
+}
+
+/*
+
+    FUNCTION: shiftGate() / clockGate() / fourierGate():
+                generalized Pauli X and Z (Z X = w X Z with w = exp(2 pi i / D)) and the discrete Fourier transform
+                that maps the eigenbasis of Z on the one of X
+
+*/
+template <int D>
+typename Qudit<D>::GateMatrix Qudit<D>::shiftGate() {
+    GateMatrix result = GateMatrix::Zero();
+    for (int level = 0; level < D; ++level) {
+        result((level + 1) % D, level) = 1.0;
+    }
+    return result;
+}
+
+template <int D>
+typename Qudit<D>::GateMatrix Qudit<D>::clockGate() {
+    GateMatrix result = GateMatrix::Zero();
+    for (int level = 0; level < D; ++level) {
+        result(level, level) = std::polar(1.0, TWO_PI * level / D);
+    }
+    return result;
+}
+
+template <int D>
+typename Qudit<D>::GateMatrix Qudit<D>::fourierGate() {
+    GateMatrix result;
+    const double normalization = 1.0 / std::sqrt(static_cast<double>(D));
+    for (int row = 0; row < D; ++row) {
+        for (int column = 0; column < D; ++column) {
+            result(row, column) = std::polar(normalization, TWO_PI * ((row * column) % D) / D);
+        }
+    }
+    return result;
+}
+
+/*
+
+    FUNCTION: transitionRotation(levelA, levelB, angle, phase):
+                drive of the single transition A <-> B, the other levels are untouched
+
+                    exp(-i angle/2 (cos(phase) X_AB + sin(phase) Y_AB))
+
+                with X_AB and Y_AB the symmetric and antisymmetric Gell-Mann matrices of the pair. (0, 1) with phase 0
+                is RX of the qubit subspace, (1, 2) is the leakage transition of a transmon
+
+*/
+template <int D>
+typename Qudit<D>::GateMatrix Qudit<D>::transitionRotation(int levelA, int levelB, double angle, double phase) {
+    checkLevel(levelA);
+    checkLevel(levelB);
+    if (levelA == levelB) {
+        throw std::invalid_argument("Transition needs two different levels");
+    }
+
+    const std::complex<double> i(0.0, 1.0);
+    const double c = std::cos(angle / 2.0);
+    const double s = std::sin(angle / 2.0);
+    GateMatrix result = GateMatrix::Identity();
+    result(levelA, levelA) = c;
+    result(levelB, levelB) = c;
+    result(levelA, levelB) = -i * s * std::polar(1.0, -phase);
+    result(levelB, levelA) = -i * s * std::polar(1.0, phase);
+    return result;
+}
+
+#endif // QUDIT_H
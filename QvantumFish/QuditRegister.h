@@ -0,0 +1,316 @@
+#ifndef QUDIT_REGISTER_H
+#define QUDIT_REGISTER_H
+
+#include <algorithm>
+#include <complex>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+#include <Eigen/Dense>
+#include "ParallelUtils.h"
+#include "Qudit.h"
+
+
+/*
+
+    QuditRegister class template
+
+    state vector of N qudits of D levels, qudit k is digit k of the base D basis index
+    so |d(N-1) ... d1 d0> is stored at index sum(dk * D^k). the kernels gather the D (or D^2) amplitudes a gate
+    acts on into a fixed size vector, multiply it by the fixed size gate and scatter it back, so the inner
+    product is unrolled for the dimension of the template and the sweep never allocates
+
+*/
+template <int D>
+class QuditRegister {
+public:
+    typedef typename Qudit<D>::StateVector LocalState;
+    typedef typename Qudit<D>::GateMatrix GateMatrix;
+    typedef Eigen::Matrix<std::complex<double>, D * D, 1> PairState;
+    typedef Eigen::Matrix<std::complex<double>, D * D, D * D> TwoQuditGateMatrix;
+
+    // registers at or above this dimension spread their gate sweeps across cores
+    static constexpr size_t PARALLEL_DIMENSION_THRESHOLD = static_cast<size_t>(1) << 14;
+
+private:
+    int numQudits;
+    Eigen::VectorXcd amplitudes;
+
+    // Private helper methods
+    void checkQuditIndex(int qudit) const;
+    size_t stride(int qudit) const;
+
+    template <typename Sweep>
+    void sweepGroups(size_t groups, Sweep&& sweep) {
+        if (getDimension() >= PARALLEL_DIMENSION_THRESHOLD) {
+            parallelFor(0, groups, groups / parallelWorkerCount() + 1, sweep);
+        }
+        else {
+            sweep(0, groups);
+        }
+    }
+
+public:
+    // Constructors, all the qudits start in |0> or in the product of the given states
+    QuditRegister(int quditCount);
+    QuditRegister(const std::vector<Qudit<D>>& qudits);
+
+    // Getters
+    int getNumQudits() const { return numQudits; }
+    size_t getDimension() const { return static_cast<size_t>(amplitudes.size()); }
+    const Eigen::VectorXcd& getAmplitudes() const { return amplitudes; }
+
+    // State preparation
+    void reset();
+    void setState(const Eigen::VectorXcd& newAmplitudes);
+
+    // Gate kernels, every call is a single sweep over the amplitudes
+    void applySingleQuditGate(int target, const GateMatrix& gate);
+
+    //gate index is d_first + D d_second
+    void applyTwoQuditGate(int first, int second, const TwoQuditGateMatrix& gate);
+
+    //gate applied to the target only on the amplitudes whose control sits in controlLevel
+    void applyControlledGate(int control, int controlLevel, int target, const GateMatrix& gate);
+
+    // Measurement statistics
+    typename Qudit<D>::LevelVector levelProbabilities(int qudit) const;
+    GateMatrix reducedDensityMatrix(int qudit) const;
+    typename Qudit<D>::GellMannVector reducedGellMannVector(int qudit) const;
+    double squaredNorm() const { return amplitudes.squaredNorm(); }
+
+    static size_t dimensionOf(int quditCount);
+};
+
+/*
+
+    CONSTRUCTORS
+
+*/
+template <int D>
+QuditRegister<D>::QuditRegister(int quditCount) : numQudits(quditCount) {
+    amplitudes = Eigen::VectorXcd::Zero(static_cast<Eigen::Index>(dimensionOf(quditCount)));
+    amplitudes(0) = 1.0;
+}
+
+template <int D>
+QuditRegister<D>::QuditRegister(const std::vector<Qudit<D>>& qudits) : numQudits(static_cast<int>(qudits.size())) {
+    amplitudes = Eigen::VectorXcd::Ones(static_cast<Eigen::Index>(dimensionOf(numQudits)));
+    //qudit k changes digit k, blocks of D^k consecutive amplitudes share its level
+    for (int qudit = 0; qudit < numQudits; ++qudit) {
+        const size_t block = stride(qudit);
+        for (size_t index = 0; index < getDimension(); ++index) {
+            amplitudes(static_cast<Eigen::Index>(index)) *= qudits[qudit].amplitude(static_cast<int>((index / block) % D));
+        }
+    }
+}
+
+template <int D>
+size_t QuditRegister<D>::dimensionOf(int quditCount) {
+    if (quditCount < 1) {
+        throw std::invalid_argument("Qudit register needs at least one qudit");
+    }
+    size_t dimension = 1;
+    for (int qudit = 0; qudit < quditCount; ++qudit) {
+        if (dimension > (static_cast<size_t>(1) << 40) / D) {
+            throw std::invalid_argument("Qudit register is too large");
+        }
+        dimension *= D;
+    }
+    return dimension;
+}
+
+template <int D>
+void QuditRegister<D>::checkQuditIndex(int qudit) const {
+    if (qudit < 0 || qudit >= numQudits) {
+        throw std::out_of_range("Qudit index outside of the register");
+    }
+}
+
+template <int D>
+size_t QuditRegister<D>::stride(int qudit) const {
+    size_t result = 1;
+    for (int k = 0; k < qudit; ++k) {
+        result *= D;
+    }
+    return result;
+}
+
+template <int D>
+void QuditRegister<D>::reset() {
+    amplitudes.setZero();
+    amplitudes(0) = 1.0;
+}
+
+template <int D>
+void QuditRegister<D>::setState(const Eigen::VectorXcd& newAmplitudes) {
+    if (static_cast<size_t>(newAmplitudes.size()) != getDimension()) {
+        throw std::invalid_argument("State size does not match the register");
+    }
+    amplitudes = newAmplitudes;
+}
+
+/*
+
+    FUNCTION: applySingleQuditGate(target, gate):
+                the amplitudes are visited in groups of D that differ only in the target digit,
+                group g starts at (g / s) s D + g % s with s = D^target and its members are s apart
+
+*/
+template <int D>
+void QuditRegister<D>::applySingleQuditGate(int target, const GateMatrix& gate) {
+    checkQuditIndex(target);
+
+    const size_t step = stride(target);
+    const size_t groups = getDimension() / D;
+    std::complex<double>* data = amplitudes.data();
+
+    sweepGroups(groups, [=, &gate](size_t first, size_t last) {
+        LocalState local;
+        for (size_t g = first; g < last; ++g) {
+            const size_t base = (g / step) * step * D + g % step;
+            for (int level = 0; level < D; ++level) {
+                local(level) = data[base + level * step];
+            }
+            const LocalState result = gate * local;
+            for (int level = 0; level < D; ++level) {
+                data[base + level * step] = result(level);
+            }
+        }
+    });
+}
+
+/*
+
+    FUNCTION: applyTwoQuditGate(first, second, gate):
+                groups of D^2 amplitudes that differ only in the two digits, the group index is split around
+                the lower digit and then around the higher one like the zero insertion of the qubit kernels
+
+*/
+template <int D>
+void QuditRegister<D>::applyTwoQuditGate(int first, int second, const TwoQuditGateMatrix& gate) {
+    checkQuditIndex(first);
+    checkQuditIndex(second);
+    if (first == second) {
+        throw std::invalid_argument("Two qudit gate needs two different qudits");
+    }
+
+    const size_t firstStep = stride(first);
+    const size_t secondStep = stride(second);
+    const size_t lowStep = std::min(firstStep, secondStep);
+    const size_t highStep = std::max(firstStep, secondStep);
+    const size_t groups = getDimension() / (D * D);
+    std::complex<double>* data = amplitudes.data();
+
+    sweepGroups(groups, [=, &gate](size_t begin, size_t end) {
+        PairState local;
+        for (size_t g = begin; g < end; ++g) {
+            size_t base = (g / lowStep) * lowStep * D + g % lowStep;
+            base = (base / highStep) * highStep * D + base % highStep;
+            for (int b = 0; b < D; ++b) {
+                for (int a = 0; a < D; ++a) {
+                    local(a + D * b) = data[base + a * firstStep + b * secondStep];
+                }
+            }
+            const PairState result = gate * local;
+            for (int b = 0; b < D; ++b) {
+                for (int a = 0; a < D; ++a) {
+                    data[base + a * firstStep + b * secondStep] = result(a + D * b);
+                }
+            }
+        }
+    });
+}
+
+/*
+
+    FUNCTION: applyControlledGate(control, controlLevel, target, gate):
+                single qudit sweep restricted to the groups whose control digit is controlLevel
+
+*/
+template <int D>
+void QuditRegister<D>::applyControlledGate(int control, int controlLevel, int target, const GateMatrix& gate) {
+    checkQuditIndex(control);
+    checkQuditIndex(target);
+    Qudit<D>::checkLevel(controlLevel);
+    if (control == target) {
+        throw std::invalid_argument("Control and target qudits must be different");
+    }
+
+    const size_t step = stride(target);
+    const size_t controlStep = stride(control);
+    const size_t groups = getDimension() / D;
+    std::complex<double>* data = amplitudes.data();
+
+    sweepGroups(groups, [=, &gate](size_t first, size_t last) {
+        LocalState local;
+        for (size_t g = first; g < last; ++g) {
+            const size_t base = (g / step) * step * D + g % step;
+            if (static_cast<int>((base / controlStep) % D) != controlLevel) {
+                continue;
+            }
+            for (int level = 0; level < D; ++level) {
+                local(level) = data[base + level * step];
+            }
+            const LocalState result = gate * local;
+            for (int level = 0; level < D; ++level) {
+                data[base + level * step] = result(level);
+            }
+        }
+    });
+}
+
+/*
+
+    FUNCTION: reducedDensityMatrix(qudit):
+                rho(l, m) = sum over the groups of the qudit of a(base + l s) conj(a(base + m s)). the groups are
+                cut in a few blocks per worker, every block accumulates a private fixed size matrix and they are
+                added together in block order at the end
+
+*/
+template <int D>
+typename QuditRegister<D>::GateMatrix QuditRegister<D>::reducedDensityMatrix(int qudit) const {
+    checkQuditIndex(qudit);
+
+    const size_t step = stride(qudit);
+    const size_t groups = getDimension() / D;
+    const size_t blocks = getDimension() >= PARALLEL_DIMENSION_THRESHOLD ? parallelWorkerCount() * PARALLEL_CHUNKS_PER_WORKER : 1;
+    const size_t blockSize = (groups + blocks - 1) / blocks;
+    const std::complex<double>* data = amplitudes.data();
+    std::vector<GateMatrix, Eigen::aligned_allocator<GateMatrix>> partial(blocks, GateMatrix::Zero());
+
+    parallelFor(0, blocks, 1, [&](size_t firstBlock, size_t lastBlock) {
+        for (size_t block = firstBlock; block < lastBlock; ++block) {
+            LocalState local;
+            GateMatrix sum = GateMatrix::Zero();
+            const size_t end = std::min(groups, (block + 1) * blockSize);
+            for (size_t g = block * blockSize; g < end; ++g) {
+                const size_t base = (g / step) * step * D + g % step;
+                for (int level = 0; level < D; ++level) {
+                    local(level) = data[base + level * step];
+                }
+                sum.noalias() += local * local.adjoint();
+            }
+            partial[block] = sum;
+        }
+    });
+
+    GateMatrix result = GateMatrix::Zero();
+    for (const GateMatrix& sum : partial) {
+        result += sum;
+    }
+    return result;
+}
+
+template <int D>
+typename Qudit<D>::LevelVector QuditRegister<D>::levelProbabilities(int qudit) const {
+    return reducedDensityMatrix(qudit).diagonal().real();
+}
+
+//the vector of a qudit entangled with the rest of the register is shorter than the pure state one
+template <int D>
+typename Qudit<D>::GellMannVector QuditRegister<D>::reducedGellMannVector(int qudit) const {
+    return Qudit<D>::gellMannVector(reducedDensityMatrix(qudit));
+}
+
+#endif // QUDIT_REGISTER_H
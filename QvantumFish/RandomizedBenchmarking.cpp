@@ -0,0 +1,211 @@
+#include "RandomizedBenchmarking.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include <Eigen/Dense>
+#include "ParallelUtils.h"
+
+/*
+
+    CONSTRUCTOR
+
+    the native gates of every Clifford are turned into matrices once, simulating a sequence
+    is then only products of small matrices
+
+*/
+RandomizedBenchmarking::RandomizedBenchmarking(int qubitCount, const DepolarizingNoise& noiseModel)
+    : numQubits(qubitCount), noise(noiseModel), group(CliffordGroup::forQubits(qubitCount)) {
+
+    for (double probability : { noise.singleQubitError, noise.twoQubitError, noise.readoutError }) {
+        if (probability < 0.0 || probability > 1.0) {
+            throw std::invalid_argument("Error probabilities must be between 0 and 1");
+        }
+    }
+
+    gateMatrices.resize(group.size());
+    gateQubits.resize(group.size());
+    for (size_t element = 0; element < group.size(); ++element) {
+        for (const GateOperation& operation : group.decomposition(element)) {
+            gateMatrices[element].push_back(CliffordGroup::operationMatrix(operation, numQubits));
+            gateQubits[element].push_back(QuantumCircuit::isTwoQubit(operation.type) ? -1 : operation.target);
+        }
+    }
+}
+
+/*
+
+    FUNCTION: depolarize(densityMatrix, qubit, probability):
+                rho -> (1 - p) rho + p tr_q(rho) x I/2 on one qubit, or (1 - p) rho + p I/d on the whole register
+                when qubit is -1. the partial trace is the average of the four Pauli conjugations of the qubit
+
+*/
+void RandomizedBenchmarking::depolarize(Eigen::MatrixXcd& densityMatrix, int qubit, double probability) const {
+    if (probability <= 0.0) {
+        return;
+    }
+
+    const Eigen::Index dimension = densityMatrix.rows();
+    if (qubit < 0) {
+        std::complex<double> trace = densityMatrix.trace();
+        densityMatrix *= 1.0 - probability;
+        densityMatrix.diagonal().array() += probability * trace / static_cast<double>(dimension);
+        return;
+    }
+
+    //tr_q(rho) x I/2: entries whose indices differ in the qubit vanish, the others are averaged over the qubit value
+    const Eigen::Index mask = static_cast<Eigen::Index>(1) << qubit;
+    Eigen::MatrixXcd mixed = Eigen::MatrixXcd::Zero(dimension, dimension);
+    for (Eigen::Index row = 0; row < dimension; ++row) {
+        for (Eigen::Index column = 0; column < dimension; ++column) {
+            if (((row ^ column) & mask) == 0) {
+                mixed(row, column) = (densityMatrix(row & ~mask, column & ~mask) + densityMatrix(row | mask, column | mask)) / 2.0;
+            }
+        }
+    }
+    densityMatrix = (1.0 - probability) * densityMatrix + probability * mixed;
+}
+
+/*
+
+    FUNCTION: randomSequence(length, generator):
+                the running product is one compose per Clifford, the recovery is its inverse
+
+*/
+std::vector<size_t> RandomizedBenchmarking::randomSequence(int length, std::mt19937_64& generator) const {
+    if (length < 0) {
+        throw std::invalid_argument("Sequence length cannot be negative");
+    }
+
+    std::uniform_int_distribution<size_t> distribution(0, group.size() - 1);
+    std::vector<size_t> sequence;
+    sequence.reserve(static_cast<size_t>(length) + 1);
+
+    size_t total = group.identity();
+    for (int k = 0; k < length; ++k) {
+        size_t element = distribution(generator);
+        sequence.push_back(element);
+        total = group.compose(total, element);
+    }
+    sequence.push_back(group.inverse(total));
+    return sequence;
+}
+
+/*
+
+    FUNCTION: sequenceSurvival(sequence):
+                rho starts in |0...0><0...0|, each native gate is followed by its depolarizing channel,
+                the readout flips every bit independently so P(read 0...0) = sum_x rho_xx e^|x| (1 - e)^(N - |x|)
+
+*/
+double RandomizedBenchmarking::sequenceSurvival(const std::vector<size_t>& sequence) const {
+    const Eigen::Index dimension = static_cast<Eigen::Index>(1) << numQubits;
+    Eigen::MatrixXcd densityMatrix = Eigen::MatrixXcd::Zero(dimension, dimension);
+    densityMatrix(0, 0) = 1.0;
+
+    for (size_t element : sequence) {
+        const std::vector<Eigen::MatrixXcd>& gates = gateMatrices[element];
+        for (size_t g = 0; g < gates.size(); ++g) {
+            densityMatrix = gates[g] * densityMatrix * gates[g].adjoint();
+            int qubit = gateQubits[element][g];
+            depolarize(densityMatrix, qubit, qubit < 0 ? noise.twoQubitError : noise.singleQubitError);
+        }
+    }
+
+    double survival = 0.0;
+    for (Eigen::Index state = 0; state < dimension; ++state) {
+        int flips = 0;
+        for (int qubit = 0; qubit < numQubits; ++qubit) {
+            flips += static_cast<int>((state >> qubit) & 1);
+        }
+        survival += densityMatrix(state, state).real() * std::pow(noise.readoutError, flips)
+            * std::pow(1.0 - noise.readoutError, numQubits - flips);
+    }
+    return survival;
+}
+
+QuantumCircuit RandomizedBenchmarking::sequenceCircuit(const std::vector<size_t>& sequence) const {
+    QuantumCircuit circuit(numQubits);
+    for (size_t element : sequence) {
+        for (const GateOperation& operation : group.decomposition(element)) {
+            circuit.addOperation(operation);
+        }
+    }
+    return circuit;
+}
+
+/*
+
+    FUNCTION: run(lengths, sequencesPerLength, seed):
+                all the (length, sequence) pairs are one flat range for the workers, the generator of a pair
+                only depends on the seed and on the pair so the result does not depend on the worker count
+
+*/
+BenchmarkResult RandomizedBenchmarking::run(const std::vector<int>& lengths, size_t sequencesPerLength, std::uint64_t seed) const {
+    if (sequencesPerLength < 1) {
+        throw std::invalid_argument("Benchmark needs at least one sequence per length");
+    }
+
+    std::vector<double> survivals(lengths.size() * sequencesPerLength);
+    parallelFor(0, survivals.size(), 1, [&](size_t first, size_t last) {
+        for (size_t k = first; k < last; ++k) {
+            std::mt19937_64 generator(seed ^ (0x9E3779B97F4A7C15ULL * (k + 1)));
+            survivals[k] = sequenceSurvival(randomSequence(lengths[k / sequencesPerLength], generator));
+        }
+    });
+
+    BenchmarkResult result;
+    result.lengths = lengths;
+    for (size_t l = 0; l < lengths.size(); ++l) {
+        double sum = 0.0;
+        double squares = 0.0;
+        for (size_t s = 0; s < sequencesPerLength; ++s) {
+            double value = survivals[l * sequencesPerLength + s];
+            sum += value;
+            squares += value * value;
+        }
+        double mean = sum / static_cast<double>(sequencesPerLength);
+        result.meanSurvival.push_back(mean);
+        result.survivalDeviation.push_back(std::sqrt(std::max(0.0, squares / static_cast<double>(sequencesPerLength) - mean * mean)));
+    }
+    fitDecay(result, numQubits);
+    return result;
+}
+
+/*
+
+    FUNCTION: fitDecay(result, qubitCount):
+                least squares line through (m, log(F_m - B)), points at or below the offset carry no information
+
+*/
+void RandomizedBenchmarking::fitDecay(BenchmarkResult& result, int qubitCount) {
+    const double dimension = std::pow(2.0, qubitCount);
+    result.offset = 1.0 / dimension;
+
+    double count = 0.0, sumX = 0.0, sumY = 0.0, sumXX = 0.0, sumXY = 0.0;
+    for (size_t l = 0; l < result.lengths.size(); ++l) {
+        double excess = result.meanSurvival[l] - result.offset;
+        if (excess <= 1e-12) {
+            continue;
+        }
+        double x = static_cast<double>(result.lengths[l]);
+        double y = std::log(excess);
+        count += 1.0;
+        sumX += x;
+        sumY += y;
+        sumXX += x * x;
+        sumXY += x * y;
+    }
+    if (count < 2.0 || sumXX * count == sumX * sumX) {
+        throw std::invalid_argument("Decay fit needs at least two distinct lengths above the offset");
+    }
+
+    double slope = (count * sumXY - sumX * sumY) / (count * sumXX - sumX * sumX);
+    double intercept = (sumY - slope * sumX) / count;
+    result.decay = std::exp(slope);
+    result.amplitude = std::exp(intercept);
+    result.errorPerClifford = (dimension - 1.0) * (1.0 - result.decay) / dimension;
+}
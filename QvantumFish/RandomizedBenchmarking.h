@@ -0,0 +1,78 @@
+#ifndef RANDOMIZED_BENCHMARKING_H
+#define RANDOMIZED_BENCHMARKING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <Eigen/Dense>
+#include "CliffordGroup.h"
+#include "QuantumCircuit.h"
+
+//depolarizing errors after every native gate of a Clifford and symmetric readout flips
+struct DepolarizingNoise {
+    double singleQubitError = 0.0;      // probability that a one qubit gate depolarizes its qubit
+    double twoQubitError = 0.0;         // probability that a two qubit gate depolarizes both qubits
+    double readoutError = 0.0;          // probability that a measured bit is flipped
+};
+
+//average survival of |0...0> for every sequence length and the fit A p^m + B
+struct BenchmarkResult {
+    std::vector<int> lengths;
+    std::vector<double> meanSurvival;
+    std::vector<double> survivalDeviation;
+    double amplitude = 0.0;
+    double offset = 0.0;
+    double decay = 0.0;
+    double errorPerClifford = 0.0;      // (d - 1)(1 - p) / d
+};
+
+
+/*
+
+    RandomizedBenchmarking class
+
+    randomized benchmarking of one or two qubits. a sequence of m random Cliffords is drawn by index from the
+    shared Clifford tables, the running product is tracked with the composition table and the recovery
+    element is its inverse, so no matrix is multiplied while building sequences. every Clifford is played
+    as its native gate decomposition on a density matrix with a depolarizing channel after each gate,
+    sequences are independent and simulated in parallel
+
+*/
+class RandomizedBenchmarking {
+private:
+    int numQubits;
+    DepolarizingNoise noise;
+    const CliffordGroup& group;
+    std::vector<std::vector<Eigen::MatrixXcd>> gateMatrices;    // native gate matrices of every Clifford
+    std::vector<std::vector<int>> gateQubits;                   // qubit depolarized after each gate, -1 for both
+
+    // Private helper method
+    void depolarize(Eigen::MatrixXcd& densityMatrix, int qubit, double probability) const;
+
+public:
+    // Constructor
+    RandomizedBenchmarking(int qubitCount, const DepolarizingNoise& noiseModel);
+
+    // Getters
+    int getNumQubits() const { return numQubits; }
+    const DepolarizingNoise& getNoise() const { return noise; }
+    const CliffordGroup& getGroup() const { return group; }
+
+    //m random Cliffords followed by the recovery element, m + 1 indices
+    std::vector<size_t> randomSequence(int length, std::mt19937_64& generator) const;
+
+    //probability of measuring |0...0> at the end of the sequence
+    double sequenceSurvival(const std::vector<size_t>& sequence) const;
+
+    //gates of a sequence, to run it on the other backends
+    QuantumCircuit sequenceCircuit(const std::vector<size_t>& sequence) const;
+
+    //sequencesPerLength sequences of every length, each one with its own generator seeded from (seed, length, sequence)
+    BenchmarkResult run(const std::vector<int>& lengths, size_t sequencesPerLength, std::uint64_t seed = 1) const;
+
+    //fit of A p^m + B with B fixed at 1 / 2^N, linear in log(survival - B)
+    static void fitDecay(BenchmarkResult& result, int qubitCount);
+};
+
+#endif // RANDOMIZED_BENCHMARKING_H
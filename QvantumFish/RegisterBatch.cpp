@@ -0,0 +1,270 @@
+#define _USE_MATH_DEFINES
+
+#include "RegisterBatch.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <Eigen/Dense>
+#include "BitUtils.h"
+#include "ParallelUtils.h"
+
+//spread the bits of value over the set bits of freeMask, lowest first
+static size_t depositBits(size_t value, size_t freeMask) {
+    size_t result = 0;
+    for (size_t bit = 1; value != 0 && bit != 0; bit <<= 1) {
+        if ((freeMask & bit) != 0) {
+            if ((value & 1) != 0) {
+                result |= bit;
+            }
+            value >>= 1;
+        }
+    }
+    return result;
+}
+
+/*
+
+    FUNCTION: checkQubits(qubits):
+                throw if a qubit is outside of the register or appears twice
+
+*/
+void RegisterBatch::checkQubits(const std::vector<int>& qubits) const {
+    size_t used = 0;
+    for (int qubit : qubits) {
+        if (qubit < 0 || qubit >= numQubits) {
+            throw std::out_of_range("Qubit index outside of the register");
+        }
+        size_t bit = static_cast<size_t>(1) << qubit;
+        if ((used & bit) != 0) {
+            throw std::invalid_argument("Gate qubits must be distinct");
+        }
+        used |= bit;
+    }
+}
+
+/*
+
+    CONSTRUCTORS
+
+*/
+RegisterBatch::RegisterBatch(int qubitCount, Eigen::Index batchSize) : numQubits(qubitCount) {
+    if (qubitCount < 1 || qubitCount > QuantumRegister::MAX_QUBITS) {
+        throw std::invalid_argument("RegisterBatch supports between 1 and " + std::to_string(QuantumRegister::MAX_QUBITS) + " qubits");
+    }
+    if (batchSize < 1) {
+        throw std::invalid_argument("Batch needs at least one state");
+    }
+    amplitudes = BatchMatrix::Zero(static_cast<Eigen::Index>(1) << qubitCount, batchSize);
+    amplitudes.row(0).setOnes();
+}
+
+RegisterBatch::RegisterBatch(const Eigen::MatrixXcd& states) : numQubits(0) {
+    Eigen::Index size = states.rows();
+    if (size < 2 || (size & (size - 1)) != 0) {
+        throw std::invalid_argument("State vector size must be a power of two");
+    }
+    if (states.cols() < 1) {
+        throw std::invalid_argument("Batch needs at least one state");
+    }
+    for (Eigen::Index column = 0; column < states.cols(); ++column) {
+        if (std::abs(states.col(column).squaredNorm() - 1.0) > 1e-10) {
+            throw std::invalid_argument("State vector does not satisfy normalization condition");
+        }
+    }
+    while ((static_cast<Eigen::Index>(1) << numQubits) < size) {
+        ++numQubits;
+    }
+    amplitudes = states;
+}
+
+/*
+
+    FUNCTION: applyGate(qubits, gate) / applyControlledGate(control, target, gate):
+                a controlled gate is the 2x2 gate on the half of the basis with the control set,
+                not a dense 4x4 product that would spend half of its work on the identity block
+
+*/
+void RegisterBatch::applyGate(const std::vector<int>& qubits, const Eigen::MatrixXcd& gate) {
+    checkQubits(qubits);
+    applyBlockGate(qubits, gate, 0);
+}
+
+void RegisterBatch::applyControlledGate(int control, int target, const Eigen::Matrix2cd& gate) {
+    checkQubits({ control, target });
+    applyBlockGate({ target }, gate, static_cast<size_t>(1) << control);
+}
+
+/*
+
+    FUNCTION: applyBlockGate(qubits, gate, fixedMask):
+                the rows of the 2^k basis states that differ only in the gate qubits form one block, only the
+                blocks with every bit of fixedMask set are visited. several consecutive blocks are gathered side
+                by side into a tile of about TILE_COLUMNS columns so every product is a real GEMM even for small
+                batches, then the tile is scattered back
+
+*/
+void RegisterBatch::applyBlockGate(const std::vector<int>& qubits, const Eigen::MatrixXcd& gate, size_t fixedMask) {
+    const int k = static_cast<int>(qubits.size());
+    if (k < 1 || k > MAX_GATE_QUBITS) {
+        throw std::invalid_argument("Dense batch gates act on 1 to 8 qubits");
+    }
+    const Eigen::Index gateSize = static_cast<Eigen::Index>(1) << k;
+    if (gate.rows() != gateSize || gate.cols() != gateSize) {
+        throw std::invalid_argument("Gate size does not match its qubits");
+    }
+
+    size_t mask = 0;
+    std::vector<size_t> offsets(static_cast<size_t>(gateSize), 0);
+    for (int j = 0; j < k; ++j) {
+        mask |= static_cast<size_t>(1) << qubits[j];
+    }
+    for (size_t s = 0; s < offsets.size(); ++s) {
+        for (int j = 0; j < k; ++j) {
+            if ((s >> j) & 1) {
+                offsets[s] |= static_cast<size_t>(1) << qubits[j];
+            }
+        }
+    }
+
+    const Eigen::Index batch = getBatchSize();
+    const size_t blocks = static_cast<size_t>(getDimension()) >> (k + bitCount(fixedMask));
+    const size_t blocksPerTile = static_cast<size_t>(std::max<Eigen::Index>(1, TILE_COLUMNS / batch));
+    const size_t tiles = (blocks + blocksPerTile - 1) / blocksPerTile;
+    const size_t freeMask = ((static_cast<size_t>(1) << numQubits) - 1) & ~(mask | fixedMask);
+    const size_t skipMask = mask | fixedMask;
+
+    auto sweep = [&](size_t firstTile, size_t lastTile) {
+        BatchMatrix tile(gateSize, batch * static_cast<Eigen::Index>(blocksPerTile));
+        BatchMatrix result(gateSize, tile.cols());
+        std::vector<size_t> bases(blocksPerTile);
+
+        for (size_t tileIndex = firstTile; tileIndex < lastTile; ++tileIndex) {
+            const size_t blockBegin = tileIndex * blocksPerTile;
+            const size_t count = std::min(blocks, blockBegin + blocksPerTile) - blockBegin;
+            const Eigen::Index columns = batch * static_cast<Eigen::Index>(count);
+
+            size_t base = depositBits(blockBegin, freeMask);
+            for (size_t c = 0; c < count; ++c) {
+                bases[c] = base | fixedMask;
+                base = ((base | skipMask) + 1) & ~skipMask;
+            }
+
+            for (size_t c = 0; c < count; ++c) {
+                for (Eigen::Index s = 0; s < gateSize; ++s) {
+                    tile.block(s, static_cast<Eigen::Index>(c) * batch, 1, batch) = amplitudes.row(static_cast<Eigen::Index>(bases[c] + offsets[s]));
+                }
+            }
+            result.leftCols(columns).noalias() = gate * tile.leftCols(columns);
+            for (size_t c = 0; c < count; ++c) {
+                for (Eigen::Index s = 0; s < gateSize; ++s) {
+                    amplitudes.row(static_cast<Eigen::Index>(bases[c] + offsets[s])) = result.block(s, static_cast<Eigen::Index>(c) * batch, 1, batch);
+                }
+            }
+        }
+    };
+
+    //the threshold of the register applies to the amplitudes of the whole batch
+    if (static_cast<size_t>(getDimension() * batch) >= (static_cast<size_t>(1) << QuantumRegister::PARALLEL_QUBIT_THRESHOLD)) {
+        parallelFor(0, tiles, 1, sweep);
+    }
+    else {
+        sweep(0, tiles);
+    }
+}
+
+/*
+
+    FUNCTION: applySwap(qubitA, qubitB):
+                the row of every |..1..0..> basis state is exchanged with the one of |..0..1..>
+
+*/
+void RegisterBatch::applySwap(int qubitA, int qubitB) {
+    checkQubits({ qubitA });
+    checkQubits({ qubitB });
+    if (qubitA == qubitB) {
+        return;
+    }
+
+    const size_t maskA = static_cast<size_t>(1) << qubitA;
+    const size_t maskB = static_cast<size_t>(1) << qubitB;
+    for (size_t i = 0; i < static_cast<size_t>(getDimension()); ++i) {
+        if ((i & maskA) != 0 && (i & maskB) == 0) {
+            amplitudes.row(static_cast<Eigen::Index>(i)).swap(amplitudes.row(static_cast<Eigen::Index>((i & ~maskA) | maskB)));
+        }
+    }
+}
+
+/*
+
+    FUNCTION: expectationZ(qubit) / squaredNorms():
+                one value per state of the batch, computed row by row
+
+*/
+Eigen::VectorXd RegisterBatch::expectationZ(int qubit) const {
+    checkQubits({ qubit });
+    const size_t mask = static_cast<size_t>(1) << qubit;
+    Eigen::VectorXd result = Eigen::VectorXd::Zero(getBatchSize());
+    for (Eigen::Index i = 0; i < getDimension(); ++i) {
+        if ((static_cast<size_t>(i) & mask) != 0) {
+            result -= amplitudes.row(i).cwiseAbs2().transpose();
+        }
+        else {
+            result += amplitudes.row(i).cwiseAbs2().transpose();
+        }
+    }
+    return result;
+}
+
+Eigen::VectorXd RegisterBatch::squaredNorms() const {
+    return amplitudes.cwiseAbs2().colwise().sum().transpose();
+}
+
+/*
+
+    FUNCTION: controlledGate(gate) / kroneckerProduct(gates) / fourierMatrix(qubitCount, inverse):
+                dense forms of the compiled steps, gates[j] acts on bit j so the product is
+                gates[k-1] x ... x gates[0] and the Fourier matrix is F(y, x) = exp(+2 pi i x y / K) / sqrt(K)
+
+*/
+Eigen::MatrixXcd RegisterBatch::controlledGate(const Eigen::Matrix2cd& gate) {
+    Eigen::MatrixXcd result = Eigen::MatrixXcd::Identity(4, 4);
+    result.block<2, 2>(2, 2) = Eigen::MatrixXcd::Zero(2, 2);
+    //the target is bit 0, the rows with the control bit set are 2 and 3
+    result(2, 2) = gate(0, 0);
+    result(2, 3) = gate(0, 1);
+    result(3, 2) = gate(1, 0);
+    result(3, 3) = gate(1, 1);
+    return result;
+}
+
+Eigen::MatrixXcd RegisterBatch::kroneckerProduct(const std::vector<Eigen::Matrix2cd>& gates) {
+    Eigen::MatrixXcd result = Eigen::MatrixXcd::Identity(1, 1);
+    for (const Eigen::Matrix2cd& gate : gates) {
+        const Eigen::Index size = result.rows();
+        Eigen::MatrixXcd next(2 * size, 2 * size);
+        for (int row = 0; row < 2; ++row) {
+            for (int column = 0; column < 2; ++column) {
+                next.block(row * size, column * size, size, size) = gate(row, column) * result;
+            }
+        }
+        result = next;
+    }
+    return result;
+}
+
+Eigen::MatrixXcd RegisterBatch::fourierMatrix(int qubitCount, bool inverse) {
+    const Eigen::Index size = static_cast<Eigen::Index>(1) << qubitCount;
+    const double sign = inverse ? -1.0 : 1.0;
+    const double normalization = 1.0 / std::sqrt(static_cast<double>(size));
+    Eigen::MatrixXcd result(size, size);
+    for (Eigen::Index y = 0; y < size; ++y) {
+        for (Eigen::Index x = 0; x < size; ++x) {
+            double angle = sign * 2.0 * M_PI * static_cast<double>((x * y) % size) / static_cast<double>(size);
+            result(y, x) = std::polar(normalization, angle);
+        }
+    }
+    return result;
+}
@@ -0,0 +1,70 @@
+#ifndef REGISTER_BATCH_H
+#define REGISTER_BATCH_H
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+#include <Eigen/Dense>
+#include "QuantumRegister.h"
+
+
+/*
+
+    RegisterBatch class
+
+    B state vectors of N qubits evolved together, stored as a 2^N x B row major matrix so the B amplitudes
+    of a basis state are contiguous. a k qubit gate U is applied to a tile of 2^k rows gathered for several
+    basis blocks at once as the product
+
+                        tile' = U * tile,       tile is 2^k x (B * blocks)
+
+    which runs in the blocked complex GEMM kernels of Eigen instead of B separate vector sweeps
+
+*/
+class RegisterBatch {
+public:
+    using BatchMatrix = Eigen::Matrix<std::complex<double>, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+private:
+    int numQubits;
+    BatchMatrix amplitudes;
+
+    // Private helper methods
+    void checkQubits(const std::vector<int>& qubits) const;
+    void applyBlockGate(const std::vector<int>& qubits, const Eigen::MatrixXcd& gate, size_t fixedMask);
+
+public:
+    // gates on more qubits than this are too large to be applied densely
+    static constexpr int MAX_GATE_QUBITS = 8;
+    // target number of columns of a GEMM tile
+    static constexpr Eigen::Index TILE_COLUMNS = 512;
+
+    // Constructors, every state starts in |0...0> or is a normalized column of states
+    RegisterBatch(int qubitCount, Eigen::Index batchSize);
+    RegisterBatch(const Eigen::MatrixXcd& states);
+
+    // Getters
+    int getNumQubits() const { return numQubits; }
+    Eigen::Index getDimension() const { return amplitudes.rows(); }
+    Eigen::Index getBatchSize() const { return amplitudes.cols(); }
+    const BatchMatrix& getAmplitudes() const { return amplitudes; }
+    BatchMatrix& getAmplitudes() { return amplitudes; }
+    Eigen::MatrixXcd getStates() const { return amplitudes; }
+    Eigen::VectorXcd getState(Eigen::Index index) const { return amplitudes.col(index); }
+
+    //gate index bit j is qubit qubits[j], the same convention of the register basis
+    void applyGate(const std::vector<int>& qubits, const Eigen::MatrixXcd& gate);
+    void applyControlledGate(int control, int target, const Eigen::Matrix2cd& gate);
+    void applySwap(int qubitA, int qubitB);
+
+    // Statistics of every state of the batch
+    Eigen::VectorXd expectationZ(int qubit) const;
+    Eigen::VectorXd squaredNorms() const;
+
+    // Dense helpers for the gates the batch receives from a compiled circuit
+    static Eigen::MatrixXcd controlledGate(const Eigen::Matrix2cd& gate);     // bit 0 target, bit 1 control
+    static Eigen::MatrixXcd kroneckerProduct(const std::vector<Eigen::Matrix2cd>& gates);     // gates[j] on bit j
+    static Eigen::MatrixXcd fourierMatrix(int qubitCount, bool inverse);
+};
+
+#endif // REGISTER_BATCH_H
@@ -0,0 +1,594 @@
+#include "SabreRouter.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "CircuitDAG.h"
+
+/*
+
+    CONSTRUCTOR
+
+*/
+SabreRouter::SabreRouter(const CouplingMap& map, size_t extendedSetSize, double extendedSetWeight, double decay)
+    : couplingMap(map), lookaheadSize(extendedSetSize), lookaheadWeight(extendedSetWeight), decayIncrement(decay) {
+    if (!map.isConnected()) {
+        throw std::invalid_argument("Routing needs a connected coupling map");
+    }
+}
+
+/*
+
+    FUNCTION: route(circuit, initialLayout):
+                the DAG is flattened into successor lists once, a gate joins the front when its predecessor
+                count reaches zero. decays count the SWAPs of every qubit since the last executed gate, the
+                qubits that swapped are listed so the reset only visits them.
+                the scores are kept up to date instead of recomputed: the front and lookahead distance sums
+                change only for the gates of the two qubits a SWAP moves, and every candidate SWAP (edge next
+                to a blocked qubit) keeps the change of front and lookahead distance it would cause. every
+                physical qubit knows where the front partner of its occupant sits, so after a SWAP the edges
+                around the partners are shifted by the move of the partner instead of rescored, and only the
+                edges around the two swapped qubits and their lookahead partners are rescored. the score of a
+                candidate is a function of (front change, lookahead change, decay), so the candidates are
+                bucketed by that triple and a decision scores the non empty buckets, not the edges. the rare
+                candidates outside of the bucket range are scored one by one.
+                if the heuristic stops making progress the closest blocked gate is routed along a shortest path
+
+*/
+RoutingResult SabreRouter::route(const QuantumCircuit& circuit, const std::vector<int>& initialLayout) const {
+    const int logicalCount = circuit.getNumQubits();
+    const int physicalCount = couplingMap.getNumQubits();
+    if (logicalCount > physicalCount) {
+        throw std::invalid_argument("Circuit has more qubits than the device");
+    }
+
+    std::vector<int> layout(logicalCount);
+    std::vector<int> occupant(physicalCount, -1);
+    if (initialLayout.empty()) {
+        for (int logical = 0; logical < logicalCount; ++logical) {
+            layout[logical] = logical;
+        }
+    }
+    else {
+        if (static_cast<int>(initialLayout.size()) != logicalCount) {
+            throw std::invalid_argument("Initial layout needs one physical qubit per logical qubit");
+        }
+        layout = initialLayout;
+    }
+    for (int logical = 0; logical < logicalCount; ++logical) {
+        int physical = layout[logical];
+        if (physical < 0 || physical >= physicalCount || occupant[physical] >= 0) {
+            throw std::invalid_argument("Initial layout must map to distinct physical qubits");
+        }
+        occupant[physical] = logical;
+    }
+
+    RoutingResult result{ QuantumCircuit(physicalCount), layout, {}, 0 };
+    const std::vector<GateOperation>& operations = circuit.getOperations();
+
+    //the successor lists of the DAG are copied in one array, releasing gates in order then reads contiguous memory
+    std::vector<size_t> successorOffsets(operations.size() + 1, 0);
+    std::vector<size_t> successorList;
+    successorList.reserve(2 * operations.size());
+    std::vector<size_t> waiting(operations.size());
+    std::vector<size_t> ready;
+    {
+        const CircuitDAG dag(circuit);
+        for (size_t gate = 0; gate < operations.size(); ++gate) {
+            const std::vector<size_t>& successors = dag.getSuccessors(gate);
+            successorList.insert(successorList.end(), successors.begin(), successors.end());
+            successorOffsets[gate + 1] = successorList.size();
+            waiting[gate] = dag.getPredecessors(gate).size();
+            if (waiting[gate] == 0) {
+                ready.push_back(gate);
+            }
+        }
+    }
+
+    std::vector<long long> frontOf(logicalCount, -1);       // blocked front gate of every logical qubit
+    std::vector<int> partnerAt(physicalCount, -1);          // where the other qubit of that gate sits
+    std::vector<size_t> front;
+    std::vector<size_t> frontSlot(operations.size(), 0);
+    std::vector<std::vector<int>> lookaheadPartners(logicalCount);
+    std::vector<size_t> lookahead;
+    std::vector<size_t> previousLookahead;
+    std::vector<char> lookaheadMember(operations.size(), 0);
+    std::vector<size_t> lookaheadStamp(operations.size(), 0);
+    std::vector<size_t> queue;
+    size_t lookaheadEpoch = 0;
+    bool frontChanged = true;
+    long long frontSum = 0;
+    long long lookaheadSum = 0;
+
+    std::vector<int> decaySwaps(physicalCount, 0);
+    std::vector<int> decayed;                               // physical qubits swapped in this epoch
+    size_t swapsWithoutProgress = 0;
+    const size_t stallLimit = 10 + 2 * static_cast<size_t>(couplingMap.getDiameter());
+
+    //candidate SWAP state of an edge, kept together so that rescoring an edge touches a single cache line
+    struct CandidateEdge {
+        int first;
+        int second;
+        int bucket;             // -1 when no blocked qubit is next to the edge
+        int slot;               // position in the bucket
+        int frontDelta;
+        int lookaheadDelta;
+    };
+
+    //candidate buckets: (decay level, front change + 2, lookahead change + range), the last one holds the
+    //candidates out of range. the edges of every physical qubit are stored contiguously
+    const int lookaheadRange = 8;
+    const int lookaheadBuckets = 2 * lookaheadRange + 1;
+    const int decayLevels = 8;
+    const int bucketCount = decayLevels * 5 * lookaheadBuckets;
+    std::vector<CandidateEdge> edges;
+    std::vector<int> edgeOffsets(physicalCount + 1, 0);
+    for (const std::pair<int, int>& coupling : couplingMap.getEdges()) {
+        edges.push_back({ coupling.first, coupling.second, -1, 0, 0, 0 });
+        ++edgeOffsets[coupling.first + 1];
+        ++edgeOffsets[coupling.second + 1];
+    }
+    for (int physical = 0; physical < physicalCount; ++physical) {
+        edgeOffsets[physical + 1] += edgeOffsets[physical];
+    }
+    std::vector<int> edgesAt(edgeOffsets.back());
+    {
+        std::vector<int> filled(edgeOffsets.begin(), edgeOffsets.end() - 1);
+        for (size_t edge = 0; edge < edges.size(); ++edge) {
+            edgesAt[filled[edges[edge].first]++] = static_cast<int>(edge);
+            edgesAt[filled[edges[edge].second]++] = static_cast<int>(edge);
+        }
+    }
+    std::vector<std::vector<int>> buckets(bucketCount + 1);
+    std::vector<int> activeBuckets;                         // non empty buckets, the overflow one excluded
+    std::vector<int> activeSlot(bucketCount, 0);
+    std::vector<double> bucketFrontDelta(bucketCount);
+    std::vector<double> bucketLookaheadDelta(bucketCount);
+    std::vector<double> bucketDecay(bucketCount);
+    for (int bucket = 0; bucket < bucketCount; ++bucket) {
+        bucketFrontDelta[bucket] = bucket / lookaheadBuckets % 5 - 2;
+        bucketLookaheadDelta[bucket] = bucket % lookaheadBuckets - lookaheadRange;
+        bucketDecay[bucket] = 1.0 + bucket / (5 * lookaheadBuckets) * decayIncrement;
+    }
+    std::vector<int> dirtyEdges;
+    std::vector<char> isDirty(edges.size(), 0);
+
+    auto isRoutable = [&](size_t gate) {
+        return operations[gate].control >= 0 && operations[gate].type != GateType::Swap;
+    };
+    auto gateDistance = [&](size_t gate) {
+        return couplingMap.distance(layout[operations[gate].target], layout[operations[gate].control]);
+    };
+
+    auto markDirty = [&](int physical) {
+        for (int offset = edgeOffsets[physical]; offset < edgeOffsets[physical + 1]; ++offset) {
+            const int edge = edgesAt[offset];
+            if (!isDirty[edge]) {
+                isDirty[edge] = 1;
+                dirtyEdges.push_back(edge);
+            }
+        }
+    };
+    //the partners of a qubit see its moves, their edges are rescored with its own
+    auto markQubitDirty = [&](int logical) {
+        markDirty(layout[logical]);
+        if (partnerAt[layout[logical]] >= 0) {
+            markDirty(partnerAt[layout[logical]]);
+        }
+        for (int partner : lookaheadPartners[logical]) {
+            markDirty(layout[partner]);
+        }
+    };
+
+    auto placeEdge = [&](CandidateEdge& candidate, int edge, int bucket) {
+        const int previous = candidate.bucket;
+        if (previous == bucket) {
+            return;
+        }
+        if (previous >= 0) {
+            std::vector<int>& members = buckets[previous];
+            const int last = members.back();
+            members[candidate.slot] = last;
+            edges[last].slot = candidate.slot;
+            members.pop_back();
+            if (members.empty() && previous < bucketCount) {
+                activeBuckets[activeSlot[previous]] = activeBuckets.back();
+                activeSlot[activeBuckets.back()] = activeSlot[previous];
+                activeBuckets.pop_back();
+            }
+        }
+        candidate.bucket = bucket;
+        if (bucket >= 0) {
+            if (buckets[bucket].empty() && bucket < bucketCount) {
+                activeSlot[bucket] = static_cast<int>(activeBuckets.size());
+                activeBuckets.push_back(bucket);
+            }
+            candidate.slot = static_cast<int>(buckets[bucket].size());
+            buckets[bucket].push_back(edge);
+        }
+    };
+
+    //a gate on both swapped qubits keeps its distance and is skipped. both distances of a move are read from
+    //the row of the partner, the two ends of the edge are neighbors so they share its cache lines
+    auto scoreEdge = [&](int edge) {
+        CandidateEdge& candidate = edges[edge];
+        const int first = candidate.first;
+        const int second = candidate.second;
+        const int partnerFirst = partnerAt[first];
+        const int partnerSecond = partnerAt[second];
+        if (partnerFirst < 0 && partnerSecond < 0) {
+            placeEdge(candidate, edge, -1);
+            return;
+        }
+
+        int frontDelta = 0;
+        if (partnerFirst >= 0 && partnerFirst != second) {
+            frontDelta += couplingMap.distance(partnerFirst, second) - couplingMap.distance(partnerFirst, first);
+        }
+        if (partnerSecond >= 0 && partnerSecond != first) {
+            frontDelta += couplingMap.distance(partnerSecond, first) - couplingMap.distance(partnerSecond, second);
+        }
+        int lookaheadDelta = 0;
+        auto addMove = [&](int logical, int other, int from, int to) {
+            if (logical < 0) {
+                return;
+            }
+            for (int lookaheadPartner : lookaheadPartners[logical]) {
+                if (lookaheadPartner != other) {
+                    lookaheadDelta += couplingMap.distance(layout[lookaheadPartner], to) - couplingMap.distance(layout[lookaheadPartner], from);
+                }
+            }
+        };
+        addMove(occupant[first], occupant[second], first, second);
+        addMove(occupant[second], occupant[first], second, first);
+        candidate.frontDelta = frontDelta;
+        candidate.lookaheadDelta = lookaheadDelta;
+
+        const int level = std::max(decaySwaps[first], decaySwaps[second]);
+        if (level >= decayLevels || std::abs(lookaheadDelta) > lookaheadRange) {
+            placeEdge(candidate, edge, bucketCount);
+        }
+        else {
+            placeEdge(candidate, edge, (level * 5 + frontDelta + 2) * lookaheadBuckets + lookaheadDelta + lookaheadRange);
+        }
+    };
+
+    auto rescoreDirty = [&]() {
+        for (int edge : dirtyEdges) {
+            isDirty[edge] = 0;
+            scoreEdge(edge);
+        }
+        dirtyEdges.clear();
+    };
+
+    auto addToFront = [&](size_t gate) {
+        const int target = operations[gate].target;
+        const int control = operations[gate].control;
+        frontOf[target] = static_cast<long long>(gate);
+        frontOf[control] = static_cast<long long>(gate);
+        partnerAt[layout[target]] = layout[control];
+        partnerAt[layout[control]] = layout[target];
+        frontSlot[gate] = front.size();
+        front.push_back(gate);
+        frontSum += gateDistance(gate);
+        markDirty(layout[target]);
+        markDirty(layout[control]);
+        frontChanged = true;
+    };
+    auto removeFromFront = [&](size_t gate) {
+        const int target = operations[gate].target;
+        const int control = operations[gate].control;
+        frontOf[target] = -1;
+        frontOf[control] = -1;
+        partnerAt[layout[target]] = -1;
+        partnerAt[layout[control]] = -1;
+        front[frontSlot[gate]] = front.back();
+        frontSlot[front.back()] = frontSlot[gate];
+        front.pop_back();
+        frontSum -= gateDistance(gate);
+        markDirty(layout[target]);
+        markDirty(layout[control]);
+        frontChanged = true;
+    };
+
+    //swap the qubits sitting on two physical qubits, the front partners follow them
+    auto exchange = [&](int first, int second) {
+        const int logicalFirst = occupant[first];
+        const int logicalSecond = occupant[second];
+        occupant[first] = logicalSecond;
+        occupant[second] = logicalFirst;
+        if (logicalFirst >= 0) {
+            layout[logicalFirst] = second;
+        }
+        if (logicalSecond >= 0) {
+            layout[logicalSecond] = first;
+        }
+
+        //a gate on both qubits still joins them
+        const int partnerFirst = partnerAt[first];
+        const int partnerSecond = partnerAt[second];
+        if (partnerFirst != second) {
+            partnerAt[first] = partnerSecond;
+            partnerAt[second] = partnerFirst;
+            if (partnerFirst >= 0) {
+                partnerAt[partnerFirst] = second;
+            }
+            if (partnerSecond >= 0) {
+                partnerAt[partnerSecond] = first;
+            }
+        }
+    };
+
+    auto emit = [&](size_t gate) {
+        GateOperation mapped = operations[gate];
+        if (mapped.type == GateType::Swap) {
+            //a logical SWAP only relabels the layout
+            exchange(layout[mapped.target], layout[mapped.control]);
+            markQubitDirty(mapped.target);
+            markQubitDirty(mapped.control);
+        }
+        else {
+            mapped.target = layout[mapped.target];
+            if (mapped.control >= 0) {
+                mapped.control = layout[mapped.control];
+            }
+            result.circuit.addOperation(mapped);
+        }
+        for (size_t offset = successorOffsets[gate]; offset < successorOffsets[gate + 1]; ++offset) {
+            if (--waiting[successorList[offset]] == 0) {
+                ready.push_back(successorList[offset]);
+            }
+        }
+    };
+
+    //the front partner of a qubit that moved by one step, from previous to position, only sees the change of
+    //its own move on every edge around it. the clean candidates there take that change instead of a rescore,
+    //it is zero unless the qubit crossed a shortest path of the partner
+    auto shiftPartner = [&](int position, int previous) {
+        const int partner = partnerAt[position];
+        if (partner < 0 || partner == previous) {
+            return;
+        }
+        for (int offset = edgeOffsets[partner]; offset < edgeOffsets[partner + 1]; ++offset) {
+            const int edge = edgesAt[offset];
+            if (isDirty[edge]) {
+                continue;
+            }
+            CandidateEdge& candidate = edges[edge];
+            const int neighbor = candidate.first == partner ? candidate.second : candidate.first;
+            const int change = (couplingMap.distance(position, neighbor) - couplingMap.distance(position, partner)) -
+                (couplingMap.distance(previous, neighbor) - couplingMap.distance(previous, partner));
+            if (change == 0) {
+                continue;
+            }
+            candidate.frontDelta += change;
+            if (candidate.bucket < bucketCount) {
+                placeEdge(candidate, edge, candidate.bucket + change * lookaheadBuckets);
+            }
+        }
+    };
+
+    //the score of the candidate must be up to date, its distance changes are the changes of the two sums
+    auto applySwap = [&](int edge) {
+        const int first = edges[edge].first;
+        const int second = edges[edge].second;
+        int logicalFirst = occupant[first];
+        int logicalSecond = occupant[second];
+        frontSum += edges[edge].frontDelta;
+        lookaheadSum += edges[edge].lookaheadDelta;
+
+        exchange(first, second);
+        result.circuit.addSwap(first, second);
+        ++result.swapCount;
+
+        for (int physical : { first, second }) {
+            if (decaySwaps[physical]++ == 0) {
+                decayed.push_back(physical);
+            }
+            markDirty(physical);
+        }
+        shiftPartner(second, first);
+        shiftPartner(first, second);
+        for (int logical : { logicalFirst, logicalSecond }) {
+            if (logical < 0) {
+                continue;
+            }
+            for (int partner : lookaheadPartners[logical]) {
+                markDirty(layout[partner]);
+            }
+        }
+    };
+
+    //emit every ready gate that fits the layout, blocked two qubit gates stay in the front
+    auto advance = [&]() {
+        while (!ready.empty()) {
+            size_t gate = ready.back();
+            ready.pop_back();
+            if (isRoutable(gate) && gateDistance(gate) > 1) {
+                addToFront(gate);
+            }
+            else {
+                emit(gate);
+            }
+        }
+    };
+
+    //blocked front gates on the two swapped logical qubits may now be executable
+    auto releaseFront = [&](int logicalFirst, int logicalSecond) {
+        bool released = false;
+        for (int logical : { logicalFirst, logicalSecond }) {
+            if (logical < 0 || frontOf[logical] < 0) {
+                continue;
+            }
+            size_t gate = static_cast<size_t>(frontOf[logical]);
+            if (gateDistance(gate) == 1) {
+                removeFromFront(gate);
+                emit(gate);
+                released = true;
+            }
+        }
+        return released;
+    };
+
+    //next lookaheadSize two qubit gates reachable from the front. only the gates that join or leave the
+    //lookahead change the candidates
+    auto rebuildLookahead = [&]() {
+        previousLookahead.swap(lookahead);
+        lookahead.clear();
+        for (size_t gate : previousLookahead) {
+            lookaheadPartners[operations[gate].target].clear();
+            lookaheadPartners[operations[gate].control].clear();
+        }
+        lookaheadSum = 0;
+        ++lookaheadEpoch;
+
+        queue.assign(front.begin(), front.end());
+        for (size_t head = 0; head < queue.size() && lookahead.size() < lookaheadSize; ++head) {
+            for (size_t offset = successorOffsets[queue[head]]; offset < successorOffsets[queue[head] + 1]; ++offset) {
+                const size_t successor = successorList[offset];
+                if (lookaheadStamp[successor] == lookaheadEpoch) {
+                    continue;
+                }
+                lookaheadStamp[successor] = lookaheadEpoch;
+                queue.push_back(successor);
+                if (isRoutable(successor) && lookahead.size() < lookaheadSize) {
+                    const int target = operations[successor].target;
+                    const int control = operations[successor].control;
+                    lookahead.push_back(successor);
+                    lookaheadPartners[target].push_back(control);
+                    lookaheadPartners[control].push_back(target);
+                    lookaheadSum += gateDistance(successor);
+                    if (lookaheadMember[successor] == 0) {
+                        markDirty(layout[target]);
+                        markDirty(layout[control]);
+                    }
+                    lookaheadMember[successor] = 2;
+                }
+            }
+        }
+        for (size_t gate : previousLookahead) {
+            if (lookaheadMember[gate] == 1) {
+                markDirty(layout[operations[gate].target]);
+                markDirty(layout[operations[gate].control]);
+                lookaheadMember[gate] = 0;
+            }
+        }
+        for (size_t gate : lookahead) {
+            lookaheadMember[gate] = 1;
+        }
+        frontChanged = false;
+    };
+
+    advance();
+    while (!front.empty()) {
+        if (frontChanged) {
+            rebuildLookahead();
+        }
+
+        if (swapsWithoutProgress > stallLimit) {
+            //release valve: walk the closest blocked gate together along a shortest path. every hop may make
+            //other front gates executable, they are released as soon as that happens
+            size_t gate = *std::min_element(front.begin(), front.end(), [&](size_t a, size_t b) {
+                return gateDistance(a) < gateDistance(b);
+            });
+            while (frontOf[operations[gate].target] == static_cast<long long>(gate)) {
+                int from = layout[operations[gate].target];
+                int to = couplingMap.nextHop(from, layout[operations[gate].control]);
+                int hop = -1;
+                for (int offset = edgeOffsets[from]; hop < 0; ++offset) {
+                    if (edges[edgesAt[offset]].first == to || edges[edgesAt[offset]].second == to) {
+                        hop = edgesAt[offset];
+                    }
+                }
+                int logicalFirst = occupant[from];
+                int logicalSecond = occupant[to];
+                rescoreDirty();
+                applySwap(hop);
+                releaseFront(logicalFirst, logicalSecond);
+            }
+        }
+        else {
+            rescoreDirty();
+            const double frontScale = 1.0 / static_cast<double>(front.size());
+            const double lookaheadScale = lookahead.empty() ? 0.0 : lookaheadWeight / static_cast<double>(lookahead.size());
+            const double baseScore = static_cast<double>(frontSum) * frontScale + lookaheadScale * static_cast<double>(lookaheadSum);
+
+            double bestScore = std::numeric_limits<double>::infinity();
+            int bestBucket = -1;
+            for (int bucket : activeBuckets) {
+                const double score = (baseScore + bucketFrontDelta[bucket] * frontScale + lookaheadScale * bucketLookaheadDelta[bucket]) * bucketDecay[bucket];
+                if (score < bestScore) {
+                    bestScore = score;
+                    bestBucket = bucket;
+                }
+            }
+            int bestEdge = bestBucket >= 0 ? buckets[bestBucket].front() : -1;
+            for (int edge : buckets[bucketCount]) {
+                const int level = std::max(decaySwaps[edges[edge].first], decaySwaps[edges[edge].second]);
+                const double score = (static_cast<double>(frontSum + edges[edge].frontDelta) * frontScale +
+                    lookaheadScale * static_cast<double>(lookaheadSum + edges[edge].lookaheadDelta)) * (1.0 + level * decayIncrement);
+                if (score < bestScore) {
+                    bestScore = score;
+                    bestEdge = edge;
+                }
+            }
+
+            int logicalFirst = occupant[edges[bestEdge].first];
+            int logicalSecond = occupant[edges[bestEdge].second];
+            applySwap(bestEdge);
+            ++swapsWithoutProgress;
+            if (!releaseFront(logicalFirst, logicalSecond)) {
+                continue;
+            }
+        }
+
+        advance();
+        swapsWithoutProgress = 0;
+        //the decays are back to zero, so are the decay levels of the edges around them. a clean candidate keeps
+        //its distance changes and only moves to the level 0 bucket, the others are rescored anyway
+        for (int physical : decayed) {
+            decaySwaps[physical] = 0;
+            for (int offset = edgeOffsets[physical]; offset < edgeOffsets[physical + 1]; ++offset) {
+                const int edge = edgesAt[offset];
+                CandidateEdge& candidate = edges[edge];
+                if (isDirty[edge] || candidate.bucket < 0) {
+                    continue;
+                }
+                if (candidate.bucket < bucketCount) {
+                    placeEdge(candidate, edge, candidate.bucket % (5 * lookaheadBuckets));
+                }
+                else if (std::abs(candidate.lookaheadDelta) <= lookaheadRange) {
+                    placeEdge(candidate, edge, (candidate.frontDelta + 2) * lookaheadBuckets + candidate.lookaheadDelta + lookaheadRange);
+                }
+            }
+        }
+        decayed.clear();
+    }
+
+    result.finalLayout = layout;
+    return result;
+}
+
+/*
+
+    FUNCTION: findInitialLayout(circuit, passes):
+                only the order of the gates matters for routing, so the reversed circuit is the gate list backwards
+
+*/
+std::vector<int> SabreRouter::findInitialLayout(const QuantumCircuit& circuit, int passes) const {
+    QuantumCircuit reversed(circuit.getNumQubits());
+    const std::vector<GateOperation>& operations = circuit.getOperations();
+    for (size_t k = operations.size(); k-- > 0;) {
+        reversed.addOperation(operations[k]);
+    }
+
+    std::vector<int> layout;
+    for (int pass = 0; pass < passes; ++pass) {
+        layout = route(circuit, layout).finalLayout;
+        layout = route(reversed, layout).finalLayout;
+    }
+    return layout;
+}
@@ -0,0 +1,163 @@
+#include "SimulationWorker.h"
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+#include "CompiledCircuit.h"
+
+/*
+
+    CONSTRUCTOR / DESTRUCTOR
+
+*/
+SimulationWorker::SimulationWorker()
+    : pendingSequences{ 0, 0 },
+    submittedSequence(0),
+    finishedSequence(0),
+    runningSource(SimulationSource::QubitState),
+    stopping(false) {
+    thread = std::thread(&SimulationWorker::run, this);
+}
+
+SimulationWorker::~SimulationWorker() {
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        stopping = true;
+        runningToken.cancel();
+    }
+    requestReady.notify_one();
+    //a simulation already running stops at its next cancellation point
+    thread.join();
+}
+
+/*
+
+    FUNCTION: submit(request):
+                the mailbox holds one request per source, a newer one replaces the request of its source so the
+                worker always jumps to the latest state of the controls instead of replaying every intermediate
+                one. the request being simulated is outdated as well when it came from the same source, so it is
+                cancelled, a request of the other source waits for it
+
+*/
+std::uint64_t SimulationWorker::submit(SimulationRequest request) {
+    if (request.initialState.size() == 0 && !request.circuit) {
+        throw std::invalid_argument("Simulation request needs an initial state or a circuit");
+    }
+
+    const std::uint64_t sequence = ++submittedSequence;
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        const SimulationSource source = request.source;
+        pendingRequests[static_cast<int>(source)] = std::move(request);
+        pendingSequences[static_cast<int>(source)] = sequence;
+        if (runningSource == source) {
+            runningToken.cancel();
+        }
+    }
+    requestReady.notify_one();
+    return sequence;
+}
+
+const DisplaySnapshot& SimulationWorker::latestSnapshot() {
+    snapshots.update();
+    return snapshots.readSlot();
+}
+
+/*
+
+    FUNCTION: run():
+                body of the simulation thread, waits for a request, fills the back slot of the triple buffer
+                and publishes it. the oldest waiting request goes first so one source cannot starve the other,
+                every request gets its own cancellation token
+
+*/
+void SimulationWorker::run() {
+    while (true) {
+        SimulationRequest request;
+        std::uint64_t sequence = 0;
+        CancellationToken token;
+        {
+            std::unique_lock<std::mutex> lock(requestMutex);
+            requestReady.wait(lock, [this]() { return stopping || pendingSequences[0] != 0 || pendingSequences[1] != 0; });
+            if (stopping) {
+                return;
+            }
+
+            int slot = pendingSequences[0] != 0 ? 0 : 1;
+            if (pendingSequences[1] != 0 && pendingSequences[1] < pendingSequences[slot]) {
+                slot = 1;
+            }
+            request = std::move(pendingRequests[slot]);
+            sequence = pendingSequences[slot];
+            pendingSequences[slot] = 0;
+            runningToken = token;
+            runningSource = request.source;
+        }
+
+        //a cancelled simulation publishes nothing, the request that cancelled it is already waiting
+        ScopedTaskContext context(TaskPriority::Interactive, token);
+        if (simulate(request, sequence, snapshots.writeSlot())) {
+            snapshots.publish();
+        }
+        finishedSequence.store(sequence, std::memory_order_release);
+    }
+}
+
+/*
+
+    FUNCTION: simulate(request, sequence, snapshot):
+                runs the circuit and reads the statistics the renderer needs, the register itself never leaves
+                this thread. a circuit with constant angles and no initial state resumes from the incremental
+                cache, anything else is compiled and run from scratch.
+                false when the request was cancelled, the snapshot is then left half written and not published
+
+*/
+bool SimulationWorker::simulate(const SimulationRequest& request, std::uint64_t sequence, DisplaySnapshot& snapshot) {
+    const auto start = std::chrono::steady_clock::now();
+    snapshot.sequence = sequence;
+    snapshot.source = request.source;
+    snapshot.failed = false;
+    snapshot.error.clear();
+
+    try {
+        if (request.initialState.size() == 0 && request.circuit->getNumParameters() == 0) {
+            readStatistics(incremental.simulate(*request.circuit), snapshot);
+        }
+        else {
+            QuantumRegister state = request.initialState.size() > 0
+                ? QuantumRegister(request.initialState)
+                : QuantumRegister(request.circuit->getNumQubits());
+
+            if (request.circuit) {
+                CompiledCircuit(*request.circuit).execute(state, request.parameters);
+            }
+            readStatistics(state, snapshot);
+        }
+    }
+    catch (const TaskCancelled&) {
+        return false;
+    }
+    catch (const std::exception& e) {
+        snapshot.failed = true;
+        snapshot.error = e.what();
+        snapshot.numQubits = 0;
+        snapshot.blochVectors.clear();
+        snapshot.amplitudes.resize(0);
+    }
+
+    snapshot.simulationSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+//one sweep over the register for the Bloch vectors, the amplitudes are copied only for small registers
+void SimulationWorker::readStatistics(const QuantumRegister& state, DisplaySnapshot& snapshot) {
+    snapshot.numQubits = state.getNumQubits();
+    snapshot.blochVectors = state.reducedBlochVectors();
+
+    if (snapshot.numQubits <= AMPLITUDE_QUBITS) {
+        snapshot.amplitudes = state.getAmplitudes();
+    }
+    else {
+        snapshot.amplitudes.resize(0);
+    }
+}
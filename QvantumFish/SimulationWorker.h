@@ -0,0 +1,104 @@
+#ifndef SIMULATION_WORKER_H
+#define SIMULATION_WORKER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <Eigen/Dense>
+#include "IncrementalSimulator.h"
+#include "QuantumCircuit.h"
+#include "QuantumRegister.h"
+#include "TaskScheduler.h"
+#include "TripleBuffer.h"
+
+//who asked for a simulation, every source has its own slot in the mailbox of the worker
+enum class SimulationSource {
+    QubitState = 0,     // presets and custom angles of the single qubit panel
+    Program = 1         // circuit of the editor
+};
+
+//what the simulation thread should compute, the circuit runs on initialState (|0...0> when empty)
+struct SimulationRequest {
+    Eigen::VectorXcd initialState;
+    std::shared_ptr<const QuantumCircuit> circuit;
+    std::vector<double> parameters;
+    SimulationSource source = SimulationSource::QubitState;
+};
+
+//everything the renderer draws of a simulated state, copied out of the register by the simulation thread
+struct DisplaySnapshot {
+    std::uint64_t sequence = 0;                 // request that produced it, 0 before the first one
+    SimulationSource source = SimulationSource::QubitState;
+    int numQubits = 0;
+    std::vector<Eigen::Vector3d> blochVectors;  // reduced Bloch vector of every qubit
+    Eigen::VectorXcd amplitudes;                // full state, only for registers up to AMPLITUDE_QUBITS
+    double simulationSeconds = 0.0;
+    bool failed = false;                        // the request threw, the other fields are left empty
+    std::string error;                          // what it threw, empty when it did not fail
+};
+
+
+/*
+
+    SimulationWorker class
+
+    runs the simulation on its own thread so the render loop never waits for a large register. the renderer
+    submits requests, only the latest one of every source is kept when the worker is busy (a preset clicked while
+    the editor program runs does not drop the program) and the oldest waiting source goes first. it reads the
+    last finished snapshot through a lock free triple buffer: the frame loop sees either the previous or the new
+    snapshot, never a half written one, and never blocks on the simulation. the request mailbox holds its mutex
+    only to move a request. the simulation runs as interactive work on the TaskScheduler, its loops take the
+    cores before any batch sweep, and a newer request of the same source cancels the one still running at its
+    next parallel loop instead of waiting for it. circuits with constant angles that start from |0...0> (the
+    programs of the editor) go through an IncrementalSimulator, an edit only replays the gates after the last
+    checkpoint before it
+
+*/
+class SimulationWorker {
+private:
+    TripleBuffer<DisplaySnapshot> snapshots;
+    std::thread thread;
+    std::mutex requestMutex;
+    std::condition_variable requestReady;
+    SimulationRequest pendingRequests[2];   // one slot per SimulationSource
+    std::uint64_t pendingSequences[2];      // 0 when the slot is empty
+    std::uint64_t submittedSequence;
+    std::atomic<std::uint64_t> finishedSequence;
+    CancellationToken runningToken;         // token of the request being simulated
+    SimulationSource runningSource;
+    bool stopping;
+    IncrementalSimulator incremental;   // prefix checkpoints, only touched by the simulation thread
+
+    // Private helper methods
+    void run();
+    bool simulate(const SimulationRequest& request, std::uint64_t sequence, DisplaySnapshot& snapshot);
+    static void readStatistics(const QuantumRegister& state, DisplaySnapshot& snapshot);
+
+public:
+    // snapshots carry the whole state vector up to this size, larger registers only their statistics
+    static constexpr int AMPLITUDE_QUBITS = 10;
+
+    // Constructor / Destructor, the thread starts with the worker and is joined by the destructor
+    SimulationWorker();
+    ~SimulationWorker();
+
+    SimulationWorker(const SimulationWorker&) = delete;
+    SimulationWorker& operator=(const SimulationWorker&) = delete;
+
+    //replaces the request of the same source still waiting and cancels the one running, returns its sequence number
+    std::uint64_t submit(SimulationRequest request);
+
+    //latest finished snapshot, a new one is picked up only by this call so the reference stays valid until the next one
+    const DisplaySnapshot& latestSnapshot();
+    bool hasNewSnapshot() const { return snapshots.hasFreshValue(); }
+
+    //true while a submitted request has not produced its snapshot yet
+    bool isBusy() const { return finishedSequence.load(std::memory_order_acquire) < submittedSequence; }
+};
+
+#endif // SIMULATION_WORKER_H
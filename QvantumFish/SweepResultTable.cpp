@@ -0,0 +1,55 @@
+#include "SweepResultTable.h"
+#include <ostream>
+#include <stdexcept>
+
+/*
+
+    CONSTRUCTOR
+
+*/
+SweepResultTable::SweepResultTable(const std::vector<std::string>& names, size_t rows)
+    : columnNames(names), columns(names.size(), std::vector<double>(rows, 0.0)), rowCount(rows) {
+}
+
+/*
+
+    FUNCTION: findColumn(name) / getColumn(name):
+                look a column up by name, findColumn returns -1 when it does not exist
+
+*/
+int SweepResultTable::findColumn(const std::string& name) const {
+    for (size_t column = 0; column < columnNames.size(); ++column) {
+        if (columnNames[column] == name) {
+            return static_cast<int>(column);
+        }
+    }
+    return -1;
+}
+
+const std::vector<double>& SweepResultTable::getColumn(const std::string& name) const {
+    int column = findColumn(name);
+    if (column < 0) {
+        throw std::out_of_range("Unknown sweep result column: " + name);
+    }
+    return columns[column];
+}
+
+/*
+
+    FUNCTION: writeCSV(stream):
+                dump the table with a header line, one row per parameter binding
+
+*/
+void SweepResultTable::writeCSV(std::ostream& stream) const {
+    for (size_t column = 0; column < columnNames.size(); ++column) {
+        stream << (column == 0 ? "" : ",") << columnNames[column];
+    }
+    stream << "\n";
+
+    for (size_t row = 0; row < rowCount; ++row) {
+        for (size_t column = 0; column < columns.size(); ++column) {
+            stream << (column == 0 ? "" : ",") << columns[column][row];
+        }
+        stream << "\n";
+    }
+}
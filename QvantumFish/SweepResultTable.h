@@ -0,0 +1,43 @@
+#ifndef SWEEP_RESULT_TABLE_H
+#define SWEEP_RESULT_TABLE_H
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+
+/*
+
+    SweepResultTable class
+
+    columnar table filled by the parameter sweep, every column is a contiguous vector of rows
+    and all of them are allocated up front so workers can write their rows without locking
+
+*/
+class SweepResultTable {
+private:
+    std::vector<std::string> columnNames;
+    std::vector<std::vector<double>> columns;
+    size_t rowCount;
+
+public:
+    // Constructor
+    SweepResultTable(const std::vector<std::string>& names, size_t rows);
+
+    // Getters
+    size_t getRowCount() const { return rowCount; }
+    size_t getColumnCount() const { return columns.size(); }
+    const std::string& getColumnName(size_t column) const { return columnNames.at(column); }
+    const std::vector<double>& getColumn(size_t column) const { return columns.at(column); }
+    const std::vector<double>& getColumn(const std::string& name) const;
+    int findColumn(const std::string& name) const;
+
+    // Cell access, set is safe to call concurrently for different rows
+    double get(size_t row, size_t column) const { return columns[column][row]; }
+    void set(size_t row, size_t column, double value) { columns[column][row] = value; }
+
+    // Output
+    void writeCSV(std::ostream& stream) const;
+};
+
+#endif // SWEEP_RESULT_TABLE_H
@@ -0,0 +1,190 @@
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <utility>
+#include "ParallelUtils.h"
+
+/*
+
+    FUNCTION: TaskGroup::finish(taskError) / isFinished() / wait(helpPriority):
+                the waiting thread keeps running pending tasks while the group is open and sleeps only when
+                there is nothing left it may run. the first error of the group is kept and rethrown by wait
+
+*/
+void TaskGroup::finish(std::exception_ptr taskError) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (taskError && !error) {
+        error = taskError;
+    }
+    if (--remaining == 0) {
+        finished.notify_all();
+    }
+}
+
+bool TaskGroup::isFinished() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return remaining == 0;
+}
+
+void TaskGroup::wait(TaskPriority helpPriority) {
+    TaskScheduler& scheduler = TaskScheduler::instance();
+    while (!isFinished()) {
+        if (!scheduler.runPendingTask(helpPriority)) {
+            std::unique_lock<std::mutex> lock(mutex);
+            finished.wait(lock, [this]() { return remaining == 0; });
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+/*
+
+    CONSTRUCTOR / DESTRUCTOR
+
+*/
+TaskScheduler::TaskScheduler() : pendingTasks(0), nextQueue(0), stopping(false) {
+    const size_t workerCount = std::max<size_t>(1, parallelWorkerCount() - 1);
+    for (size_t worker = 0; worker < workerCount; ++worker) {
+        queues.emplace_back(new WorkerQueue());
+    }
+    for (size_t worker = 0; worker < workerCount; ++worker) {
+        workers.emplace_back(&TaskScheduler::workerLoop, this, worker);
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+TaskScheduler& TaskScheduler::instance() {
+    static TaskScheduler scheduler;
+    return scheduler;
+}
+
+//index of the worker running on this thread, -1 on the other threads
+static int& currentWorkerIndex() {
+    thread_local int index = -1;
+    return index;
+}
+
+/*
+
+    FUNCTION: push(task):
+                the pending counter is raised under the sleep mutex so a worker that just found every deque
+                empty cannot miss the wake up
+
+*/
+void TaskScheduler::push(ScheduledTask task) {
+    const int worker = currentWorkerIndex();
+    const size_t queue = worker >= 0 ? static_cast<size_t>(worker) : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    const size_t priority = static_cast<size_t>(task.context.priority);
+    {
+        std::lock_guard<std::mutex> lock(queues[queue]->mutex);
+        queues[queue]->tasks[priority].push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        pendingTasks.fetch_add(1, std::memory_order_relaxed);
+    }
+    taskAvailable.notify_one();
+}
+
+/*
+
+    FUNCTION: takeTask(worker, lowestPriority, task):
+                priorities are scanned in order over all the deques, so an interactive task anywhere wins over
+                a batch task on the own deque. the own deque is popped at the back, the others at the front
+
+*/
+bool TaskScheduler::takeTask(int worker, TaskPriority lowestPriority, ScheduledTask& task) {
+    if (pendingTasks.load(std::memory_order_relaxed) == 0) {
+        return false;
+    }
+
+    const size_t queueCount = queues.size();
+    const size_t start = worker >= 0 ? static_cast<size_t>(worker) : 0;
+    for (size_t priority = 0; priority <= static_cast<size_t>(lowestPriority); ++priority) {
+        for (size_t offset = 0; offset < queueCount; ++offset) {
+            const size_t queue = (start + offset) % queueCount;
+            std::lock_guard<std::mutex> lock(queues[queue]->mutex);
+            std::deque<ScheduledTask>& tasks = queues[queue]->tasks[priority];
+            if (tasks.empty()) {
+                continue;
+            }
+            if (worker >= 0 && queue == static_cast<size_t>(worker)) {
+                task = std::move(tasks.back());
+                tasks.pop_back();
+            }
+            else {
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            pendingTasks.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+//tasks run in the context they were queued with, parallelFor chunks mark themselves as a parallel region
+void TaskScheduler::execute(ScheduledTask& task) {
+    ScopedTaskContext context(task.context.priority, task.context.token);
+    task.work();
+}
+
+bool TaskScheduler::runPendingTask(TaskPriority lowestPriority) {
+    ScheduledTask task;
+    if (!takeTask(currentWorkerIndex(), lowestPriority, task)) {
+        return false;
+    }
+    execute(task);
+    return true;
+}
+
+void TaskScheduler::workerLoop(size_t worker) {
+    currentWorkerIndex() = static_cast<int>(worker);
+    while (true) {
+        ScheduledTask task;
+        if (takeTask(static_cast<int>(worker), TaskPriority::Batch, task)) {
+            execute(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        taskAvailable.wait(lock, [this]() { return stopping || pendingTasks.load(std::memory_order_relaxed) > 0; });
+        if (stopping) {
+            return;
+        }
+    }
+}
+
+/*
+
+    FUNCTION: submit(work, priority, token):
+                the work is wrapped in a packaged task so its result and its errors reach the future
+
+*/
+std::future<void> TaskScheduler::submit(std::function<void()> work, TaskPriority priority, const CancellationToken& token) {
+    std::shared_ptr<std::packaged_task<void()>> packaged = std::make_shared<std::packaged_task<void()>>([work, token]() {
+        token.throwIfCancelled();
+        work();
+    });
+    std::future<void> result = packaged->get_future();
+
+    ScheduledTask task;
+    task.work = [packaged]() { (*packaged)(); };
+    task.context.priority = priority;
+    task.context.token = token;
+    push(std::move(task));
+    return result;
+}
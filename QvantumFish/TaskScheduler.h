@@ -0,0 +1,156 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+//interactive tasks (the displayed state, the edited program) are always taken before batch ones
+enum class TaskPriority {
+    Interactive = 0,
+    Batch = 1
+};
+
+//thrown where a cancelled task or parallel loop gives up
+class TaskCancelled : public std::runtime_error {
+public:
+    TaskCancelled() : std::runtime_error("Task was cancelled") {}
+};
+
+//copies share the same flag, cancel() is seen by every task that holds one of them
+class CancellationToken {
+private:
+    std::shared_ptr<std::atomic<bool>> flag;
+
+public:
+    CancellationToken() : flag(std::make_shared<std::atomic<bool>>(false)) {}
+
+    void cancel() const { flag->store(true, std::memory_order_relaxed); }
+    bool isCancelled() const { return flag->load(std::memory_order_relaxed); }
+    void throwIfCancelled() const {
+        if (isCancelled()) {
+            throw TaskCancelled();
+        }
+    }
+};
+
+//priority and token of the work running on the current thread, inherited by the tasks it spawns
+struct TaskContext {
+    TaskPriority priority = TaskPriority::Batch;
+    CancellationToken token;
+};
+
+inline TaskContext& currentTaskContext() {
+    thread_local TaskContext context;
+    return context;
+}
+
+//sets the context of the current thread for its lifetime
+class ScopedTaskContext {
+private:
+    TaskContext previous;
+
+public:
+    ScopedTaskContext(TaskPriority priority, const CancellationToken& token) : previous(currentTaskContext()) {
+        currentTaskContext().priority = priority;
+        currentTaskContext().token = token;
+    }
+    ~ScopedTaskContext() { currentTaskContext() = previous; }
+
+    ScopedTaskContext(const ScopedTaskContext&) = delete;
+    ScopedTaskContext& operator=(const ScopedTaskContext&) = delete;
+};
+
+//a unit of work with the context it runs in
+struct ScheduledTask {
+    std::function<void()> work;
+    TaskContext context;
+};
+
+//chunks of one parallel loop, the thread that started the loop waits here and helps in the meantime
+class TaskGroup {
+private:
+    std::mutex mutex;
+    std::condition_variable finished;
+    size_t remaining;
+    std::exception_ptr error;
+
+public:
+    explicit TaskGroup(size_t taskCount) : remaining(taskCount) {}
+
+    void finish(std::exception_ptr taskError = nullptr);
+    bool isFinished();
+
+    //runs pending tasks of at least the given priority until every task of the group finished, then rethrows the first error
+    void wait(TaskPriority helpPriority);
+};
+
+
+/*
+
+    TaskScheduler class
+
+    process wide pool shared by every parallel loop of the simulation, the compiler and the samplers instead of
+    each of them starting its own threads. every worker owns a deque per priority: it pushes and pops its own
+    tasks at the back (the most recent, still in cache) and idle workers steal from the front of the others.
+    a worker always looks for interactive tasks in every deque before it touches a batch one, so a sweep that
+    is running yields the cores to the displayed state at the next chunk boundary. cancellation is cooperative:
+    tasks check their token, and parallelFor checks it every time it is called
+
+*/
+class TaskScheduler {
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<ScheduledTask> tasks[2];
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+    std::mutex sleepMutex;
+    std::condition_variable taskAvailable;
+    std::atomic<size_t> pendingTasks;
+    std::atomic<size_t> nextQueue;
+    bool stopping;
+
+    // Private helper methods
+    TaskScheduler();
+    void workerLoop(size_t worker);
+    bool takeTask(int worker, TaskPriority lowestPriority, ScheduledTask& task);
+    static void execute(ScheduledTask& task);
+
+public:
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    //the pool is created on first use with one worker less than the hardware threads (the caller helps)
+    static TaskScheduler& instance();
+
+    // Getters
+    size_t getWorkerCount() const { return workers.size(); }
+    size_t getPendingTasks() const { return pendingTasks.load(std::memory_order_relaxed); }
+
+    //queues a task, from a worker it goes on its own deque and otherwise round robin on the others.
+    //the work must not throw, submit and parallelFor wrap theirs
+    void push(ScheduledTask task);
+
+    //runs one pending task of at least the given priority on the calling thread, false when there is none
+    bool runPendingTask(TaskPriority lowestPriority);
+
+    //background task with a future, a task cancelled before it starts never runs and its future throws TaskCancelled
+    std::future<void> submit(std::function<void()> work, TaskPriority priority = TaskPriority::Batch,
+        const CancellationToken& token = CancellationToken());
+};
+
+#endif // TASK_SCHEDULER_H
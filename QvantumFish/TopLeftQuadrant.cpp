@@ -9,6 +9,8 @@ TopLeftQuadrant::TopLeftQuadrant()
     showLineNumbers(true),
     cursorPosition(0),
     textModified(false),
+    textRevision(0),
+    programError(false),
     inputActive(false),
     cursorColumn(0),
     syncedScrollY(0.0f) {
@@ -56,11 +58,7 @@ void TopLeftQuadrant::renderTextEditor() {
     if (ImGui::BeginMenuBar()) {
         if (ImGui::BeginMenu("File")) {
             if (ImGui::MenuItem("New", "Ctrl+N")) {
-                textLines.clear();
-                textLines.push_back("");
-                cursorPosition = 0;
-                cursorColumn = 0;
-                textModified = false;
+                clearText();
             }
             if (ImGui::MenuItem("Save", "Ctrl+S")) {
                 std::cout << "Save functionality placeholder" << std::endl;
@@ -194,6 +192,12 @@ void TopLeftQuadrant::renderTextEditor() {
     ImGui::SameLine();
     if (textModified) {
         ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.0f, 1.0f), "Modified");
+        ImGui::SameLine();
+    }
+
+    if (!programStatus.empty()) {
+        const ImVec4 statusColor = programError ? ImVec4(1.0f, 0.35f, 0.35f, 1.0f) : ImVec4(0.5f, 0.8f, 0.5f, 1.0f);
+        ImGui::TextColored(statusColor, "%s", programStatus.c_str());
     }
 
     ImGui::PopStyleColor();
@@ -227,7 +231,7 @@ void TopLeftQuadrant::handleCharacterInput(unsigned int c) {
             if (cursorColumn <= line.length()) {
                 line.insert(cursorColumn, 1, static_cast<char>(c));
                 cursorColumn++;
-                textModified = true;
+                markModified();
             }
         }
     }
@@ -244,7 +248,7 @@ void TopLeftQuadrant::handleSpecialKeys() {
         if (cursorPosition >= 0 && cursorPosition < static_cast<int>(textLines.size())) {
             textLines[cursorPosition].insert(cursorColumn, "    ");
             cursorColumn += 4;
-            textModified = true;
+            markModified();
         }
     }
     else if (ImGui::IsKeyPressed(ImGuiKey_Delete)) {
@@ -300,11 +304,7 @@ void TopLeftQuadrant::handleCtrlCombinations() {
 
     if (io.KeyCtrl) {
         if (ImGui::IsKeyPressed(ImGuiKey_N)) {
-            textLines.clear();
-            textLines.push_back("");
-            cursorPosition = 0;
-            cursorColumn = 0;
-            textModified = false;
+            clearText();
         }
         else if (ImGui::IsKeyPressed(ImGuiKey_S)) {
             std::cout << "Save placeholder - Content has " << textLines.size() << " lines" << std::endl;
@@ -321,6 +321,26 @@ void TopLeftQuadrant::ensureCursorInBounds() {
     }
 }
 
+void TopLeftQuadrant::setProgramStatus(const std::string& status, bool isError) {
+    programStatus = status;
+    programError = isError;
+}
+
+// Every edit bumps the revision so the program is parsed and simulated again
+void TopLeftQuadrant::markModified() {
+    textModified = true;
+    ++textRevision;
+}
+
+void TopLeftQuadrant::clearText() {
+    textLines.clear();
+    textLines.push_back("");
+    cursorPosition = 0;
+    cursorColumn = 0;
+    textModified = false;
+    ++textRevision;
+}
+
 void TopLeftQuadrant::insertNewLine() {
     if (cursorPosition >= 0 && cursorPosition < static_cast<int>(textLines.size())) {
         std::string& currentLine = textLines[cursorPosition];
@@ -330,7 +350,7 @@ void TopLeftQuadrant::insertNewLine() {
         textLines.insert(textLines.begin() + cursorPosition + 1, newLine);
         cursorPosition++;
         cursorColumn = 0;
-        textModified = true;
+        markModified();
     }
 }
 
@@ -345,7 +365,7 @@ void TopLeftQuadrant::deleteCharacter(bool isBackspace) {
         if (cursorColumn > 0 && !line.empty()) {
             line.erase(cursorColumn - 1, 1);
             cursorColumn--;
-            textModified = true;
+            markModified();
         }
         else if (cursorColumn == 0 && cursorPosition > 0) {
             // Merge with previous line
@@ -355,19 +375,19 @@ void TopLeftQuadrant::deleteCharacter(bool isBackspace) {
             textLines.erase(textLines.begin() + cursorPosition);
             cursorPosition--;
             cursorColumn = prevLineLength;
-            textModified = true;
+            markModified();
         }
     }
     else { // Delete key
         if (cursorColumn < line.length()) {
             line.erase(cursorColumn, 1);
-            textModified = true;
+            markModified();
         }
         else if (cursorPosition < static_cast<int>(textLines.size()) - 1) {
             // Merge with next line
             line += textLines[cursorPosition + 1];
             textLines.erase(textLines.begin() + cursorPosition + 1);
-            textModified = true;
+            markModified();
         }
     }
 }
\ No newline at end of file
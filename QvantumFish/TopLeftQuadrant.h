@@ -15,6 +15,11 @@ public:
 
     glm::vec3 getBackgroundColor() const { return backgroundColor; }
 
+    // Program access, the revision changes on every edit of the text
+    const std::vector<std::string>& getTextLines() const { return textLines; }
+    size_t getTextRevision() const { return textRevision; }
+    void setProgramStatus(const std::string& status, bool isError);
+
 private:
     glm::vec3 backgroundColor;
 
@@ -23,6 +28,9 @@ private:
     bool showLineNumbers;
     int cursorPosition;
     bool textModified;
+    size_t textRevision;
+    std::string programStatus;
+    bool programError;
     bool inputActive;
     size_t cursorColumn;
 
@@ -38,6 +46,8 @@ private:
 
     // Helper methods
     void ensureCursorInBounds();
+    void markModified();
+    void clearText();
     void insertNewLine();
     void deleteCharacter(bool isBackspace);
 };
@@ -5,6 +5,7 @@
 #include <cmath>
 #include <glm/gtc/matrix_transform.hpp>
 #include <complex>
+#include <algorithm>
 #include <imgui.h>
 #include <imgui_impl_opengl3.h>
 #include <imgui_impl_glfw.h>
@@ -14,6 +15,12 @@ TopRightQuadrant::TopRightQuadrant()
     projectionLines(nullptr), angleArcs(nullptr),
     // Initialize with default qubit
     currentQubit(Qubit::ketZero()),
+    highlightedRegisterQubit(0), showRegisterQubits(true),
+    pulsePlaying(false), playbackStartTime(-1.0f), playbackSeconds(2.0f),
+    decayPlaying(false), showingMixedState(false), showingQutrit(false),
+    qutritGellMann(Qutrit::GellMannVector::Zero()), qutritLeakage(0.0), leakageSetting(0.1f),
+    decayT1(2.0f), decayT2(1.0f), decayDetuning(6.0f), decayDuration(6.0f),
+    pulseShape(0), pulseAngleDegrees(180.0f), pulseDetuning(0.0f), pulseDragCoefficient(0.0f),
     axesColor(glm::vec3(0.4f, 0.6f, 0.8f)),
     vectorColor(glm::vec3(1.0f, 0.3f, 0.3f)),
     projectionColor(glm::vec3(0.8f, 0.8f, 0.2f)),
@@ -74,6 +81,14 @@ void TopRightQuadrant::render(float time, SceneController* sceneController,
     // Clear only this quadrant's depth buffer to allow proper depth testing
     glClear(GL_DEPTH_BUFFER_BIT);
 
+    // Move the vector along the precomputed pulse trajectory or the decay solution
+    if (pulsePlaying) {
+        updatePulsePlayback(time);
+    }
+    else if (decayPlaying) {
+        updateDecayPlayback(time);
+    }
+
     // Get matrices from scene controller
     glm::mat4 view = sceneController->getViewMatrix();
     glm::mat4 projection = sceneController->getProjectionMatrix();
@@ -93,15 +108,26 @@ void TopRightQuadrant::render(float time, SceneController* sceneController,
         blochSphere->render(time, view, projection, scaledModel, yaw, pitch);
     }
 
-    if (showProjections && projectionLines) {
+    // Projections and arcs describe the pure current qubit, they are hidden while the vector is animated or mixed
+    if (showProjections && projectionLines && !isVectorDetached()) {
         projectionLines->render(time, view, projection, scaledModel, yaw, pitch);
     }
 
-    if (showArcs && angleArcs) {
+    if (showArcs && angleArcs && !isVectorDetached()) {
         angleArcs->render(time, view, projection, scaledModel, yaw, pitch);
     }
 
-    if (showVector && quantumVector) {
+    if (showVector && showRegisterQubits && !registerArrows.empty()) {
+        glLineWidth(2.5f);
+        for (size_t qubit = 0; qubit < registerArrows.size(); ++qubit) {
+            // A maximally mixed qubit sits at the center and has no direction to draw
+            if (glm::length(registerBlochVectors[qubit]) > 1e-4f) {
+                registerArrows[qubit]->render(time, view, projection, scaledModel, yaw, pitch);
+            }
+        }
+        glLineWidth(2.0f);
+    }
+    else if (showVector && quantumVector && glm::length(quantumVector->getPosition()) > 1e-4f) {
         glLineWidth(2.5f);
         quantumVector->render(time, view, projection, scaledModel, yaw, pitch);
         glLineWidth(2.0f);
@@ -144,6 +170,82 @@ void TopRightQuadrant::showSettingsWindow(int viewportX, int viewportY, int view
         // Slider automatically updates sphereScale
     }
 
+    if (!registerBlochVectors.empty()) {
+        ImGui::Separator();
+        ImGui::Text("Register Qubits (%d)", static_cast<int>(registerBlochVectors.size()));
+        ImGui::Checkbox("Show Register Qubits", &showRegisterQubits);
+
+        int highlighted = highlightedRegisterQubit;
+        if (ImGui::SliderInt("Highlight", &highlighted, 0, static_cast<int>(registerBlochVectors.size()) - 1)) {
+            setHighlightedRegisterQubit(highlighted);
+        }
+
+        const glm::vec3& bloch = registerBlochVectors[highlightedRegisterQubit];
+        ImGui::Text("r = (%.3f, %.3f, %.3f)  |r| = %.3f", bloch.x, bloch.y, bloch.z, glm::length(bloch));
+    }
+
+    ImGui::Separator();
+    ImGui::Text("Pulse Drive");
+    const char* pulseShapes[] = { "Rabi", "Gaussian", "DRAG" };
+    ImGui::Combo("Shape", &pulseShape, pulseShapes, 3);
+    ImGui::SliderFloat("Angle", &pulseAngleDegrees, 0.0f, 720.0f, "%.0f deg");
+    ImGui::SliderFloat("Detuning", &pulseDetuning, -10.0f, 10.0f, "%.2f");
+    if (pulseShape == 2) {
+        ImGui::SliderFloat("DRAG beta", &pulseDragCoefficient, -0.5f, 0.5f, "%.3f");
+    }
+    ImGui::SliderFloat("Playback", &playbackSeconds, 0.5f, 10.0f, "%.1f s");
+    if (ImGui::Button(pulsePlaying ? "Stop Pulse" : "Play Pulse")) {
+        if (pulsePlaying) {
+            stopPulse();
+            updateQubitState(currentQubit);
+        }
+        else {
+            playPulse(buildSettingsPulse());
+        }
+    }
+
+    ImGui::Separator();
+    ImGui::Text("Decoherence");
+    ImGui::SliderFloat("T1", &decayT1, 0.1f, 10.0f, "%.2f");
+    ImGui::SliderFloat("T2", &decayT2, 0.1f, 20.0f, "%.2f");
+    // T2 can never exceed 2 T1
+    decayT2 = std::min(decayT2, 2.0f * decayT1);
+    ImGui::SliderFloat("Precession", &decayDetuning, -10.0f, 10.0f, "%.2f");
+    ImGui::SliderFloat("Duration", &decayDuration, 0.1f, 20.0f, "%.1f");
+    if (ImGui::Button(decayPlaying ? "Stop Decay" : "Play Decay")) {
+        if (decayPlaying) {
+            decayPlaying = false;
+            showingMixedState = true;
+        }
+        else {
+            playDecay(LindbladEvolution(decayT1, decayT2, decayDetuning), decayDuration);
+        }
+    }
+
+    ImGui::Separator();
+    ImGui::Text("Leakage");
+    // The slider moves the shown qutrit live
+    if (ImGui::SliderFloat("Population |2>", &leakageSetting, 0.0f, 1.0f, "%.3f") && showingQutrit) {
+        showQutrit(buildSettingsQutrit());
+    }
+    if (ImGui::Button(showingQutrit ? "Hide Qutrit" : "Show Qutrit")) {
+        if (showingQutrit) {
+            updateQubitState(currentQubit);
+        }
+        else {
+            showQutrit(buildSettingsQutrit());
+        }
+    }
+    if (showingQutrit) {
+        ImGui::Text("Qutrit (Gell-Mann)  leakage to |2> = %.3f", qutritLeakage);
+        ImGui::Text("l1..l4 = (%.3f, %.3f, %.3f, %.3f)", qutritGellMann(0), qutritGellMann(1), qutritGellMann(2), qutritGellMann(3));
+        ImGui::Text("l5..l8 = (%.3f, %.3f, %.3f, %.3f)", qutritGellMann(4), qutritGellMann(5), qutritGellMann(6), qutritGellMann(7));
+    }
+    else if (decayPlaying || showingMixedState) {
+        float length = glm::length(getVectorPosition());
+        ImGui::Text("|r| = %.3f  purity = %.3f", length, (1.0f + length * length) / 2.0f);
+    }
+
     ImGui::Separator();
     if (ImGui::Button("Toggle All Components")) {
         toggleAllComponents();
@@ -245,8 +347,13 @@ void TopRightQuadrant::toggleAllComponents() {
 }
 
 void TopRightQuadrant::updateQubitState(const Qubit& qubit) {
-    // Update the stored qubit
+    // Update the stored qubit, a single qubit replaces any register, pulse or decay being shown
     currentQubit = qubit;
+    clearRegisterArrows();
+    pulsePlaying = false;
+    decayPlaying = false;
+    showingMixedState = false;
+    showingQutrit = false;
 
     glm::vec3 vectorPos = currentQubit.getBlochSphereCoordinates().convertToVec3();
 
@@ -271,6 +378,229 @@ void TopRightQuadrant::updateQubitState(const Qubit& qubit) {
     std::cout << "Vector position: (" << vectorPos.x << ", " << vectorPos.y << ", " << vectorPos.z << ")" << std::endl;
 }
 
+/*
+
+    FUNCTION: updateRegisterState(quantumRegister):
+                all the reduced Bloch vectors come from a single sweep of the register, the arrows are kept
+                between calls and only their geometry is refreshed so this can run every frame.
+                the vector overload takes the Bloch vectors of a snapshot computed on the simulation thread
+
+*/
+void TopRightQuadrant::updateRegisterState(const QuantumRegister& quantumRegister) {
+    updateRegisterState(quantumRegister.reducedBlochVectors());
+}
+
+void TopRightQuadrant::updateRegisterState(const std::vector<Eigen::Vector3d>& blochVectors) {
+    if (blochVectors.empty()) {
+        return;
+    }
+
+    if (blochVectors.size() != registerArrows.size()) {
+        clearRegisterArrows();
+        for (size_t qubit = 0; qubit < blochVectors.size(); ++qubit) {
+            registerArrows.push_back(new VectorArrow(glm::vec3(0.0f, 0.0f, 1.0f), 1.0f, 0.15f, 0.06f, 8, 16));
+        }
+        registerBlochVectors.assign(blochVectors.size(), glm::vec3(0.0f));
+        highlightedRegisterQubit = std::min(highlightedRegisterQubit, static_cast<int>(blochVectors.size()) - 1);
+    }
+
+    for (size_t qubit = 0; qubit < blochVectors.size(); ++qubit) {
+        glm::vec3 position(static_cast<float>(blochVectors[qubit].x()),
+            static_cast<float>(blochVectors[qubit].y()),
+            static_cast<float>(blochVectors[qubit].z()));
+
+        if (position != registerBlochVectors[qubit]) {
+            registerArrows[qubit]->setPosition(position);
+        }
+        registerArrows[qubit]->setColor(registerArrowColor(static_cast<int>(qubit)));
+        registerBlochVectors[qubit] = position;
+    }
+
+    rebuildHighlightGeometry(registerBlochVectors[highlightedRegisterQubit]);
+}
+
+void TopRightQuadrant::setHighlightedRegisterQubit(int qubit) {
+    if (qubit < 0 || qubit >= static_cast<int>(registerBlochVectors.size())) {
+        return;
+    }
+    highlightedRegisterQubit = qubit;
+
+    for (size_t index = 0; index < registerArrows.size(); ++index) {
+        registerArrows[index]->setColor(registerArrowColor(static_cast<int>(index)));
+    }
+    rebuildHighlightGeometry(registerBlochVectors[qubit]);
+}
+
+//the highlighted qubit uses the vector color, the others fade from cyan to violet
+glm::vec3 TopRightQuadrant::registerArrowColor(int qubit) const {
+    if (qubit == highlightedRegisterQubit) {
+        return vectorColor;
+    }
+    float t = registerArrows.size() > 1 ? static_cast<float>(qubit) / (registerArrows.size() - 1) : 0.0f;
+    return glm::mix(glm::vec3(0.2f, 0.8f, 0.9f), glm::vec3(0.6f, 0.4f, 0.9f), t) * 0.7f;
+}
+
+//projections and arcs follow the highlighted register qubit
+void TopRightQuadrant::rebuildHighlightGeometry(const glm::vec3& vectorPos) {
+    if (quantumVector && vectorPos == quantumVector->getPosition()) {
+        return;
+    }
+
+    delete projectionLines;
+    delete angleArcs;
+    projectionLines = new ProjectionLines(vectorPos, projectionColor, 0.03f, 25);
+    angleArcs = new AngleArcs(vectorPos, arcColor, 0.25f, 32);
+
+    if (quantumVector) {
+        quantumVector->setPosition(vectorPos);
+    }
+}
+
+void TopRightQuadrant::clearRegisterArrows() {
+    for (VectorArrow* arrow : registerArrows) {
+        delete arrow;
+    }
+    registerArrows.clear();
+    registerBlochVectors.clear();
+}
+
+/*
+
+    FUNCTION: playPulse(pulse) / updatePulsePlayback(time):
+                the whole trajectory of the current qubit is integrated when the pulse starts, every frame
+                then only looks up the Bloch vector at the matching pulse time. at the end the final state
+                becomes the current qubit
+
+*/
+void TopRightQuadrant::playPulse(const ControlPulse& pulse) {
+    clearRegisterArrows();
+    pulseTrajectory = PulseTrajectory(pulse, currentQubit);
+    playbackStartTime = -1.0f;
+    pulsePlaying = true;
+    decayPlaying = false;
+    showingMixedState = false;
+    showingQutrit = false;
+}
+
+void TopRightQuadrant::updatePulsePlayback(float time) {
+    if (playbackStartTime < 0.0f) {
+        playbackStartTime = time;
+    }
+
+    float progress = (time - playbackStartTime) / playbackSeconds;
+    if (progress >= 1.0f) {
+        updateQubitState(pulseTrajectory.finalQubit());
+        return;
+    }
+
+    Eigen::Vector3d bloch = pulseTrajectory.blochVectorAt(progress * pulseTrajectory.getDuration());
+    if (quantumVector) {
+        quantumVector->setPosition(glm::vec3(static_cast<float>(bloch.x()), static_cast<float>(bloch.y()), static_cast<float>(bloch.z())));
+    }
+}
+
+/*
+
+    FUNCTION: playDecay(model, modelDuration) / updateDecayPlayback(time):
+                the current qubit is the initial state of the decay, each frame evaluates the closed form
+                solution at the matching model time. the result is a mixed state that Qubit cannot hold,
+                so at the end the vector stays where it is until a new qubit state is set
+
+*/
+void TopRightQuadrant::playDecay(const LindbladEvolution& model, double modelDuration) {
+    clearRegisterArrows();
+    decayModel = model;
+    decayModel.setInitialState(MixedQubit(currentQubit));
+    decayDuration = static_cast<float>(modelDuration);
+    playbackStartTime = -1.0f;
+    pulsePlaying = false;
+    decayPlaying = true;
+    showingMixedState = false;
+    showingQutrit = false;
+}
+
+void TopRightQuadrant::updateDecayPlayback(float time) {
+    if (playbackStartTime < 0.0f) {
+        playbackStartTime = time;
+    }
+
+    float progress = std::min((time - playbackStartTime) / playbackSeconds, 1.0f);
+    Eigen::Vector3d bloch = decayModel.blochVectorAt(progress * decayDuration);
+    if (quantumVector) {
+        quantumVector->setPosition(glm::vec3(static_cast<float>(bloch.x()), static_cast<float>(bloch.y()), static_cast<float>(bloch.z())));
+    }
+
+    if (progress >= 1.0f) {
+        decayPlaying = false;
+        showingMixedState = true;
+    }
+}
+
+/*
+
+    FUNCTION: showMixedState(state):
+                the vector is moved inside the sphere and stays detached from the current qubit,
+                like the end of a decay, until a new qubit state is set
+
+*/
+void TopRightQuadrant::showMixedState(const MixedQubit& state) {
+    clearRegisterArrows();
+    pulsePlaying = false;
+    decayPlaying = false;
+    showingMixedState = true;
+    showingQutrit = false;
+
+    const Eigen::Vector3d& bloch = state.getBlochVector();
+    if (quantumVector) {
+        quantumVector->setPosition(glm::vec3(static_cast<float>(bloch.x()), static_cast<float>(bloch.y()), static_cast<float>(bloch.z())));
+    }
+}
+
+/*
+
+    FUNCTION: showQutrit(state):
+                lambda_1, lambda_2 and lambda_3 only involve |0> and |1>, they are the Bloch vector of the qubit
+                subspace scaled by its population, so the arrow sinks inside the sphere as the state leaks to |2>.
+                the whole Gell-Mann vector is listed in the settings window
+
+*/
+void TopRightQuadrant::showQutrit(const Qutrit& state) {
+    clearRegisterArrows();
+    pulsePlaying = false;
+    decayPlaying = false;
+    showingMixedState = true;
+    showingQutrit = true;
+
+    qutritGellMann = state.gellMannVector();
+    qutritLeakage = state.probability(2);
+    if (quantumVector) {
+        quantumVector->setPosition(glm::vec3(static_cast<float>(qutritGellMann(0)), static_cast<float>(qutritGellMann(1)),
+            static_cast<float>(qutritGellMann(2))));
+    }
+}
+
+//pulse of unit duration described by the settings window, the angle is the area of the envelope
+ControlPulse TopRightQuadrant::buildSettingsPulse() const {
+    const int samples = 200;
+    double angle = pulseAngleDegrees * M_PI / 180.0;
+    switch (pulseShape) {
+    case 1:
+        return ControlPulse::gaussian(angle, 1.0, samples, pulseDetuning);
+    case 2:
+        return ControlPulse::drag(angle, 1.0, samples, pulseDragCoefficient, pulseDetuning);
+    default:
+        return ControlPulse::rabi(angle, pulseDetuning, 1.0, samples);
+    }
+}
+
+//current qubit with the population of the settings window moved to |2>, the relative phase of |0> and |1> is kept
+Qutrit TopRightQuadrant::buildSettingsQutrit() const {
+    double kept = std::sqrt(1.0 - static_cast<double>(leakageSetting));
+    Qutrit::StateVector state;
+    state << kept * currentQubit.getAlpha(), kept * currentQubit.getBeta(), std::sqrt(static_cast<double>(leakageSetting));
+    return Qutrit(state);
+}
+
 glm::vec3 TopRightQuadrant::getVectorPosition() const {
     if (quantumVector) {
         return quantumVector->getPosition();
@@ -279,6 +609,7 @@ glm::vec3 TopRightQuadrant::getVectorPosition() const {
 }
 
 void TopRightQuadrant::cleanup() {
+    clearRegisterArrows();
     delete angleArcs;
     delete projectionLines;
     delete quantumVector;
@@ -2,6 +2,7 @@
 #define TOP_RIGHT_QUADRANT_H
 
 #include <glm/glm.hpp>
+#include <vector>
 #include "BlochSphere.h"
 #include "VectorArrow.h"
 #include "CoordinatesAxes.h"
@@ -9,6 +10,11 @@
 #include "AngleArcs.h"
 #include "SceneController.h"
 #include "Qubit.h"
+#include "Qudit.h"
+#include "QuantumRegister.h"
+#include "ControlPulse.h"
+#include "PulseTrajectory.h"
+#include "LindbladEvolution.h"
 
 class TopRightQuadrant {
 private:
@@ -22,6 +28,38 @@ private:
     // Current qubit state
     Qubit currentQubit;
 
+    // Reduced states of a multi-qubit register, one arrow per qubit
+    std::vector<glm::vec3> registerBlochVectors;
+    std::vector<VectorArrow*> registerArrows;
+    int highlightedRegisterQubit;
+    bool showRegisterQubits;
+
+    // Pulse playback, the trajectory is integrated once and only looked up every frame
+    PulseTrajectory pulseTrajectory;
+    bool pulsePlaying;
+    float playbackStartTime;
+    float playbackSeconds;
+
+    // Decay playback, the closed form Lindblad solution is evaluated every frame and the vector shrinks inside the sphere
+    LindbladEvolution decayModel;
+    bool decayPlaying;
+    bool showingMixedState;
+    // Gell-Mann vector of the last qutrit shown, the arrow holds its qubit subspace components
+    bool showingQutrit;
+    Qutrit::GellMannVector qutritGellMann;
+    double qutritLeakage;
+    float leakageSetting;
+    float decayT1;
+    float decayT2;
+    float decayDetuning;
+    float decayDuration;
+
+    // Pulse drive settings
+    int pulseShape;
+    float pulseAngleDegrees;
+    float pulseDetuning;
+    float pulseDragCoefficient;
+
     // Colors
     glm::vec3 axesColor;
     glm::vec3 vectorColor;
@@ -37,6 +75,16 @@ private:
 
     float sphereScale;
 
+    // Private helper methods
+    glm::vec3 registerArrowColor(int qubit) const;
+    void rebuildHighlightGeometry(const glm::vec3& vectorPos);
+    void clearRegisterArrows();
+    void updatePulsePlayback(float time);
+    void updateDecayPlayback(float time);
+    bool isVectorDetached() const { return pulsePlaying || decayPlaying || showingMixedState; }
+    ControlPulse buildSettingsPulse() const;
+    Qutrit buildSettingsQutrit() const;
+
     // Settings window control
     bool settingsWindowOpen;
     int windowWidth;
@@ -81,6 +129,31 @@ public:
     // Update qubit state
     void updateQubitState(const Qubit& qubit);
 
+    // Update the reduced Bloch vectors of every qubit of a register
+    void updateRegisterState(const QuantumRegister& quantumRegister);
+    void updateRegisterState(const std::vector<Eigen::Vector3d>& blochVectors);
+    const std::vector<glm::vec3>& getRegisterBlochVectors() const { return registerBlochVectors; }
+    int getHighlightedRegisterQubit() const { return highlightedRegisterQubit; }
+    void setHighlightedRegisterQubit(int qubit);
+    bool getShowRegisterQubits() const { return showRegisterQubits; }
+    void setShowRegisterQubits(bool visible) { showRegisterQubits = visible; }
+
+    // Drive the current qubit with a control pulse, played back over playbackSeconds
+    void playPulse(const ControlPulse& pulse);
+    void stopPulse() { pulsePlaying = false; }
+    bool isPulsePlaying() const { return pulsePlaying; }
+    void setPlaybackSeconds(float seconds) { playbackSeconds = seconds; }
+
+    // Let the current qubit decay for modelDuration, the vector stays at the final mixed state when it ends
+    void playDecay(const LindbladEvolution& model, double modelDuration);
+    bool isDecayPlaying() const { return decayPlaying; }
+
+    // Show a mixed state such as a tomography reconstruction, can be called every frame to stream a log
+    void showMixedState(const MixedQubit& state);
+
+    // Show a qutrit (a transmon with its leakage level) through its Gell-Mann vector
+    void showQutrit(const Qutrit& state);
+
     // Get current vector position
     glm::vec3 getVectorPosition() const;
 
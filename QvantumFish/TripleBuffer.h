@@ -0,0 +1,59 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <array>
+#include <atomic>
+
+
+/*
+
+    TripleBuffer class template
+
+    single producer, single consumer handoff of the latest value without locks. the three slots are owned
+    one by the writer (back), one by the reader (front) and one parked in the middle. publishing swaps the
+    back slot with the middle one and marks it fresh, reading swaps the front slot with the middle one only
+    when it is fresh. both swaps are a single atomic exchange, so neither side ever waits for the other:
+    the writer can publish at any rate and the reader always sees the latest complete value.
+    slots are reused, a writer that refills the vectors of its slot does not allocate after the first rounds
+
+*/
+template <typename T>
+class TripleBuffer {
+private:
+    static constexpr unsigned INDEX_MASK = 3u;
+    static constexpr unsigned FRESH_BIT = 4u;
+
+    std::array<T, 3> slots;
+    std::atomic<unsigned> middle;
+    unsigned back;      // writer side only
+    unsigned front;     // reader side only
+
+public:
+    // Constructor
+    TripleBuffer() : middle(1u), back(0u), front(2u) {}
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Writer side, fill writeSlot() and then publish it
+    T& writeSlot() { return slots[back]; }
+
+    void publish() {
+        back = middle.exchange(back | FRESH_BIT, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // Reader side, update() takes the latest published value if there is a new one and tells if it did
+    bool update() {
+        if ((middle.load(std::memory_order_relaxed) & FRESH_BIT) == 0) {
+            return false;
+        }
+        front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    const T& readSlot() const { return slots[front]; }
+
+    bool hasFreshValue() const { return (middle.load(std::memory_order_relaxed) & FRESH_BIT) != 0; }
+};
+
+#endif // TRIPLE_BUFFER_H
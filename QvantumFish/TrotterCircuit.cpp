@@ -0,0 +1,260 @@
+#include "TrotterCircuit.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <vector>
+#include <Eigen/Dense>
+
+/*
+
+    CONSTRUCTOR
+
+    the factors of all the steps are laid out once, adjacent factors of the same group are merged
+    so the half steps at the border of two Strang steps cost a single exponential
+
+*/
+TrotterCircuit::TrotterCircuit(const PauliSum& hamiltonian, double evolutionTime, int steps, int formulaOrder)
+    : numQubits(hamiltonian.getNumQubits()),
+    order(formulaOrder),
+    stepCount(steps),
+    time(evolutionTime),
+    termCount(hamiltonian.getTermCount()),
+    groups(groupTerms(hamiltonian)) {
+
+    if (formulaOrder != 1 && formulaOrder != 2 && formulaOrder != 4) {
+        throw std::invalid_argument("Trotter order must be 1, 2 or 4");
+    }
+    if (steps < 1) {
+        throw std::invalid_argument("Trotter circuit needs at least one step");
+    }
+    if (groups.empty()) {
+        return;
+    }
+
+    const double duration = evolutionTime / steps;
+    //Suzuki recursion S4(dt) = S2(p dt)^2 S2((1 - 4p) dt) S2(p dt)^2
+    const double p = 1.0 / (4.0 - std::cbrt(4.0));
+
+    for (int step = 0; step < steps; ++step) {
+        switch (formulaOrder) {
+        case 1:
+            for (size_t group = 0; group < groups.size(); ++group) {
+                appendFactor(factors, group, duration);
+            }
+            break;
+        case 2:
+            appendSecondOrderStep(factors, duration);
+            break;
+        case 4:
+            appendSecondOrderStep(factors, p * duration);
+            appendSecondOrderStep(factors, p * duration);
+            appendSecondOrderStep(factors, (1.0 - 4.0 * p) * duration);
+            appendSecondOrderStep(factors, p * duration);
+            appendSecondOrderStep(factors, p * duration);
+            break;
+        }
+    }
+}
+
+/*
+
+    FUNCTION: appendFactor(sequence, group, duration) / appendSecondOrderStep(sequence, duration):
+                the symmetric step is G1(dt/2) ... G(n-1)(dt/2) Gn(dt) G(n-1)(dt/2) ... G1(dt/2)
+
+*/
+void TrotterCircuit::appendFactor(std::vector<TrotterFactor>& sequence, size_t group, double duration) {
+    if (!sequence.empty() && sequence.back().group == group) {
+        sequence.back().duration += duration;
+        return;
+    }
+    sequence.push_back({ group, duration });
+}
+
+void TrotterCircuit::appendSecondOrderStep(std::vector<TrotterFactor>& sequence, double duration) const {
+    const size_t last = groups.size() - 1;
+    for (size_t group = 0; group < last; ++group) {
+        appendFactor(sequence, group, duration / 2.0);
+    }
+    appendFactor(sequence, last, duration);
+    for (size_t group = last; group-- > 0;) {
+        appendFactor(sequence, group, duration / 2.0);
+    }
+}
+
+/*
+
+    FUNCTION: groupTerms(hamiltonian):
+                a term joins the first group whose basis agrees with it on every qubit it acts on,
+                terms in the same group then commute qubit by qubit and share the same basis change.
+                the identity term fits in any group and only adds a global phase
+
+*/
+std::vector<CommutingGroup> TrotterCircuit::groupTerms(const PauliSum& hamiltonian) {
+    const int qubits = hamiltonian.getNumQubits();
+    std::vector<PauliTerm> terms = hamiltonian.getTerms();
+    std::stable_sort(terms.begin(), terms.end(), [](const PauliTerm& a, const PauliTerm& b) {
+        return std::abs(a.coefficient) > std::abs(b.coefficient);
+    });
+
+    std::vector<CommutingGroup> groups;
+    for (const PauliTerm& term : terms) {
+        if (term.coefficient == 0.0) {
+            continue;
+        }
+
+        CommutingGroup* destination = nullptr;
+        for (CommutingGroup& group : groups) {
+            bool compatible = true;
+            for (int qubit = 0; qubit < qubits && compatible; ++qubit) {
+                char letter = PauliSum::pauliAt(term, qubit);
+                compatible = letter == 'I' || group.basis[qubit] == 'I' || group.basis[qubit] == letter;
+            }
+            if (compatible) {
+                destination = &group;
+                break;
+            }
+        }
+        if (destination == nullptr) {
+            groups.push_back({ std::vector<char>(qubits, 'I'), {}, {} });
+            destination = &groups.back();
+        }
+
+        for (int qubit = 0; qubit < qubits; ++qubit) {
+            char letter = PauliSum::pauliAt(term, qubit);
+            if (letter != 'I') {
+                destination->basis[qubit] = letter;
+            }
+        }
+        destination->zMasks.push_back(term.xMask | term.zMask);
+        destination->coefficients.push_back(term.coefficient);
+    }
+    return groups;
+}
+
+/*
+
+    FUNCTION: basisChange(pauli):
+                H X H = Z and (H S^dagger) Y (S H) = Z, Z needs no change
+
+*/
+Eigen::Matrix2cd TrotterCircuit::basisChange(char pauli) {
+    switch (pauli) {
+    case 'X':
+        return QuantumCircuit::gateMatrix(GateType::Hadamard);
+    case 'Y':
+        return QuantumCircuit::gateMatrix(GateType::Hadamard) * QuantumCircuit::gateMatrix(GateType::SDagger);
+    default:
+        return Eigen::Matrix2cd::Identity();
+    }
+}
+
+/*
+
+    FUNCTION: execute(quantumRegister):
+                every qubit remembers the basis it is currently rotated to, a group only changes the qubits
+                it acts on and only when their basis differs, the change from the old basis to the new one is
+                a single 2x2 sweep. the register goes back to the computational basis at the end
+
+*/
+void TrotterCircuit::execute(QuantumRegister& quantumRegister) const {
+    if (quantumRegister.getNumQubits() != numQubits) {
+        throw std::invalid_argument("Register size does not match the Trotter circuit");
+    }
+
+    std::vector<char> frame(numQubits, 'Z');
+    std::vector<double> angles;
+
+    for (const TrotterFactor& factor : factors) {
+        const CommutingGroup& group = groups[factor.group];
+        for (int qubit = 0; qubit < numQubits; ++qubit) {
+            char letter = group.basis[qubit];
+            if (letter != 'I' && letter != frame[qubit]) {
+                quantumRegister.applySingleQubitGate(qubit, basisChange(letter) * basisChange(frame[qubit]).adjoint());
+                frame[qubit] = letter;
+            }
+        }
+
+        angles.resize(group.coefficients.size());
+        for (size_t k = 0; k < angles.size(); ++k) {
+            angles[k] = group.coefficients[k] * factor.duration;
+        }
+        quantumRegister.applyDiagonalPhases(group.zMasks, angles);
+    }
+
+    for (int qubit = 0; qubit < numQubits; ++qubit) {
+        if (frame[qubit] != 'Z') {
+            quantumRegister.applySingleQubitGate(qubit, basisChange(frame[qubit]).adjoint());
+        }
+    }
+}
+
+/*
+
+    FUNCTION: toCircuit():
+                exp(-i c dt Z_q0 ... Z_qm) is the parity of the qubits collected on qm by a CNOT ladder,
+                RZ(2 c dt) on qm and the ladder undone, the basis changes follow the same frames of execute.
+                the identity term is a global phase and is dropped
+
+*/
+QuantumCircuit TrotterCircuit::toCircuit() const {
+    QuantumCircuit circuit(numQubits);
+    std::vector<char> frame(numQubits, 'Z');
+
+    auto leaveBasis = [&](int qubit) {
+        if (frame[qubit] == 'X') {
+            circuit.addGate(GateType::Hadamard, qubit);
+        }
+        else if (frame[qubit] == 'Y') {
+            circuit.addGate(GateType::Hadamard, qubit);
+            circuit.addGate(GateType::S, qubit);
+        }
+        frame[qubit] = 'Z';
+    };
+    auto enterBasis = [&](int qubit, char letter) {
+        if (letter == 'X') {
+            circuit.addGate(GateType::Hadamard, qubit);
+        }
+        else if (letter == 'Y') {
+            circuit.addGate(GateType::SDagger, qubit);
+            circuit.addGate(GateType::Hadamard, qubit);
+        }
+        frame[qubit] = letter;
+    };
+
+    for (const TrotterFactor& factor : factors) {
+        const CommutingGroup& group = groups[factor.group];
+        for (int qubit = 0; qubit < numQubits; ++qubit) {
+            char letter = group.basis[qubit];
+            if (letter != 'I' && letter != frame[qubit]) {
+                leaveBasis(qubit);
+                enterBasis(qubit, letter);
+            }
+        }
+
+        for (size_t k = 0; k < group.zMasks.size(); ++k) {
+            std::vector<int> support;
+            for (int qubit = 0; qubit < numQubits; ++qubit) {
+                if ((group.zMasks[k] >> qubit) & 1) {
+                    support.push_back(qubit);
+                }
+            }
+            if (support.empty()) {
+                continue;
+            }
+
+            for (size_t i = 0; i + 1 < support.size(); ++i) {
+                circuit.addControlledGate(GateType::CNOT, support[i], support[i + 1]);
+            }
+            circuit.addRotation(GateType::RotationZ, support.back(), 2.0 * group.coefficients[k] * factor.duration);
+            for (size_t i = support.size() - 1; i-- > 0;) {
+                circuit.addControlledGate(GateType::CNOT, support[i], support[i + 1]);
+            }
+        }
+    }
+
+    for (int qubit = 0; qubit < numQubits; ++qubit) {
+        leaveBasis(qubit);
+    }
+    return circuit;
+}
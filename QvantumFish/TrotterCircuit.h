@@ -0,0 +1,78 @@
+#ifndef TROTTER_CIRCUIT_H
+#define TROTTER_CIRCUIT_H
+
+#include <cstdint>
+#include <vector>
+#include <Eigen/Dense>
+#include "PauliSum.h"
+#include "QuantumCircuit.h"
+#include "QuantumRegister.h"
+
+//Pauli terms acting with the same letter on every qubit they share, one basis change turns all of them into Z strings
+struct CommutingGroup {
+    std::vector<char> basis;                // letter of every qubit, 'I' when no term of the group acts on it
+    std::vector<std::uint64_t> zMasks;      // support of every term, its Z string once the basis is changed
+    std::vector<double> coefficients;
+};
+
+//exp(-i duration H_group), one factor of the product formula
+struct TrotterFactor {
+    size_t group;
+    double duration;
+};
+
+
+/*
+
+    TrotterCircuit class
+
+    product formula approximation of exp(-iHt) for a Pauli sum. the terms are split in qubit wise commuting
+    groups and every group exponential is done exactly as
+
+                    exp(-i dt H_group) = B^dagger exp(-i dt sum_k c_k Z_k) B
+
+    with B a layer of single qubit basis changes and the middle factor a single diagonal phase sweep.
+    steps of order 1 (Lie), 2 (Strang) and 4 (Suzuki) are supported
+
+*/
+class TrotterCircuit {
+private:
+    int numQubits;
+    int order;
+    int stepCount;
+    double time;
+    size_t termCount;
+    std::vector<CommutingGroup> groups;
+    std::vector<TrotterFactor> factors;
+
+    // Private helper methods
+    static void appendFactor(std::vector<TrotterFactor>& sequence, size_t group, double duration);
+    void appendSecondOrderStep(std::vector<TrotterFactor>& sequence, double duration) const;
+
+public:
+    // Constructor
+    TrotterCircuit(const PauliSum& hamiltonian, double evolutionTime, int steps, int formulaOrder = 2);
+
+    // Getters
+    int getNumQubits() const { return numQubits; }
+    int getOrder() const { return order; }
+    int getStepCount() const { return stepCount; }
+    double getTime() const { return time; }
+    size_t getTermCount() const { return termCount; }
+    const std::vector<CommutingGroup>& getGroups() const { return groups; }
+    const std::vector<TrotterFactor>& getFactors() const { return factors; }
+
+    //greedy qubit wise commuting partition, larger coefficients are placed first
+    static std::vector<CommutingGroup> groupTerms(const PauliSum& hamiltonian);
+
+    //single qubit B with B P B^dagger = Z
+    static Eigen::Matrix2cd basisChange(char pauli);
+
+    // Execution, every group exponential is one diagonal sweep plus the basis changes that differ from the previous group
+    void execute(QuantumRegister& quantumRegister) const;
+
+    //same product formula expanded to gates, every term becomes a CNOT ladder around an RZ
+    QuantumCircuit toCircuit() const;
+};
+
+#endif // TROTTER_CIRCUIT_H
@@ -0,0 +1,234 @@
+#include "UnitaryBuilder.h"
+#include <algorithm>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <Eigen/Dense>
+#include "CompiledCircuit.h"
+#include "HashUtils.h"
+#include "ParallelUtils.h"
+#include "RegisterBatch.h"
+
+//out of class definition, std::min in buildUnitary binds the constant to a reference
+constexpr Eigen::Index UnitaryBuilder::COLUMN_BLOCK;
+
+/*
+
+    CONSTRUCTOR
+
+*/
+UnitaryBuilder::UnitaryBuilder(size_t memoryBudgetBytes)
+    : memoryBudget(memoryBudgetBytes),
+    storedBytes(0),
+    useCounter(0),
+    cacheHits(0),
+    cacheMisses(0) {
+}
+
+size_t UnitaryBuilder::getCacheSize() const {
+    size_t size = 0;
+    for (const auto& bucket : cache) {
+        size += bucket.second.size();
+    }
+    return size;
+}
+
+const QuantumCircuit& UnitaryBuilder::getSubcircuit(const std::string& name) const {
+    auto found = subcircuits.find(name);
+    if (found == subcircuits.end()) {
+        throw std::invalid_argument("Unknown subcircuit: " + name);
+    }
+    return found->second;
+}
+
+/*
+
+    FUNCTION: defineSubcircuit(name, circuit) / clearCache():
+                the cache is keyed by structure and not by name, so redefining a name never leaves a stale unitary
+
+*/
+void UnitaryBuilder::defineSubcircuit(const std::string& name, const QuantumCircuit& circuit) {
+    if (circuit.getNumQubits() > MAX_QUBITS) {
+        throw std::invalid_argument("Subcircuit is too large for a dense unitary");
+    }
+    subcircuits.erase(name);
+    subcircuits.emplace(name, circuit);
+}
+
+void UnitaryBuilder::clearCache() {
+    cache.clear();
+    storedBytes = 0;
+    cacheHits = 0;
+    cacheMisses = 0;
+}
+
+/*
+
+    FUNCTION: unitary(circuit, parameters) / subcircuitUnitary(name, parameters):
+                look the bound gate list up by hash, the stored list is compared on a hit so a collision
+                can never return the unitary of a different circuit. a miss makes room in the budget before
+                the new unitary is stored, one larger than the whole budget is kept alone until the next miss
+
+*/
+const Eigen::MatrixXcd& UnitaryBuilder::unitary(const QuantumCircuit& circuit, const std::vector<double>& parameters) {
+    std::vector<GateOperation> operations = bindOperations(circuit, parameters);
+    std::uint64_t hash = structuralHash(circuit.getNumQubits(), operations);
+
+    auto sameOperation = [](const GateOperation& a, const GateOperation& b) {
+        return a.type == b.type && a.target == b.target && a.control == b.control && a.angle == b.angle;
+    };
+
+    auto found = cache.find(hash);
+    if (found != cache.end()) {
+        for (const std::shared_ptr<CachedUnitary>& entry : found->second) {
+            if (entry->numQubits == circuit.getNumQubits() && entry->operations.size() == operations.size()
+                && std::equal(operations.begin(), operations.end(), entry->operations.begin(), sameOperation)) {
+                ++cacheHits;
+                entry->lastUse = ++useCounter;
+                return entry->unitary;
+            }
+        }
+    }
+
+    ++cacheMisses;
+    std::shared_ptr<CachedUnitary> entry = std::make_shared<CachedUnitary>();
+    entry->numQubits = circuit.getNumQubits();
+    entry->unitary = buildUnitary(circuit, parameters);
+    entry->operations = std::move(operations);
+    entry->lastUse = ++useCounter;
+
+    const size_t bytes = static_cast<size_t>(entry->unitary.size()) * sizeof(std::complex<double>);
+    while (!cache.empty() && storedBytes + bytes > memoryBudget) {
+        evictLeastRecentlyUsed();
+    }
+    cache[hash].push_back(entry);
+    storedBytes += bytes;
+    return entry->unitary;
+}
+
+//the scan is linear in the number of unitaries, a budget only holds a few hundred of the smallest ones
+void UnitaryBuilder::evictLeastRecentlyUsed() {
+    auto oldestBucket = cache.end();
+    size_t oldestIndex = 0;
+    for (auto bucket = cache.begin(); bucket != cache.end(); ++bucket) {
+        for (size_t index = 0; index < bucket->second.size(); ++index) {
+            if (oldestBucket == cache.end() || bucket->second[index]->lastUse < oldestBucket->second[oldestIndex]->lastUse) {
+                oldestBucket = bucket;
+                oldestIndex = index;
+            }
+        }
+    }
+
+    std::vector<std::shared_ptr<CachedUnitary>>& entries = oldestBucket->second;
+    storedBytes -= static_cast<size_t>(entries[oldestIndex]->unitary.size()) * sizeof(std::complex<double>);
+    entries.erase(entries.begin() + static_cast<std::ptrdiff_t>(oldestIndex));
+    if (entries.empty()) {
+        cache.erase(oldestBucket);
+    }
+}
+
+const Eigen::MatrixXcd& UnitaryBuilder::subcircuitUnitary(const std::string& name, const std::vector<double>& parameters) {
+    return unitary(getSubcircuit(name), parameters);
+}
+
+/*
+
+    FUNCTION: applySubcircuit(quantumRegister, name, qubits, parameters):
+                the memoized unitary is applied as one fused dense gate instead of replaying its gates
+
+*/
+void UnitaryBuilder::applySubcircuit(QuantumRegister& quantumRegister, const std::string& name, const std::vector<int>& qubits,
+    const std::vector<double>& parameters) {
+
+    const QuantumCircuit& circuit = getSubcircuit(name);
+    if (static_cast<int>(qubits.size()) != circuit.getNumQubits()) {
+        throw std::invalid_argument("Subcircuit needs one register qubit for each of its qubits");
+    }
+    quantumRegister.applyMultiQubitGate(qubits, unitary(circuit, parameters));
+}
+
+/*
+
+    FUNCTION: buildUnitary(circuit, parameters):
+                the identity is cut in blocks of COLUMN_BLOCK columns, every block is a RegisterBatch run through
+                the compiled circuit on its own worker, the GEMM tiles of a block stay in cache. when there are
+                fewer blocks than workers the batches parallelize inside their gates instead
+
+*/
+Eigen::MatrixXcd UnitaryBuilder::buildUnitary(const QuantumCircuit& circuit, const std::vector<double>& parameters) {
+    const int qubits = circuit.getNumQubits();
+    if (qubits > MAX_QUBITS) {
+        throw std::invalid_argument("Circuit is too large for a dense unitary");
+    }
+    if (static_cast<int>(parameters.size()) < circuit.getNumParameters()) {
+        throw std::invalid_argument("Not enough parameters bound for the circuit");
+    }
+
+    const CompiledCircuit compiled(circuit);
+    const Eigen::Index dimension = static_cast<Eigen::Index>(1) << qubits;
+    const Eigen::Index blockColumns = std::min(COLUMN_BLOCK, dimension);
+    const size_t blocks = static_cast<size_t>(dimension / blockColumns);
+    Eigen::MatrixXcd result(dimension, dimension);
+
+    auto runBlocks = [&](size_t first, size_t last) {
+        for (size_t block = first; block < last; ++block) {
+            const Eigen::Index firstColumn = static_cast<Eigen::Index>(block) * blockColumns;
+            RegisterBatch batch(qubits, blockColumns);
+            RegisterBatch::BatchMatrix& amplitudes = batch.getAmplitudes();
+            amplitudes.setZero();
+            for (Eigen::Index column = 0; column < blockColumns; ++column) {
+                amplitudes(firstColumn + column, column) = 1.0;
+            }
+
+            compiled.executeBatch(batch, parameters);
+            result.middleCols(firstColumn, blockColumns) = amplitudes;
+        }
+    };
+
+    if (blocks >= parallelWorkerCount()) {
+        parallelFor(0, blocks, 1, runBlocks);
+    }
+    else {
+        runBlocks(0, blocks);
+    }
+    return result;
+}
+
+/*
+
+    FUNCTION: bindOperations(circuit, parameters) / structuralHash(qubitCount, operations):
+                the bound angle replaces the parameter, gates without an angle hash it as zero
+
+*/
+std::vector<GateOperation> UnitaryBuilder::bindOperations(const QuantumCircuit& circuit, const std::vector<double>& parameters) {
+    std::vector<GateOperation> operations;
+    operations.reserve(circuit.getGateCount());
+    for (const GateOperation& operation : circuit.getOperations()) {
+        GateOperation bound = operation;
+        bound.angle = QuantumCircuit::isParametric(operation.type) ? QuantumCircuit::resolveAngle(operation, parameters) : 0.0;
+        if (bound.angle == 0.0) {
+            //-0.0 and 0.0 are the same gate
+            bound.angle = 0.0;
+        }
+        bound.parameterIndex = -1;
+        operations.push_back(bound);
+    }
+    return operations;
+}
+
+std::uint64_t UnitaryBuilder::structuralHash(int qubitCount, const std::vector<GateOperation>& operations) {
+    std::uint64_t hash = FNV_OFFSET_BASIS;
+    hashWord(hash, static_cast<std::uint64_t>(qubitCount));
+    for (const GateOperation& operation : operations) {
+        hashWord(hash, static_cast<std::uint64_t>(operation.type));
+        hashWord(hash, static_cast<std::uint64_t>(static_cast<std::int64_t>(operation.target)));
+        hashWord(hash, static_cast<std::uint64_t>(static_cast<std::int64_t>(operation.control)));
+        hashWord(hash, doubleBits(operation.angle));
+    }
+    return hash;
+}
@@ -0,0 +1,88 @@
+#ifndef UNITARY_BUILDER_H
+#define UNITARY_BUILDER_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <Eigen/Dense>
+#include "QuantumCircuit.h"
+#include "QuantumRegister.h"
+
+//a memoized unitary together with the gates it was built from, used to resolve hash collisions
+struct CachedUnitary {
+    int numQubits;
+    std::vector<GateOperation> operations;     // angles already bound, parameterIndex always -1
+    Eigen::MatrixXcd unitary;
+    std::uint64_t lastUse;
+};
+
+
+/*
+
+    UnitaryBuilder class
+
+    full 2^N x 2^N unitary of a circuit, column j is the circuit applied to the basis state |j>.
+    the columns are split in blocks that are run as independent batches on different workers.
+    unitaries are memoized by the structural hash of their bound gate list, so a named subcircuit
+    (oracle, diffusion operator, user macro) is built once and then applied as a single dense gate.
+    the memo holds at most a memory budget of matrices, the least recently used ones are dropped first
+    (a sweep over the angles of a subcircuit would otherwise keep every unitary it ever built).
+    the cache is not synchronized, a builder must be used by one thread at a time
+
+*/
+class UnitaryBuilder {
+private:
+    std::map<std::string, QuantumCircuit> subcircuits;
+    std::unordered_map<std::uint64_t, std::vector<std::shared_ptr<CachedUnitary>>> cache;
+    size_t memoryBudget;
+    size_t storedBytes;
+    std::uint64_t useCounter;
+    size_t cacheHits;
+    size_t cacheMisses;
+
+    // Private helper methods
+    void evictLeastRecentlyUsed();
+
+public:
+    // 2^12 x 2^12 complex doubles are already 256 MB
+    static constexpr int MAX_QUBITS = 12;
+    // columns simulated together by one worker
+    static constexpr Eigen::Index COLUMN_BLOCK = 64;
+    // default budget of the memo, two unitaries of MAX_QUBITS
+    static constexpr size_t DEFAULT_MEMORY_BUDGET = static_cast<size_t>(512) << 20;
+
+    // Constructor
+    UnitaryBuilder(size_t memoryBudgetBytes = DEFAULT_MEMORY_BUDGET);
+
+    // Getters
+    size_t getCacheHits() const { return cacheHits; }
+    size_t getCacheMisses() const { return cacheMisses; }
+    size_t getCacheSize() const;
+    size_t getStoredBytes() const { return storedBytes; }
+    bool hasSubcircuit(const std::string& name) const { return subcircuits.count(name) != 0; }
+    const QuantumCircuit& getSubcircuit(const std::string& name) const;
+
+    // Named subcircuits, redefining a name replaces its circuit
+    void defineSubcircuit(const std::string& name, const QuantumCircuit& circuit);
+    void clearCache();
+
+    // Memoized unitaries, the reference stays valid until the next call (a miss can evict) or until the cache is cleared
+    const Eigen::MatrixXcd& unitary(const QuantumCircuit& circuit, const std::vector<double>& parameters = {});
+    const Eigen::MatrixXcd& subcircuitUnitary(const std::string& name, const std::vector<double>& parameters = {});
+
+    //subcircuit qubit j is mapped on qubits[j] of the register
+    void applySubcircuit(QuantumRegister& quantumRegister, const std::string& name, const std::vector<int>& qubits,
+        const std::vector<double>& parameters = {});
+
+    // Unitary of a circuit without the cache
+    static Eigen::MatrixXcd buildUnitary(const QuantumCircuit& circuit, const std::vector<double>& parameters = {});
+
+    //gate list with the parameters bound, two circuits with the same bound list have the same unitary
+    static std::vector<GateOperation> bindOperations(const QuantumCircuit& circuit, const std::vector<double>& parameters);
+    static std::uint64_t structuralHash(int qubitCount, const std::vector<GateOperation>& operations);
+};
+
+#endif // UNITARY_BUILDER_H
@@ -0,0 +1,652 @@
+#define _USE_MATH_DEFINES
+#include "UnitarySynthesis.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <Eigen/Dense>
+#include "CliffordGroup.h"
+#include "HashUtils.h"
+#include "RegisterBatch.h"
+
+namespace {
+
+    //angle in (-pi, pi], RZ(a + 2 pi) = -RZ(a) so every turn removed moves pi into the global phase
+    double wrapAngle(double angle, double& phase) {
+        while (angle > M_PI) {
+            angle -= 2.0 * M_PI;
+            phase += M_PI;
+        }
+        while (angle <= -M_PI) {
+            angle += 2.0 * M_PI;
+            phase += M_PI;
+        }
+        return angle;
+    }
+
+    Eigen::Matrix4cd localProduct(const Eigen::Matrix2cd& high, const Eigen::Matrix2cd& low) {
+        return RegisterBatch::kroneckerProduct({ low, high });
+    }
+
+    GateOperation singleGate(GateType type, int qubit, double angle) {
+        return { type, qubit, -1, angle, -1 };
+    }
+
+}
+
+/*
+
+    CONSTRUCTOR
+
+*/
+UnitarySynthesis::UnitarySynthesis(size_t maxCacheEntries)
+    : maxEntries(std::max<size_t>(2, maxCacheEntries)),
+    entryCount(0),
+    useCounter(0),
+    cacheHits(0),
+    cacheMisses(0) {
+}
+
+void UnitarySynthesis::clearCache() {
+    cache.clear();
+    entryCount = 0;
+    cacheHits = 0;
+    cacheMisses = 0;
+}
+
+/*
+
+    FUNCTION: synthesize(gate) / lookup(gate):
+                the entries are read on the CACHE_RESOLUTION grid, the quantized values are the key of the
+                bucket and are compared in full so two matrices never share an entry because of the hash alone.
+                a miss on a full cache first drops the older half of the entries
+
+*/
+const GateSynthesis& UnitarySynthesis::synthesize(const Eigen::Matrix2cd& gate) {
+    return lookup(gate);
+}
+
+const GateSynthesis& UnitarySynthesis::synthesize(const Eigen::Matrix4cd& gate) {
+    return lookup(gate);
+}
+
+const GateSynthesis& UnitarySynthesis::lookup(const Eigen::MatrixXcd& gate) {
+    std::vector<std::int64_t> key;
+    key.reserve(static_cast<size_t>(2 * gate.size()));
+    const std::complex<double>* data = gate.data();
+    for (Eigen::Index k = 0; k < gate.size(); ++k) {
+        key.push_back(static_cast<std::int64_t>(std::llround(data[k].real() / CACHE_RESOLUTION)));
+        key.push_back(static_cast<std::int64_t>(std::llround(data[k].imag() / CACHE_RESOLUTION)));
+    }
+
+    const std::uint64_t hash = matrixHash(key);
+    auto found = cache.find(hash);
+    if (found != cache.end()) {
+        for (const std::shared_ptr<CachedSynthesis>& entry : found->second) {
+            if (entry->key == key) {
+                ++cacheHits;
+                entry->lastUse = ++useCounter;
+                return entry->synthesis;
+            }
+        }
+    }
+
+    ++cacheMisses;
+    if (entryCount >= maxEntries) {
+        evictOlderHalf();
+    }
+    auto entry = std::make_shared<CachedSynthesis>();
+    entry->key = std::move(key);
+    entry->synthesis = gate.rows() == 2 ? decompose(Eigen::Matrix2cd(gate)) : decompose(Eigen::Matrix4cd(gate));
+    entry->lastUse = ++useCounter;
+    cache[hash].push_back(entry);
+    ++entryCount;
+    return entry->synthesis;
+}
+
+//one pass finds the median use and drops everything older, so the scan is paid once every maxEntries / 2 misses
+void UnitarySynthesis::evictOlderHalf() {
+    std::vector<std::uint64_t> uses;
+    uses.reserve(entryCount);
+    for (const auto& bucket : cache) {
+        for (const std::shared_ptr<CachedSynthesis>& entry : bucket.second) {
+            uses.push_back(entry->lastUse);
+        }
+    }
+    auto median = uses.begin() + static_cast<std::ptrdiff_t>(uses.size() / 2);
+    std::nth_element(uses.begin(), median, uses.end());
+    const std::uint64_t threshold = *median;
+
+    for (auto bucket = cache.begin(); bucket != cache.end();) {
+        std::vector<std::shared_ptr<CachedSynthesis>>& entries = bucket->second;
+        entries.erase(std::remove_if(entries.begin(), entries.end(),
+            [threshold](const std::shared_ptr<CachedSynthesis>& entry) { return entry->lastUse < threshold; }), entries.end());
+        bucket = entries.empty() ? cache.erase(bucket) : std::next(bucket);
+    }
+
+    entryCount = 0;
+    for (const auto& bucket : cache) {
+        entryCount += bucket.second.size();
+    }
+}
+
+std::uint64_t UnitarySynthesis::matrixHash(const std::vector<std::int64_t>& key) {
+    std::uint64_t hash = FNV_OFFSET_BASIS;
+    for (std::int64_t value : key) {
+        hashWord(hash, static_cast<std::uint64_t>(value));
+    }
+    return hash;
+}
+
+/*
+
+    FUNCTION: appendSingleQubitGate(circuit, qubit, gate) / appendTwoQubitGate(circuit, qubitA, qubitB, gate):
+                the cached gates are written on qubits 0 and 1, they are moved on the circuit qubits here
+
+*/
+void UnitarySynthesis::appendSingleQubitGate(QuantumCircuit& circuit, int qubit, const Eigen::Matrix2cd& gate) {
+    for (GateOperation operation : synthesize(gate).operations) {
+        operation.target = qubit;
+        circuit.addOperation(operation);
+    }
+}
+
+void UnitarySynthesis::appendTwoQubitGate(QuantumCircuit& circuit, int qubitA, int qubitB, const Eigen::Matrix4cd& gate) {
+    if (qubitA == qubitB) {
+        throw std::invalid_argument("Two qubit gate needs two different qubits");
+    }
+    const int qubits[2] = { qubitA, qubitB };
+    for (GateOperation operation : synthesize(gate).operations) {
+        operation.target = qubits[operation.target];
+        if (operation.control >= 0) {
+            operation.control = qubits[operation.control];
+        }
+        circuit.addOperation(operation);
+    }
+}
+
+/*
+
+    FUNCTION: resynthesize(circuit):
+                every qubit either holds the product of its pending single qubit gates or belongs to an open two
+                qubit block. a single qubit gate is multiplied into whatever its qubit holds, a two qubit gate on the
+                qubits of one block joins it, otherwise the blocks of its qubits are closed and a new block starts from
+                the pending gates of the two qubits. a closed block or run keeps its own gates unless the synthesis
+                needs fewer CNOTs, or as many CNOTs and fewer gates. parametric gates close what they touch and are
+                copied as they are
+
+*/
+QuantumCircuit UnitarySynthesis::resynthesize(const QuantumCircuit& circuit) {
+    struct FusedBlock {
+        int qubits[2];
+        Eigen::Matrix4cd matrix;
+        std::vector<GateOperation> operations;
+    };
+
+    const int qubitCount = circuit.getNumQubits();
+    const Eigen::Matrix2cd identity = Eigen::Matrix2cd::Identity();
+    QuantumCircuit result(qubitCount);
+    std::vector<Eigen::Matrix2cd> pending(qubitCount, identity);
+    std::vector<std::vector<GateOperation>> pendingOperations(qubitCount);
+    std::vector<FusedBlock> blocks;
+    std::vector<int> blockOf(qubitCount, -1);
+
+    auto isCheaper = [](const std::vector<GateOperation>& synthesized, const std::vector<GateOperation>& original) {
+        int synthesizedCost = cnotCost(synthesized);
+        int originalCost = cnotCost(original);
+        return synthesizedCost < originalCost || (synthesizedCost == originalCost && synthesized.size() < original.size());
+    };
+    auto emit = [&](const std::vector<GateOperation>& operations, const int* qubits) {
+        for (GateOperation operation : operations) {
+            if (qubits != nullptr) {
+                operation.target = qubits[operation.target];
+                if (operation.control >= 0) {
+                    operation.control = qubits[operation.control];
+                }
+            }
+            result.addOperation(operation);
+        }
+    };
+    auto closeRun = [&](int qubit) {
+        if (pendingOperations[qubit].empty()) {
+            return;
+        }
+        const GateSynthesis& synthesis = synthesize(pending[qubit]);
+        if (isCheaper(synthesis.operations, pendingOperations[qubit])) {
+            emit(synthesis.operations, &qubit);
+        }
+        else {
+            emit(pendingOperations[qubit], nullptr);
+        }
+        pending[qubit] = identity;
+        pendingOperations[qubit].clear();
+    };
+    auto closeBlock = [&](int qubit) {
+        if (blockOf[qubit] < 0) {
+            return;
+        }
+        const FusedBlock& block = blocks[blockOf[qubit]];
+        const GateSynthesis& synthesis = synthesize(block.matrix);
+        if (isCheaper(synthesis.operations, block.operations)) {
+            emit(synthesis.operations, block.qubits);
+        }
+        else {
+            emit(block.operations, nullptr);
+        }
+        blockOf[block.qubits[0]] = -1;
+        blockOf[block.qubits[1]] = -1;
+    };
+
+    for (const GateOperation& operation : circuit.getOperations()) {
+        const bool twoQubit = operation.control >= 0;
+        if (operation.parameterIndex >= 0) {
+            for (int qubit : { operation.target, operation.control }) {
+                if (qubit >= 0) {
+                    closeBlock(qubit);
+                    closeRun(qubit);
+                }
+            }
+            result.addOperation(operation);
+            continue;
+        }
+
+        if (!twoQubit) {
+            const int qubit = operation.target;
+            const Eigen::Matrix2cd gate = QuantumCircuit::gateMatrix(operation.type, operation.angle);
+            if (blockOf[qubit] < 0) {
+                pending[qubit] = gate * pending[qubit];
+                pendingOperations[qubit].push_back(operation);
+                continue;
+            }
+            FusedBlock& block = blocks[blockOf[qubit]];
+            block.matrix = (block.qubits[0] == qubit ? localProduct(identity, gate) : localProduct(gate, identity)) * block.matrix;
+            block.operations.push_back(operation);
+            continue;
+        }
+
+        if (blockOf[operation.target] < 0 || blockOf[operation.target] != blockOf[operation.control]) {
+            closeBlock(operation.target);
+            closeBlock(operation.control);
+
+            FusedBlock block;
+            block.qubits[0] = operation.control;
+            block.qubits[1] = operation.target;
+            block.matrix = localProduct(pending[operation.target], pending[operation.control]);
+            block.operations = pendingOperations[operation.control];
+            block.operations.insert(block.operations.end(), pendingOperations[operation.target].begin(), pendingOperations[operation.target].end());
+            for (int qubit : block.qubits) {
+                pending[qubit] = identity;
+                pendingOperations[qubit].clear();
+                blockOf[qubit] = static_cast<int>(blocks.size());
+            }
+            blocks.push_back(block);
+        }
+
+        FusedBlock& block = blocks[blockOf[operation.target]];
+        GateOperation local = operation;
+        local.target = block.qubits[0] == operation.target ? 0 : 1;
+        local.control = 1 - local.target;
+        block.matrix = CliffordGroup::operationMatrix(local, 2) * block.matrix;
+        block.operations.push_back(operation);
+    }
+
+    for (int qubit = 0; qubit < qubitCount; ++qubit) {
+        closeBlock(qubit);
+        closeRun(qubit);
+    }
+    return result;
+}
+
+/*
+
+    FUNCTION: cnotCost(operations):
+                CNOTs of the gate list on hardware whose only two qubit gate is the CNOT
+
+*/
+int UnitarySynthesis::cnotCost(const std::vector<GateOperation>& operations) {
+    int cost = 0;
+    for (const GateOperation& operation : operations) {
+        switch (operation.type) {
+        case GateType::CNOT:
+        case GateType::CZ:
+            cost += 1;
+            break;
+        case GateType::ControlledPhase:
+            cost += 2;
+            break;
+        case GateType::Swap:
+            cost += 3;
+            break;
+        default:
+            break;
+        }
+    }
+    return cost;
+}
+
+/*
+
+    FUNCTION: eulerAngles(gate):
+                V = exp(-i phase) U with phase = arg(det U) / 2 is in SU(2) and its first column is the state
+                V|0> = cos(gamma/2) exp(-i (beta + delta)/2) |0> + sin(gamma/2) exp(i (beta - delta)/2) |1>,
+                so gamma is its polar angle and beta its relative phase on the Bloch sphere as in
+                Qubit::findPolarAngle() and findRelativePhase(). the polar angle is taken with atan2 of both
+                moduli, asin of |b| alone loses half of the digits near the poles. when one of the two
+                entries vanishes only beta + delta or beta - delta is defined and the whole angle goes in one RZ
+
+*/
+EulerAngles UnitarySynthesis::eulerAngles(const Eigen::Matrix2cd& gate) {
+    const std::complex<double> determinant = gate.determinant();
+    if (std::abs(std::abs(determinant) - 1.0) > 1e-8) {
+        throw std::invalid_argument("Euler angles need a unitary matrix");
+    }
+
+    EulerAngles angles{};
+    angles.phase = std::arg(determinant) / 2.0;
+    const Eigen::Matrix2cd special = gate * std::polar(1.0, -angles.phase);
+    const std::complex<double> a = special(0, 0);
+    const std::complex<double> b = special(1, 0);
+
+    angles.gamma = 2.0 * std::atan2(std::abs(b), std::abs(a));
+    if (std::abs(b) < TOLERANCE) {
+        angles.beta = 0.0;
+        angles.delta = -2.0 * std::arg(a);
+    }
+    else if (std::abs(a) < TOLERANCE) {
+        angles.beta = 2.0 * std::arg(b);
+        angles.delta = 0.0;
+    }
+    else {
+        angles.beta = std::arg(b) - std::arg(a);
+        angles.delta = -std::arg(a) - std::arg(b);
+    }
+
+    angles.beta = wrapAngle(angles.beta, angles.phase);
+    angles.delta = wrapAngle(angles.delta, angles.phase);
+    angles.phase = wrapAngle(angles.phase, angles.phase);
+    return angles;
+}
+
+void UnitarySynthesis::appendEuler(std::vector<GateOperation>& operations, const EulerAngles& angles, int qubit) {
+    if (std::abs(angles.delta) > TOLERANCE) {
+        operations.push_back(singleGate(GateType::RotationZ, qubit, angles.delta));
+    }
+    if (std::abs(angles.gamma) > TOLERANCE) {
+        operations.push_back(singleGate(GateType::RotationY, qubit, angles.gamma));
+    }
+    if (std::abs(angles.beta) > TOLERANCE) {
+        operations.push_back(singleGate(GateType::RotationZ, qubit, angles.beta));
+    }
+}
+
+GateSynthesis UnitarySynthesis::decompose(const Eigen::Matrix2cd& gate) {
+    EulerAngles angles = eulerAngles(gate);
+    GateSynthesis synthesis{ angles.phase, Eigen::Vector3d::Zero(), 0, {} };
+    appendEuler(synthesis.operations, angles, 0);
+    return synthesis;
+}
+
+/*
+
+    FUNCTION: magicBasis():
+                columns (|00> + |11>)/sqrt2, i(|00> - |11>)/sqrt2, i(|01> + |10>)/sqrt2, (|01> - |10>)/sqrt2.
+                XX, YY, ZZ have eigenvalues (1, -1, 1), (-1, 1, 1), (1, 1, -1), (-1, -1, -1) on them
+
+*/
+Eigen::Matrix4cd UnitarySynthesis::magicBasis() {
+    const std::complex<double> i(0.0, 1.0);
+    const double factor = 1.0 / std::sqrt(2.0);
+    Eigen::Matrix4cd basis = Eigen::Matrix4cd::Zero();
+    basis(0, 0) = factor;
+    basis(3, 0) = factor;
+    basis(0, 1) = i * factor;
+    basis(3, 1) = -i * factor;
+    basis(1, 2) = i * factor;
+    basis(2, 2) = i * factor;
+    basis(1, 3) = factor;
+    basis(2, 3) = -factor;
+    return basis;
+}
+
+/*
+
+    FUNCTION: decompose(gate) for two qubits:
+                with U in SU(4) and M = B^dagger U B in the magic basis, M^T M is a symmetric unitary whose
+                real and imaginary parts commute, so a real orthogonal P diagonalizes both of them at once
+                (one generic mixture of the two is diagonalized, a degenerate mixture is retried with another weight).
+                M^T M = P D^2 P^T gives M = K D P^T with K = M P D^-1 real orthogonal, the orthogonal factors are
+                local gates in the computational basis and D = exp(i theta) holds the interaction coefficients
+
+                    theta = (a - b + c, -a + b + c, a + b - c, -a - b - c) + g
+
+                the coefficients are then moved in the Weyl chamber by local gates: turns of pi/2 are i PP factors,
+                S x S, RX(pi/2) x RX(pi/2) and H x H swap two of them and Z x I, Y x I, X x I flip two signs
+
+*/
+GateSynthesis UnitarySynthesis::decompose(const Eigen::Matrix4cd& gate) {
+    if ((gate.adjoint() * gate - Eigen::Matrix4cd::Identity()).cwiseAbs().maxCoeff() > 1e-8) {
+        throw std::invalid_argument("KAK decomposition needs a unitary matrix");
+    }
+
+    const Eigen::Matrix4cd magic = magicBasis();
+    const Eigen::Matrix4cd rotated = magic.adjoint() * (gate * std::polar(1.0, -std::arg(gate.determinant()) / 4.0)) * magic;
+    const Eigen::Matrix4cd symmetric = rotated.transpose() * rotated;
+
+    Eigen::Matrix4d orthogonal;
+    bool diagonalized = false;
+    for (double weight : { 0.5, 0.9, 1.7, 2.3, 3.1 }) {
+        Eigen::Matrix4d mixture = std::cos(weight) * symmetric.real() + std::sin(weight) * symmetric.imag();
+        Eigen::SelfAdjointEigenSolver<Eigen::Matrix4d> solver(0.5 * (mixture + mixture.transpose()));
+        orthogonal = solver.eigenvectors();
+        Eigen::Matrix4cd diagonal = orthogonal.transpose().cast<std::complex<double>>() * symmetric * orthogonal;
+        diagonal.diagonal().setZero();
+        if (diagonal.cwiseAbs().maxCoeff() < 1e-9) {
+            diagonalized = true;
+            break;
+        }
+    }
+    if (!diagonalized) {
+        throw std::runtime_error("KAK decomposition did not converge");
+    }
+    if (orthogonal.determinant() < 0.0) {
+        orthogonal.col(0) = -orthogonal.col(0);
+    }
+
+    const Eigen::Vector4cd eigenvalues = (orthogonal.transpose().cast<std::complex<double>>() * symmetric * orthogonal).diagonal();
+    Eigen::Vector4d theta;
+    for (int k = 0; k < 4; ++k) {
+        theta(k) = std::arg(eigenvalues(k)) / 2.0;
+    }
+    //the square roots are chosen with product 1, an odd multiple of pi in the sum is moved on the first one
+    if (std::lround(theta.sum() / M_PI) % 2 != 0) {
+        theta(0) += M_PI;
+    }
+
+    Eigen::Vector4cd inverseRoots;
+    for (int k = 0; k < 4; ++k) {
+        inverseRoots(k) = std::polar(1.0, -theta(k));
+    }
+    const Eigen::Matrix4cd left = rotated * orthogonal * inverseRoots.asDiagonal();
+
+    Eigen::Matrix2cd after[2];
+    Eigen::Matrix2cd before[2];
+    splitLocal(magic * left * magic.adjoint(), after[1], after[0]);
+    splitLocal(magic * orthogonal.transpose() * magic.adjoint(), before[1], before[0]);
+
+    Eigen::Vector3d coefficients((theta(0) - theta(1) + theta(2) - theta(3)) / 4.0,
+        (-theta(0) + theta(1) + theta(2) - theta(3)) / 4.0,
+        (theta(0) + theta(1) - theta(2) - theta(3)) / 4.0);
+
+    const Eigen::Matrix2cd paulis[3] = { QuantumCircuit::gateMatrix(GateType::PauliX), QuantumCircuit::gateMatrix(GateType::PauliY),
+        QuantumCircuit::gateMatrix(GateType::PauliZ) };
+    //conjugation by G x G exchanges two coefficients, G x I with a Pauli G flips the sign of the other two
+    auto exchange = [&](int first, int second) {
+        Eigen::Matrix2cd local;
+        if (first + second == 1) {
+            local = QuantumCircuit::gateMatrix(GateType::S);
+        }
+        else if (first + second == 3) {
+            local = QuantumCircuit::gateMatrix(GateType::RotationX, M_PI / 2.0);
+        }
+        else {
+            local = QuantumCircuit::gateMatrix(GateType::Hadamard);
+        }
+        for (int qubit = 0; qubit < 2; ++qubit) {
+            after[qubit] = after[qubit] * local;
+            before[qubit] = local.adjoint() * before[qubit];
+        }
+        std::swap(coefficients(first), coefficients(second));
+    };
+    auto flip = [&](int kept) {
+        after[0] = after[0] * paulis[kept];
+        before[0] = paulis[kept] * before[0];
+        for (int k = 0; k < 3; ++k) {
+            if (k != kept) {
+                coefficients(k) = -coefficients(k);
+            }
+        }
+    };
+
+    for (int k = 0; k < 3; ++k) {
+        while (coefficients(k) > M_PI / 4.0 + TOLERANCE) {
+            coefficients(k) -= M_PI / 2.0;
+            after[0] = after[0] * paulis[k];
+            after[1] = after[1] * paulis[k];
+        }
+        while (coefficients(k) <= -M_PI / 4.0 + TOLERANCE) {
+            coefficients(k) += M_PI / 2.0;
+            after[0] = after[0] * paulis[k];
+            after[1] = after[1] * paulis[k];
+        }
+    }
+    for (int pass = 0; pass < 2; ++pass) {
+        for (int k = 0; k + 1 < 3 - pass; ++k) {
+            if (std::abs(coefficients(k)) < std::abs(coefficients(k + 1))) {
+                exchange(k, k + 1);
+            }
+        }
+    }
+    if (coefficients(0) < 0.0 && coefficients(1) < 0.0) {
+        flip(2);
+    }
+    else if (coefficients(0) < 0.0) {
+        flip(1);
+    }
+    else if (coefficients(1) < 0.0) {
+        flip(0);
+    }
+
+    GateSynthesis synthesis{ 0.0, coefficients, 3, {} };
+    const double a = coefficients(0);
+    const double b = coefficients(1);
+    const double c = coefficients(2);
+    if (a < TOLERANCE) {
+        synthesis.cnotCount = 0;
+    }
+    else if (b < TOLERANCE && std::abs(c) < TOLERANCE && std::abs(a - M_PI / 4.0) < TOLERANCE) {
+        synthesis.cnotCount = 1;
+    }
+    else if (std::abs(c) < TOLERANCE) {
+        synthesis.cnotCount = 2;
+    }
+
+    std::vector<LocalLayer> layers = interactionLayers(coefficients, synthesis.cnotCount);
+    for (int qubit = 0; qubit < 2; ++qubit) {
+        layers.front()[qubit] = layers.front()[qubit] * before[qubit];
+        layers.back()[qubit] = after[qubit] * layers.back()[qubit];
+    }
+
+    //the phase of the templates is not tracked, it is read back from the emitted gates
+    for (size_t layer = 0; layer < layers.size(); ++layer) {
+        if (layer > 0) {
+            synthesis.operations.push_back({ GateType::CNOT, 1, 0, 0.0, -1 });
+        }
+        for (int qubit = 0; qubit < 2; ++qubit) {
+            appendEuler(synthesis.operations, eulerAngles(layers[layer][qubit]), qubit);
+        }
+    }
+    synthesis.phase = std::arg((operationsMatrix(synthesis.operations).adjoint() * gate).trace());
+    return synthesis;
+}
+
+/*
+
+    FUNCTION: splitLocal(local, high, low):
+                the 2x2 block (r, c) of high x low is high(r, c) low, the largest block fixes low up to a phase
+                and the other entries of high are the projections of the blocks on it
+
+*/
+void UnitarySynthesis::splitLocal(const Eigen::Matrix4cd& local, Eigen::Matrix2cd& high, Eigen::Matrix2cd& low) {
+    Eigen::Index bestRow = 0;
+    Eigen::Index bestColumn = 0;
+    double bestNorm = -1.0;
+    for (Eigen::Index row = 0; row < 2; ++row) {
+        for (Eigen::Index column = 0; column < 2; ++column) {
+            double norm = local.block<2, 2>(2 * row, 2 * column).squaredNorm();
+            if (norm > bestNorm) {
+                bestNorm = norm;
+                bestRow = row;
+                bestColumn = column;
+            }
+        }
+    }
+
+    const Eigen::Matrix2cd block = local.block<2, 2>(2 * bestRow, 2 * bestColumn);
+    low = block / std::sqrt(block.determinant());
+    for (Eigen::Index row = 0; row < 2; ++row) {
+        for (Eigen::Index column = 0; column < 2; ++column) {
+            high(row, column) = (low.adjoint() * local.block<2, 2>(2 * row, 2 * column)).trace() / 2.0;
+        }
+    }
+}
+
+/*
+
+    FUNCTION: interactionLayers(interaction, cnotCount):
+                single qubit gates between the CNOTs (controlled by qubit 0) that give exp(i (a XX + b YY + c ZZ))
+                up to a global phase, layer k runs before CNOT k
+
+                    1 CNOT      a = pi/4:     H . CNOT . (H RZ(-pi/2)) x (H RZ(-pi/2) H)
+                    2 CNOTs     c = 0:        RX(pi/2) . CNOT . RX(-2a) x RY(-2b) . CNOT . RX(-pi/2)
+                    3 CNOTs:                  RZ(-pi/2) on 1 . CNOT(1, 0) . RY(2a - pi/2) x RZ(pi/2 - 2c) . CNOT(0, 1)
+                                              . RY(pi/2 - 2b) on 1 . CNOT(1, 0) . RZ(pi/2) on 0
+
+*/
+std::vector<UnitarySynthesis::LocalLayer> UnitarySynthesis::interactionLayers(const Eigen::Vector3d& interaction, int cnotCount) {
+    const Eigen::Matrix2cd identity = Eigen::Matrix2cd::Identity();
+    const Eigen::Matrix2cd hadamard = QuantumCircuit::gateMatrix(GateType::Hadamard);
+    auto rx = [](double angle) { return QuantumCircuit::gateMatrix(GateType::RotationX, angle); };
+    auto ry = [](double angle) { return QuantumCircuit::gateMatrix(GateType::RotationY, angle); };
+    auto rz = [](double angle) { return QuantumCircuit::gateMatrix(GateType::RotationZ, angle); };
+
+    const double a = interaction(0);
+    const double b = interaction(1);
+    const double c = interaction(2);
+    switch (cnotCount) {
+    case 0:
+        return { { identity, identity } };
+    case 1:
+        return { { hadamard, identity }, { hadamard * rz(-M_PI / 2.0), hadamard * rz(-M_PI / 2.0) * hadamard } };
+    case 2:
+        return { { rx(M_PI / 2.0), identity }, { rx(-2.0 * a), ry(-2.0 * b) }, { rx(-M_PI / 2.0), identity } };
+    default:
+        //the CNOTs controlled by qubit 1 are written as H x H . CNOT . H x H
+        return { { hadamard, hadamard * rz(-M_PI / 2.0) }, { rz(M_PI / 2.0 - 2.0 * c) * hadamard, ry(2.0 * a - M_PI / 2.0) * hadamard },
+            { hadamard, hadamard * ry(M_PI / 2.0 - 2.0 * b) }, { rz(M_PI / 2.0) * hadamard, hadamard } };
+    }
+}
+
+Eigen::Matrix4cd UnitarySynthesis::operationsMatrix(const std::vector<GateOperation>& operations) {
+    Eigen::Matrix4cd product = Eigen::Matrix4cd::Identity();
+    for (const GateOperation& operation : operations) {
+        product = CliffordGroup::operationMatrix(operation, 2) * product;
+    }
+    return product;
+}
@@ -0,0 +1,118 @@
+#ifndef UNITARY_SYNTHESIS_H
+#define UNITARY_SYNTHESIS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <Eigen/Dense>
+#include "QuantumCircuit.h"
+
+//U = exp(i phase) RZ(beta) RY(gamma) RZ(delta), RZ(delta) is applied first
+struct EulerAngles {
+    double phase;
+    double beta;
+    double gamma;
+    double delta;
+};
+
+//native gates of a one or two qubit unitary, U = exp(i phase) times the product of the operations
+struct GateSynthesis {
+    double phase;
+    Eigen::Vector3d interaction;                // (a, b, c) of exp(i (a XX + b YY + c ZZ)), zero for one qubit
+    int cnotCount;
+    std::vector<GateOperation> operations;      // on qubits 0 and 1, every CNOT is controlled by qubit 0
+};
+
+//a synthesized matrix, the quantized entries resolve hash collisions
+struct CachedSynthesis {
+    std::vector<std::int64_t> key;
+    GateSynthesis synthesis;
+    std::uint64_t lastUse;
+};
+
+
+/*
+
+    UnitarySynthesis class
+
+    maps one and two qubit unitaries back to RZ, RY and CNOT. one qubit gates are split in ZYZ Euler angles,
+    two qubit gates go through the KAK decomposition
+
+                    U = exp(i phase) (A1 x A0) exp(i (a XX + b YY + c ZZ)) (B1 x B0),     pi/4 >= a >= b >= |c|
+
+    and the interaction in the middle costs 0, 1, 2 or 3 CNOTs depending on how many coefficients vanish.
+    results are memoized by a hash of the matrix entries on a CACHE_RESOLUTION grid, so the same fused block
+    coming out of an optimization pass again is a single lookup. the cache holds at most a fixed number of
+    entries, once full the least recently used half is dropped in one pass. the cache is not synchronized, a
+    synthesizer must be used by one thread at a time
+
+*/
+class UnitarySynthesis {
+private:
+    //single qubit gates around the CNOTs of a two qubit synthesis, slot 0 is qubit 0
+    typedef std::array<Eigen::Matrix2cd, 2> LocalLayer;
+
+    std::unordered_map<std::uint64_t, std::vector<std::shared_ptr<CachedSynthesis>>> cache;
+    size_t maxEntries;
+    size_t entryCount;
+    std::uint64_t useCounter;
+    size_t cacheHits;
+    size_t cacheMisses;
+
+    // Private helper methods
+    const GateSynthesis& lookup(const Eigen::MatrixXcd& gate);
+    void evictOlderHalf();
+    static void splitLocal(const Eigen::Matrix4cd& local, Eigen::Matrix2cd& high, Eigen::Matrix2cd& low);
+    static std::vector<LocalLayer> interactionLayers(const Eigen::Vector3d& interaction, int cnotCount);
+    static void appendEuler(std::vector<GateOperation>& operations, const EulerAngles& angles, int qubit);
+
+public:
+    // matrices whose entries agree on this grid share the cache entry
+    static constexpr double CACHE_RESOLUTION = 1e-10;
+    // angles and coefficients below this are dropped
+    static constexpr double TOLERANCE = 1e-9;
+    // default size of the cache, an entry is a few hundred bytes
+    static constexpr size_t DEFAULT_CACHE_ENTRIES = 4096;
+
+    // Constructor
+    UnitarySynthesis(size_t maxCacheEntries = DEFAULT_CACHE_ENTRIES);
+
+    // Getters
+    size_t getCacheHits() const { return cacheHits; }
+    size_t getCacheMisses() const { return cacheMisses; }
+    size_t getCacheSize() const { return entryCount; }
+    void clearCache();
+
+    // Memoized synthesis, the reference stays valid until the next call (a miss can evict) or until the cache is cleared
+    const GateSynthesis& synthesize(const Eigen::Matrix2cd& gate);
+    const GateSynthesis& synthesize(const Eigen::Matrix4cd& gate);
+
+    //gates of the synthesis appended to a circuit, qubitA plays qubit 0 of the 4x4 matrix (the CNOT control)
+    void appendSingleQubitGate(QuantumCircuit& circuit, int qubit, const Eigen::Matrix2cd& gate);
+    void appendTwoQubitGate(QuantumCircuit& circuit, int qubitA, int qubitB, const Eigen::Matrix4cd& gate);
+
+    //constant gates are fused in one and two qubit blocks, a block is replaced by its synthesis when that is cheaper.
+    //global phases are not preserved
+    QuantumCircuit resynthesize(const QuantumCircuit& circuit);
+
+    // Decompositions without the cache
+    static EulerAngles eulerAngles(const Eigen::Matrix2cd& gate);
+    static GateSynthesis decompose(const Eigen::Matrix2cd& gate);
+    static GateSynthesis decompose(const Eigen::Matrix4cd& gate);
+
+    //columns |Phi+>, i|Phi->, i|Psi+>, |Psi->, local gates are real rotations in this basis and XX, YY, ZZ are diagonal
+    static Eigen::Matrix4cd magicBasis();
+
+    //matrix of the operations on qubits 0 and 1 without the global phase of the synthesis
+    static Eigen::Matrix4cd operationsMatrix(const std::vector<GateOperation>& operations);
+
+    //CNOTs of a gate list when the CNOT is the only native two qubit gate (CZ 1, controlled phase 2, swap 3)
+    static int cnotCost(const std::vector<GateOperation>& operations);
+
+    static std::uint64_t matrixHash(const std::vector<std::int64_t>& key);
+};
+
+#endif // UNITARY_SYNTHESIS_H
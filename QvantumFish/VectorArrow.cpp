@@ -37,6 +37,9 @@ void main(){
 }
 )";
 
+unsigned int VectorArrow::sharedProgram = 0;
+int VectorArrow::sharedProgramUsers = 0;
+
 unsigned int VectorArrow::compileShader(unsigned int type, const char* source) {
     unsigned int shader = glCreateShader(type);
     glShaderSource(shader, 1, &source, NULL);
@@ -106,24 +109,43 @@ std::vector<float> VectorArrow::generateConeVertices(float height, float baseRad
     return vertices;
 }
 
+// The program has no per arrow state (color and matrices are uniforms set in render), so a register of
+// arrows shares one instead of linking a copy per qubit
 void VectorArrow::compileShaders() {
+    if (sharedProgramUsers++ > 0) {
+        shaderProgram = sharedProgram;
+        return;
+    }
+
     unsigned int vertex_shader = compileShader(GL_VERTEX_SHADER, vector_vertex_shader_source);
     unsigned int fragment_shader = compileShader(GL_FRAGMENT_SHADER, vector_fragment_shader_source);
 
-    shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertex_shader);
-    glAttachShader(shaderProgram, fragment_shader);
-    glLinkProgram(shaderProgram);
+    sharedProgram = glCreateProgram();
+    glAttachShader(sharedProgram, vertex_shader);
+    glAttachShader(sharedProgram, fragment_shader);
+    glLinkProgram(sharedProgram);
 
     int success;
     char log[512];
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
+    glGetProgramiv(sharedProgram, GL_LINK_STATUS, &success);
     if (!success) {
-        glGetProgramInfoLog(shaderProgram, 512, NULL, log);
+        glGetProgramInfoLog(sharedProgram, 512, NULL, log);
         std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << log << std::endl;
     }
     glDeleteShader(vertex_shader);
     glDeleteShader(fragment_shader);
+    shaderProgram = sharedProgram;
+}
+
+void VectorArrow::releaseShaders() {
+    if (shaderProgram == 0) {
+        return;
+    }
+    shaderProgram = 0;
+    if (--sharedProgramUsers == 0) {
+        glDeleteProgram(sharedProgram);
+        sharedProgram = 0;
+    }
 }
 
 void VectorArrow::createLineGeometry() {
@@ -136,7 +158,8 @@ void VectorArrow::createLineGeometry() {
     glGenBuffers(1, &lineVBO);
     glBindVertexArray(lineVAO);
     glBindBuffer(GL_ARRAY_BUFFER, lineVBO);
-    glBufferData(GL_ARRAY_BUFFER, lineVerts.size() * sizeof(float), lineVerts.data(), GL_STATIC_DRAW);
+    // The line follows the state, setPosition rewrites it in place
+    glBufferData(GL_ARRAY_BUFFER, lineVerts.size() * sizeof(float), lineVerts.data(), GL_DYNAMIC_DRAW);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
 }
@@ -156,7 +179,7 @@ void VectorArrow::createConeGeometry() {
 VectorArrow::VectorArrow(const glm::vec3& vecPosition, float vectorRadius,
     float arrowHeight, float arrowBaseRadius, int lineSegmentsCount,
     int coneSlicesCount)
-    : position(vecPosition), radius(vectorRadius), coneHeight(arrowHeight),
+    : shaderProgram(0), position(vecPosition), radius(vectorRadius), coneHeight(arrowHeight),
     coneBaseRadius(arrowBaseRadius), lineSegments(lineSegmentsCount),
     coneSlices(coneSlicesCount), color(1.0f, 0.2f, 0.2f) {
 
@@ -170,11 +193,16 @@ VectorArrow::~VectorArrow() {
 }
 
 void VectorArrow::cleanup() {
+    cleanupGeometry();
+    releaseShaders();
+}
+
+void VectorArrow::cleanupGeometry() {
     glDeleteVertexArrays(1, &lineVAO);
     glDeleteBuffers(1, &lineVBO);
     glDeleteVertexArrays(1, &coneVAO);
     glDeleteBuffers(1, &coneVBO);
-    glDeleteProgram(shaderProgram);
+    lineVAO = lineVBO = coneVAO = coneVBO = 0;
 }
 
 void VectorArrow::rebuild(const glm::vec3& newPosition) {
@@ -244,9 +272,11 @@ void VectorArrow::setColor(const glm::vec3& newColor) {
 
 void VectorArrow::setPosition(const glm::vec3& newPosition) {
     position = newPosition;
-    cleanup();
-    createLineGeometry();
-    createConeGeometry();
+    // Only the line depends on the position (the cone is placed by its model matrix), same vertex count so
+    // the buffer is overwritten instead of reallocated
+    std::vector<float> lineVerts = generateLineVertices(glm::vec3(0.0f), position, lineSegments);
+    glBindBuffer(GL_ARRAY_BUFFER, lineVBO);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, lineVerts.size() * sizeof(float), lineVerts.data());
 }
 
 glm::vec3 VectorArrow::getColor() const {
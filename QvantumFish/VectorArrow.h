@@ -11,6 +11,10 @@ private:
     unsigned int coneVAO, coneVBO;
     unsigned int shaderProgram;
 
+    // every arrow draws with the same program, compiled by the first one and deleted with the last one
+    static unsigned int sharedProgram;
+    static int sharedProgramUsers;
+
     float radius;
     glm::vec3 color;
     glm::vec3 position;
@@ -25,8 +29,10 @@ private:
     std::vector<float> generateLineVertices(const glm::vec3& start, const glm::vec3& end, int segments);
     std::vector<float> generateConeVertices(float height, float baseRadius, int slices);
     void compileShaders();
+    void releaseShaders();
     void createLineGeometry();
     void createConeGeometry();
+    void cleanupGeometry();
 
 public:
     VectorArrow(const glm::vec3& vecPosition = glm::vec3(0.0f, 0.0f, 1.0f),